@@ -0,0 +1,253 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// AsyncSinkWriter.cpp
+
+
+#include "AsyncSinkWriter.hpp"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+std::atomic<uint64_t> AsyncSinkWriter::_lastId(0);
+
+AsyncSinkWriter::Ring::Ring(size_t capacity)
+: _head(0)
+, _tail(0)
+{
+	// Емкость округляется вверх до степени двойки
+	size_t size = 1u<<12;
+	while (size < capacity)
+	{
+		size <<= 1;
+	}
+	_data.resize(size);
+	_mask = size - 1;
+}
+
+void AsyncSinkWriter::Ring::copyIn(size_t position, const char* data, size_t size)
+{
+	auto offset = position & _mask;
+	auto first = std::min(size, _data.size() - offset);
+	memcpy(_data.data() + offset, data, first);
+	memcpy(_data.data(), data + first, size - first);
+}
+
+bool AsyncSinkWriter::Ring::tryPush(const char* part1, size_t size1, const char* part2, size_t size2, bool eol)
+{
+	auto head = _head.load(std::memory_order_relaxed);
+	auto tail = _tail.load(std::memory_order_acquire);
+
+	auto size = size1 + size2 + (eol ? 1 : 0);
+
+	if (_data.size() - (head - tail) < size)
+	{
+		return false;
+	}
+
+	copyIn(head, part1, size1);
+	copyIn(head + size1, part2, size2);
+	if (eol)
+	{
+		_data[(head + size1 + size2) & _mask] = '\n';
+	}
+
+	// Публикуем запись целиком
+	_head.store(head + size, std::memory_order_release);
+	return true;
+}
+
+void AsyncSinkWriter::Ring::drainTo(std::string& out)
+{
+	auto tail = _tail.load(std::memory_order_relaxed);
+	auto head = _head.load(std::memory_order_acquire);
+
+	if (head == tail)
+	{
+		return;
+	}
+
+	auto size = head - tail;
+	auto offset = tail & _mask;
+	auto first = std::min(size, _data.size() - offset);
+	out.append(_data.data() + offset, first);
+	out.append(_data.data(), size - first);
+
+	_tail.store(head, std::memory_order_release);
+}
+
+AsyncSinkWriter::AsyncSinkWriter(Output output, DropNotice dropNotice, std::chrono::milliseconds flushLatency, Overflow overflow, size_t ringCapacity)
+: _id(++_lastId)
+, _output(std::move(output))
+, _dropNotice(std::move(dropNotice))
+, _flushLatency(flushLatency)
+, _overflow(overflow)
+, _ringCapacity(ringCapacity)
+, _urgent(false)
+, _stop(false)
+, _cycles(0)
+, _dropped(0)
+{
+	_thread = std::thread([this]{ run(); });
+}
+
+AsyncSinkWriter::~AsyncSinkWriter()
+{
+	{
+		std::lock_guard<std::mutex> lockGuard(_mutex);
+		_stop = true;
+	}
+	_wakeup.notify_all();
+
+	if (_thread.joinable())
+	{
+		_thread.join();
+	}
+}
+
+AsyncSinkWriter::Ring& AsyncSinkWriter::ring()
+{
+	thread_local std::unordered_map<uint64_t, std::shared_ptr<Ring>> rings;
+
+	auto& ring = rings[_id];
+	if (!ring)
+	{
+		ring = std::make_shared<Ring>(_ringCapacity);
+
+		std::lock_guard<std::mutex> lockGuard(_ringsMutex);
+		_rings.emplace_back(ring);
+	}
+	return *ring;
+}
+
+void AsyncSinkWriter::wakeup()
+{
+	if (!_urgent.exchange(true, std::memory_order_acq_rel))
+	{
+		_wakeup.notify_one();
+	}
+}
+
+void AsyncSinkWriter::push(const char* header, size_t headerSize, const std::string& message)
+{
+	enqueue(header, headerSize, message.data(), message.size(), true);
+}
+
+bool AsyncSinkWriter::pushRaw(const std::string& data)
+{
+	return enqueue(data.data(), data.size(), nullptr, 0, false);
+}
+
+bool AsyncSinkWriter::enqueue(const char* part1, size_t size1, const char* part2, size_t size2, bool eol)
+{
+	auto& ring = this->ring();
+
+	// Запись не помещается даже в пустой буфер
+	if (size1 + size2 + 1 > ring.capacity())
+	{
+		_dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	while (!ring.tryPush(part1, size1, part2, size2, eol))
+	{
+		if (_overflow == Overflow::DROP)
+		{
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+			wakeup();
+			return false;
+		}
+
+		wakeup();
+		std::this_thread::yield();
+	}
+
+	// Буфер заполнен больше чем наполовину - не ждем окончания интервала
+	if (ring.used() > ring.capacity() / 2)
+	{
+		wakeup();
+	}
+	return true;
+}
+
+void AsyncSinkWriter::drain(std::string& batch)
+{
+	{
+		std::lock_guard<std::mutex> lockGuard(_ringsMutex);
+		for (auto& ring : _rings)
+		{
+			ring->drainTo(batch);
+		}
+	}
+
+	auto dropped = _dropped.exchange(0, std::memory_order_relaxed);
+	if (dropped > 0 && _dropNotice)
+	{
+		batch.append(_dropNotice(dropped));
+	}
+
+	if (!batch.empty())
+	{
+		_output(batch.data(), batch.size());
+		batch.clear();
+	}
+}
+
+void AsyncSinkWriter::run()
+{
+	std::string batch;
+
+	std::unique_lock<std::mutex> lock(_mutex);
+	while (!_stop)
+	{
+		_wakeup.wait_for(lock, _flushLatency, [this]{ return _stop || _urgent.load(std::memory_order_acquire); });
+		_urgent.store(false, std::memory_order_release);
+
+		lock.unlock();
+		drain(batch);
+		lock.lock();
+
+		++_cycles;
+		_drained.notify_all();
+	}
+	lock.unlock();
+
+	// Финальный сброс всего, что успели положить
+	drain(batch);
+
+	lock.lock();
+	++_cycles;
+	_drained.notify_all();
+}
+
+void AsyncSinkWriter::sync()
+{
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (_stop)
+	{
+		return;
+	}
+
+	// Нужен полный цикл, начавшийся после вызова
+	auto target = _cycles + 2;
+
+	_urgent.store(true, std::memory_order_release);
+	_wakeup.notify_one();
+
+	_drained.wait(lock, [this, target]{ return _stop || _cycles >= target; });
+}
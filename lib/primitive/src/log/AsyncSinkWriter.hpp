@@ -0,0 +1,137 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// AsyncSinkWriter.hpp
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// Асинхронная запись в синк.
+/// Производители кладут готовые записи в собственный (для каждого потока) кольцевой
+/// буфер без блокировок; отдельный поток периодически (или при заполнении) выбирает
+/// данные из всех буферов и отдает их одним большим блоком на вывод.
+class AsyncSinkWriter final
+{
+public:
+	/// Поведение при переполнении кольцевого буфера
+	enum class Overflow
+	{
+		DROP,   // Отбросить запись (с подсчетом отброшенных)
+		BLOCK   // Ждать освобождения места
+	};
+
+	using Output = std::function<void(const char* data, size_t size)>;
+
+	/// Формирование записи о количестве отброшенных записей
+	using DropNotice = std::function<std::string(uint64_t dropped)>;
+
+private:
+	/// Кольцевой буфер одного производителя (single producer, single consumer)
+	class Ring final
+	{
+	private:
+		std::vector<char> _data;
+		size_t _mask;
+		std::atomic<size_t> _head; // Позиция записи (меняет только производитель)
+		std::atomic<size_t> _tail; // Позиция чтения (меняет только поток вывода)
+
+		void copyIn(size_t position, const char* data, size_t size);
+
+	public:
+		explicit Ring(size_t capacity);
+
+		size_t capacity() const
+		{
+			return _data.size();
+		}
+
+		size_t used() const
+		{
+			return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+		}
+
+		/// Добавить запись (две части и, если нужно, перевод строки) целиком, либо ничего, если нет места
+		bool tryPush(const char* part1, size_t size1, const char* part2, size_t size2, bool eol);
+
+		/// Забрать все опубликованные данные
+		void drainTo(std::string& out);
+	};
+
+	static std::atomic<uint64_t> _lastId;
+	const uint64_t _id;
+
+	const Output _output;
+	const DropNotice _dropNotice;
+	const std::chrono::milliseconds _flushLatency;
+	const Overflow _overflow;
+	const size_t _ringCapacity;
+
+	std::mutex _ringsMutex;
+	std::vector<std::shared_ptr<Ring>> _rings;
+
+	std::mutex _mutex;
+	std::condition_variable _wakeup;
+	std::condition_variable _drained;
+	std::atomic<bool> _urgent;
+	bool _stop;
+	uint64_t _cycles;
+
+	std::atomic<uint64_t> _dropped;
+
+	std::thread _thread;
+
+	Ring& ring();
+	void wakeup();
+	bool enqueue(const char* part1, size_t size1, const char* part2, size_t size2, bool eol);
+	void drain(std::string& batch);
+	void run();
+
+public:
+	AsyncSinkWriter(const AsyncSinkWriter&) = delete; // Copy-constructor
+	AsyncSinkWriter& operator=(const AsyncSinkWriter&) = delete; // Copy-assignment
+	AsyncSinkWriter(AsyncSinkWriter&&) noexcept = delete; // Move-constructor
+	AsyncSinkWriter& operator=(AsyncSinkWriter&&) noexcept = delete; // Move-assignment
+
+	AsyncSinkWriter(Output output, DropNotice dropNotice, std::chrono::milliseconds flushLatency, Overflow overflow, size_t ringCapacity);
+	~AsyncSinkWriter();
+
+	/// Поставить запись (заголовок и сообщение) в очередь вывода
+	void push(const char* header, size_t headerSize, const std::string& message);
+
+	/// Поставить в очередь вывода готовые данные как есть (без перевода строки).
+	/// Возвращает false, если данные отброшены из-за переполнения
+	bool pushRaw(const std::string& data);
+
+	/// Дождаться вывода всех записей, поставленных до вызова
+	void sync();
+
+	uint64_t dropped() const
+	{
+		return _dropped.load(std::memory_order_relaxed);
+	}
+};
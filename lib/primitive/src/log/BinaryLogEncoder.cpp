@@ -0,0 +1,377 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// BinaryLogEncoder.cpp
+
+
+#include "BinaryLogEncoder.hpp"
+#include <chrono>
+#include <cstring>
+#include <unistd.h>
+
+std::mutex BinaryLogEncoder::_registryMutex;
+std::unordered_map<std::string, BinaryLogEncoder::FormatInfo*> BinaryLogEncoder::_formats;
+std::deque<BinaryLogEncoder::FormatInfo> BinaryLogEncoder::_formatStorage;
+std::unordered_map<std::string, uint32_t> BinaryLogEncoder::_strings;
+uint32_t BinaryLogEncoder::_lastId = 0;
+std::atomic<uint64_t> BinaryLogEncoder::_lastEncoderId(0);
+
+namespace
+{
+
+template<typename T>
+inline void put(std::string& out, T value)
+{
+	out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+inline void putString(std::string& out, const char* data, size_t size)
+{
+	put<uint32_t>(out, static_cast<uint32_t>(size));
+	out.append(data, size);
+}
+
+}
+
+constexpr size_t BinaryLogEncoder::MAX_FORMATS;
+
+BinaryLogEncoder::BinaryLogEncoder()
+: _encoderId(++_lastEncoderId)
+, _epoch(0)
+{
+	plainFormat();
+}
+
+const BinaryLogEncoder::FormatInfo* BinaryLogEncoder::formatInfo(const char* format)
+{
+	// Быстрый путь без блокировок: кеш потока. По тому же адресу может оказаться
+	// другая строка (освобожденный и повторно занятый буфер), поэтому сверяем содержимое
+	thread_local std::unordered_map<const char*, const FormatInfo*> cache;
+
+	auto i = cache.find(format);
+	if (i != cache.end() && i->second->text == format)
+	{
+		return i->second;
+	}
+
+	const FormatInfo* info = nullptr;
+	{
+		std::lock_guard<std::mutex> lockGuard(_registryMutex);
+
+		auto j = _formats.find(format);
+		if (j == _formats.end())
+		{
+			if (_formatStorage.size() >= MAX_FORMATS)
+			{
+				return nullptr;
+			}
+
+			_formatStorage.emplace_back();
+			auto& newInfo = _formatStorage.back();
+			newInfo.id = ++_lastId;
+			newInfo.text = format;
+			newInfo.supported = BinaryLogFormat::parse(format, newInfo.specs);
+			j = _formats.emplace(newInfo.text, &newInfo).first;
+		}
+		info = j->second;
+	}
+
+	if (cache.size() >= MAX_FORMATS)
+	{
+		cache.clear();
+	}
+	cache[format] = info;
+	return info;
+}
+
+const BinaryLogEncoder::FormatInfo& BinaryLogEncoder::plainFormat()
+{
+	static const FormatInfo& info = *formatInfo("%s");
+	return info;
+}
+
+uint32_t BinaryLogEncoder::stringId(const std::string& string)
+{
+	// Имя логгера и метка потока почти всегда те же, что и в прошлый раз
+	thread_local std::string lastString[2];
+	thread_local uint32_t lastId[2] = {0, 0};
+	thread_local size_t lastSlot = 0;
+
+	for (size_t slot = 0; slot < 2; ++slot)
+	{
+		if (lastId[slot] != 0 && lastString[slot] == string)
+		{
+			return lastId[slot];
+		}
+	}
+
+	thread_local std::unordered_map<std::string, uint32_t> cache;
+
+	lastSlot ^= 1;
+	lastString[lastSlot] = string;
+
+	auto i = cache.find(string);
+	if (i != cache.end())
+	{
+		return lastId[lastSlot] = i->second;
+	}
+
+	std::lock_guard<std::mutex> lockGuard(_registryMutex);
+
+	auto j = _strings.find(string);
+	if (j == _strings.end())
+	{
+		j = _strings.emplace(string, ++_lastId).first;
+	}
+
+	cache.emplace(string, j->second);
+	return lastId[lastSlot] = j->second;
+}
+
+std::vector<uint8_t>& BinaryLogEncoder::emitted()
+{
+	struct State
+	{
+		uint32_t epoch = 0;
+		std::vector<uint8_t> ids;
+	};
+	thread_local std::unordered_map<uint64_t, State> states;
+	thread_local uint64_t lastEncoderId = 0;
+	thread_local State* lastState = nullptr;
+
+	if (lastEncoderId != _encoderId)
+	{
+		lastState = &states[_encoderId];
+		lastEncoderId = _encoderId;
+	}
+
+	auto& state = *lastState;
+	auto epoch = _epoch.load(std::memory_order_relaxed);
+	if (state.epoch != epoch)
+	{
+		state.epoch = epoch;
+		state.ids.clear();
+	}
+	return state.ids;
+}
+
+void BinaryLogEncoder::defineFormat(std::string& out, std::vector<uint8_t>& ids, const FormatInfo& info)
+{
+	if (ids.size() > info.id && ids[info.id])
+	{
+		return;
+	}
+	if (ids.size() <= info.id)
+	{
+		ids.resize(info.id + 1);
+	}
+	ids[info.id] = 1;
+
+	put(out, BinaryLogFormat::Record::FORMAT);
+	put<uint32_t>(out, info.id);
+	putString(out, info.text.data(), info.text.size());
+}
+
+void BinaryLogEncoder::defineString(std::string& out, std::vector<uint8_t>& ids, uint32_t id, const std::string& string)
+{
+	if (ids.size() > id && ids[id])
+	{
+		return;
+	}
+	if (ids.size() <= id)
+	{
+		ids.resize(id + 1);
+	}
+	ids[id] = 1;
+
+	put(out, BinaryLogFormat::Record::STRING);
+	put<uint32_t>(out, id);
+	putString(out, string.data(), string.size());
+}
+
+size_t BinaryLogEncoder::beginEntry(std::string& out, std::vector<uint8_t>& ids, uint32_t formatId, Log::Detail level, const std::string& name, const std::string& thread)
+{
+	auto nameId = stringId(name);
+	auto threadId = stringId(thread);
+
+	defineString(out, ids, nameId, name);
+	defineString(out, ids, threadId, thread);
+
+	auto now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+	put(out, BinaryLogFormat::Record::ENTRY);
+	put<uint32_t>(out, formatId);
+	put<uint64_t>(out, static_cast<uint64_t>(now));
+	put<uint32_t>(out, nameId);
+	put<uint32_t>(out, threadId);
+	put<uint8_t>(out, static_cast<uint8_t>(level));
+
+	// Размер аргументов дописывается в endEntry()
+	auto offset = out.size();
+	put<uint32_t>(out, 0);
+	return offset;
+}
+
+void BinaryLogEncoder::endEntry(std::string& out, size_t offset)
+{
+	auto size = static_cast<uint32_t>(out.size() - offset - sizeof(uint32_t));
+	memcpy(&out[offset], &size, sizeof(size));
+}
+
+void BinaryLogEncoder::encode(std::string& out, Log::Detail level, const std::string& name, const std::string& thread, const char* format, va_list ap)
+{
+	auto info = formatInfo(format);
+
+	// Неподдерживаемый формат или реестр заполнен - пишем готовый текст
+	if (info == nullptr || !info->supported)
+	{
+		std::string message;
+		va_list ap1;
+		va_copy(ap1, ap);
+		auto n = vsnprintf(nullptr, 0, format, ap1);
+		va_end(ap1);
+		if (n > 0)
+		{
+			message.resize(static_cast<size_t>(n) + 1);
+			va_copy(ap1, ap);
+			vsnprintf(&message[0], message.size(), format, ap1);
+			va_end(ap1);
+			message.resize(static_cast<size_t>(n));
+		}
+		encode(out, level, name, thread, message);
+		return;
+	}
+
+	auto& ids = emitted();
+	defineFormat(out, ids, *info);
+
+	auto offset = beginEntry(out, ids, info->id, level, name, thread);
+
+	auto& args = out;
+	for (const auto& spec : info->specs)
+	{
+		switch (spec.arg)
+		{
+			case BinaryLogFormat::Arg::INT:
+				put<uint64_t>(args, static_cast<uint64_t>(static_cast<int64_t>(va_arg(ap, int))));
+				break;
+			case BinaryLogFormat::Arg::LONG:
+				put<uint64_t>(args, static_cast<uint64_t>(static_cast<int64_t>(va_arg(ap, long))));
+				break;
+			case BinaryLogFormat::Arg::LONGLONG:
+				put<uint64_t>(args, static_cast<uint64_t>(va_arg(ap, long long)));
+				break;
+			case BinaryLogFormat::Arg::SIZE:
+				put<uint64_t>(args, static_cast<uint64_t>(va_arg(ap, size_t)));
+				break;
+			case BinaryLogFormat::Arg::DOUBLE:
+				put<double>(args, va_arg(ap, double));
+				break;
+			case BinaryLogFormat::Arg::STRING:
+			{
+				auto string = va_arg(ap, const char*);
+				if (string == nullptr)
+				{
+					string = "(null)";
+				}
+				putString(args, string, strlen(string));
+				break;
+			}
+			case BinaryLogFormat::Arg::POINTER:
+				put<uint64_t>(args, static_cast<uint64_t>(reinterpret_cast<uintptr_t>(va_arg(ap, void*))));
+				break;
+		}
+	}
+
+	endEntry(out, offset);
+}
+
+void BinaryLogEncoder::encode(std::string& out, Log::Detail level, const std::string& name, const std::string& thread, const std::string& message)
+{
+	auto& info = plainFormat();
+
+	auto& ids = emitted();
+	defineFormat(out, ids, info);
+
+	auto offset = beginEntry(out, ids, info.id, level, name, thread);
+	putString(out, message.data(), message.size());
+	endEntry(out, offset);
+}
+
+void BinaryLogEncoder::discard(const std::string& record)
+{
+	auto& ids = emitted();
+
+	// Определения идут в начале записи, перед ENTRY
+	size_t pos = 0;
+	while (record.size() - pos >= sizeof(uint8_t) + sizeof(uint32_t))
+	{
+		auto type = static_cast<BinaryLogFormat::Record>(record[pos]);
+		if (type != BinaryLogFormat::Record::FORMAT && type != BinaryLogFormat::Record::STRING)
+		{
+			break;
+		}
+		uint32_t id;
+		memcpy(&id, &record[pos + sizeof(uint8_t)], sizeof(id));
+		if (id < ids.size())
+		{
+			ids[id] = 0;
+		}
+
+		pos += sizeof(uint8_t) + sizeof(uint32_t);
+		if (record.size() - pos < sizeof(uint32_t))
+		{
+			break;
+		}
+		uint32_t size;
+		memcpy(&size, &record[pos], sizeof(size));
+		pos += sizeof(uint32_t) + size;
+		if (pos > record.size())
+		{
+			break;
+		}
+	}
+}
+
+void BinaryLogEncoder::session(std::string& out)
+{
+	auto now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+	put(out, BinaryLogFormat::Record::SESSION);
+	put<uint32_t>(out, static_cast<uint32_t>(getpid()));
+	put<uint64_t>(out, static_cast<uint64_t>(now));
+}
+
+void BinaryLogEncoder::defineAll(std::string& out)
+{
+	std::lock_guard<std::mutex> lockGuard(_registryMutex);
+
+	for (const auto& info : _formatStorage)
+	{
+		put(out, BinaryLogFormat::Record::FORMAT);
+		put<uint32_t>(out, info.id);
+		putString(out, info.text.data(), info.text.size());
+	}
+
+	for (const auto& [string, id] : _strings)
+	{
+		put(out, BinaryLogFormat::Record::STRING);
+		put<uint32_t>(out, id);
+		putString(out, string.data(), string.size());
+	}
+}
@@ -0,0 +1,114 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// BinaryLogEncoder.hpp
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdarg>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <deque>
+#include "BinaryLogFormat.hpp"
+#include "Log.hpp"
+
+/// Кодирование записей в бинарный журнал (см. BinaryLogFormat).
+/// Строка формата разбирается один раз (реестр ведется по содержимому строки, кеш потока -
+/// по адресу с проверкой содержимого), далее запись сводится к копированию id, времени
+/// и сырых аргументов - без форматирования текста. Реестр ограничен: строки формата сверх
+/// лимита (как правило, собранные динамически) пишутся готовым текстом.
+class BinaryLogEncoder final
+{
+public:
+	/// Предельное количество строк формата в реестре
+	static constexpr size_t MAX_FORMATS = 4096;
+
+private:
+	struct FormatInfo
+	{
+		uint32_t id;
+		bool supported;
+		std::string text;
+		std::vector<BinaryLogFormat::Spec> specs;
+	};
+
+	/// Общий для процесса реестр строк формата и строк-идентификаторов
+	static std::mutex _registryMutex;
+	static std::unordered_map<std::string, FormatInfo*> _formats;
+	static std::deque<FormatInfo> _formatStorage;
+	static std::unordered_map<std::string, uint32_t> _strings;
+	static uint32_t _lastId;
+
+	static std::atomic<uint64_t> _lastEncoderId;
+	const uint64_t _encoderId;
+
+	/// Поколение (меняется при ротации файла, чтобы определения записались заново)
+	std::atomic<uint32_t> _epoch;
+
+	/// Описание строки формата или nullptr, если реестр заполнен
+	static const FormatInfo* formatInfo(const char* format);
+
+	/// Формат готового сообщения (регистрируется первым, поэтому в реестре есть всегда)
+	static const FormatInfo& plainFormat();
+	static uint32_t stringId(const std::string& string);
+
+	/// Определения, уже записанные текущим потоком в этот журнал
+	std::vector<uint8_t>& emitted();
+
+	void defineFormat(std::string& out, std::vector<uint8_t>& ids, const FormatInfo& info);
+	void defineString(std::string& out, std::vector<uint8_t>& ids, uint32_t id, const std::string& string);
+
+	size_t beginEntry(std::string& out, std::vector<uint8_t>& ids, uint32_t formatId, Log::Detail level, const std::string& name, const std::string& thread);
+	void endEntry(std::string& out, size_t offset);
+
+public:
+	BinaryLogEncoder(const BinaryLogEncoder&) = delete; // Copy-constructor
+	BinaryLogEncoder& operator=(const BinaryLogEncoder&) = delete; // Copy-assignment
+	BinaryLogEncoder(BinaryLogEncoder&&) noexcept = delete; // Move-constructor
+	BinaryLogEncoder& operator=(BinaryLogEncoder&&) noexcept = delete; // Move-assignment
+
+	BinaryLogEncoder();
+	~BinaryLogEncoder() = default;
+
+	/// Запись по строке формата (сырые аргументы)
+	void encode(std::string& out, Log::Detail level, const std::string& name, const std::string& thread, const char* format, va_list ap);
+
+	/// Запись готового сообщения
+	void encode(std::string& out, Log::Detail level, const std::string& name, const std::string& thread, const std::string& message);
+
+	/// Запись не попала в журнал (отброшена при переполнении): определения, которые она несла,
+	/// считаются незаписанными и будут повторены следующей записью. Вызывается тем же потоком,
+	/// что кодировал запись
+	void discard(const std::string& record);
+
+	/// Начать новый файл: определения будут записаны повторно
+	void restart()
+	{
+		_epoch.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/// Отметка начала сессии (при каждом открытии файла)
+	static void session(std::string& out);
+
+	/// Определения всех известных строк формата и строк-идентификаторов
+	/// (для начала нового файла: записи, еще стоящие в очереди, ссылаются на них)
+	static void defineAll(std::string& out);
+};
@@ -0,0 +1,143 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// BinaryLogFormat.hpp
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/// Формат бинарного журнала (общий для синка и для декодера).
+///
+/// Файл начинается с сигнатуры MAGIC, далее идут записи:
+///   FORMAT: u8 тип, u32 id, u32 длина, текст строки формата
+///   STRING: u8 тип, u32 id, u32 длина, текст (имя логгера, метка потока)
+///   ENTRY:  u8 тип, u32 id формата, u64 время (мкс от эпохи), u32 id имени логгера,
+///           u32 id метки потока, u8 уровень, u32 размер аргументов, аргументы
+///   SESSION: u8 тип, u32 pid, u64 время (мкс от эпохи) - пишется при каждом открытии файла
+/// Аргументы пишутся в порядке спецификаторов строки формата: целые и указатели -
+/// 8 байт, вещественные - 8 байт (double), строки - u32 длина и текст.
+/// Определения (FORMAT, STRING) могут повторяться и идти позже использующих их записей
+/// (записи разных потоков сливаются буферами), поэтому декодер читает файл в два прохода.
+/// Id действуют в пределах сессии: после перезапуска процесса файл дописывается, а id
+/// назначаются заново, поэтому на каждом SESSION декодер начинает таблицы заново.
+/// Числа пишутся в порядке байт машины, на которой велась запись.
+namespace BinaryLogFormat
+{
+
+static const char MAGIC[8] = {'T', 'K', 'B', 'L', 'O', 'G', '0', '1'};
+
+enum class Record : uint8_t
+{
+	FORMAT = 1,
+	STRING = 2,
+	ENTRY = 3,
+	SESSION = 4
+};
+
+enum class Arg : uint8_t
+{
+	INT,        // int (в т.ч. hh, h, c)
+	LONG,       // long
+	LONGLONG,   // long long
+	SIZE,       // size_t (z), ptrdiff_t (t), intmax_t (j)
+	DOUBLE,     // double
+	STRING,     // const char*
+	POINTER     // void*
+};
+
+/// Спецификатор строки формата
+struct Spec
+{
+	size_t begin;   // Позиция '%' в строке формата
+	size_t end;     // Позиция за символом преобразования
+	Arg arg;
+};
+
+/// Разобрать строку формата. Возвращает false, если встречены
+/// неподдерживаемые спецификаторы ('*', 'n', 'L' и т.п.)
+inline bool parse(const char* format, std::vector<Spec>& specs)
+{
+	specs.clear();
+
+	for (size_t i = 0; format[i] != 0; ++i)
+	{
+		if (format[i] != '%')
+		{
+			continue;
+		}
+
+		Spec spec{};
+		spec.begin = i++;
+
+		if (format[i] == '%')
+		{
+			continue;
+		}
+
+		// Флаги, ширина, точность
+		while (format[i] != 0 && strchr("-+ #0123456789.", format[i]) != nullptr)
+		{
+			++i;
+		}
+
+		// Модификатор длины
+		int longs = 0;
+		bool size = false;
+		while (format[i] != 0 && strchr("hlzjt", format[i]) != nullptr)
+		{
+			if (format[i] == 'l') ++longs;
+			if (format[i] == 'z' || format[i] == 'j' || format[i] == 't') size = true;
+			++i;
+		}
+
+		switch (format[i])
+		{
+			case 'd': case 'i': case 'u': case 'o': case 'x': case 'X': case 'c':
+				spec.arg = size ? Arg::SIZE : longs >= 2 ? Arg::LONGLONG : longs == 1 ? Arg::LONG : Arg::INT;
+				break;
+
+			case 'e': case 'E': case 'f': case 'F': case 'g': case 'G': case 'a': case 'A':
+				spec.arg = Arg::DOUBLE;
+				break;
+
+			case 's':
+				spec.arg = Arg::STRING;
+				break;
+
+			case 'p':
+				spec.arg = Arg::POINTER;
+				break;
+
+			default:
+				return false;
+		}
+
+		spec.end = i + 1;
+		specs.emplace_back(spec);
+	}
+
+	return true;
+}
+
+}
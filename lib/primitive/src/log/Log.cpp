@@ -61,6 +61,11 @@ void Log::setName(const std::string& name)
 //	_sink->trace().Register_Module(name.c_str(), &module);
 }
 
+void Log::emit(Detail detail, const std::string& message)
+{
+	_sink->push(detail, _name, message);
+}
+
 void Log::trace(const std::string& message)
 {
 #if defined(LOG_TRACE_ON)
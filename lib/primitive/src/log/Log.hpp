@@ -24,6 +24,7 @@
 #define LOG_TRACE_ON
 #define LOG_DEBUG_ON
 
+#include <memory>
 #include <string>
 #include <thread>
 
@@ -68,6 +69,24 @@ public:
 	}
 	void setDetail(Detail detail);
 
+	/// Будет ли выведена запись указанного уровня
+	bool isEnabled(Detail detail) const
+	{
+		return _detail <= detail;
+	}
+
+	/// Отложенное формирование записи: producer() вызывается, только если запись будет выведена
+	template<typename Producer>
+	void lazy(Detail detail, Producer&& producer)
+	{
+		if (isEnabled(detail))
+		{
+			emit(detail, producer());
+		}
+	}
+
+	void emit(Detail detail, const std::string& message);
+
 	void trace(const std::string& message);
 	void trace(const char* fmt, ...);
 
@@ -42,6 +42,34 @@ static const char *levelLabel[] = {
 
 const size_t Sink::accumucatorCapacity = 1<<14;
 
+static std::string formatMessage(const std::string& format, va_list ap)
+{
+	auto size = format.size() * 2 + 64;
+	std::string message;
+	for (;;)
+	{
+		message.resize(size);
+		va_list ap1;
+		va_copy(ap1, ap);
+		int n = vsnprintf(const_cast<char*>(message.data()), size, format.c_str(), ap1);
+		va_end(ap1);
+		if (n > -1)
+		{
+			if (static_cast<size_t>(n) < size)
+			{
+				message.resize(static_cast<size_t>(n));
+				break;
+			}
+			size = static_cast<size_t>(n) + 1;
+		}
+		else
+		{
+			size *= 2;
+		}
+	}
+	return message;
+}
+
 Sink::Sink(const Setting& setting)
 {
 	_f = nullptr;
@@ -64,6 +92,10 @@ Sink::Sink(const Setting& setting)
 	{
 		_type = Type::FILE;
 	}
+	else if (type == "binary")
+	{
+		_type = Type::BINARY;
+	}
 	else if (type == "null")
 	{
 		_type = Type::BLACKHOLE;
@@ -73,7 +105,7 @@ Sink::Sink(const Setting& setting)
 		throw std::runtime_error("Unknown type ('" + type + "') for sink '" + _name + "'");
 	}
 
-	if (_type == Type::FILE)
+	if (_type == Type::FILE || _type == Type::BINARY)
 	{
 		std::string directory;
 		if (!setting.lookupValue("directory", directory))
@@ -107,6 +139,73 @@ Sink::Sink(const Setting& setting)
 	{
 		_f = stdout;
 	}
+
+	if (_type == Type::BINARY)
+	{
+		_binary.reset(new BinaryLogEncoder());
+		writeBinaryHeader();
+	}
+
+	bool async = false;
+	setting.lookupValue("async", async);
+	if (async && _type != Type::BLACKHOLE)
+	{
+		int flushLatency = 100;
+		setting.lookupValue("flushLatency", flushLatency);
+		if (flushLatency <= 0)
+		{
+			throw std::runtime_error("Invalid flushLatency for sink '" + _name + "'");
+		}
+
+		int ringSize = 1<<18;
+		setting.lookupValue("ringSize", ringSize);
+		if (ringSize <= 0)
+		{
+			throw std::runtime_error("Invalid ringSize for sink '" + _name + "'");
+		}
+
+		std::string overflow = "drop";
+		setting.lookupValue("overflow", overflow);
+		AsyncSinkWriter::Overflow policy;
+		if (overflow == "drop")
+		{
+			policy = AsyncSinkWriter::Overflow::DROP;
+		}
+		else if (overflow == "block")
+		{
+			policy = AsyncSinkWriter::Overflow::BLOCK;
+		}
+		else
+		{
+			throw std::runtime_error("Unknown overflow policy ('" + overflow + "') for sink '" + _name + "'");
+		}
+
+		_async.reset(new AsyncSinkWriter(
+			[this](const char* data, size_t size)
+			{
+				std::lock_guard<mutex_t> lockGuard(_mutex);
+				if (_f != nullptr)
+				{
+					fwrite(data, size, 1, _f);
+					fflush(_f);
+				}
+			},
+			[this](uint64_t dropped)
+			{
+				auto message = std::to_string(dropped) + " log record(s) dropped because of overflow";
+				if (_binary)
+				{
+					std::string record;
+					_binary->encode(record, Log::Detail::WARN, "Logger", "", message);
+					return record;
+				}
+				return "*** " + message + " ***\n";
+			},
+			std::chrono::milliseconds(flushLatency),
+			policy,
+			static_cast<size_t>(ringSize)
+		));
+	}
 }
 
 Sink::Sink()
@@ -116,7 +215,10 @@ Sink::Sink()
 
 Sink::~Sink()
 {
-	if (_type == Type::FILE)
+	// Поток вывода сбрасывает остаток при остановке
+	_async.reset();
+
+	if (_type == Type::FILE || _type == Type::BINARY)
 	{
 		if (_f)
 		{
@@ -126,8 +228,68 @@ Sink::~Sink()
 	}
 }
 
+void Sink::writeBinaryHeader()
+{
+	if (_f == nullptr)
+	{
+		return;
+	}
+	fseek(_f, 0, SEEK_END);
+	if (ftell(_f) == 0)
+	{
+		fwrite(BinaryLogFormat::MAGIC, sizeof(BinaryLogFormat::MAGIC), 1, _f);
+	}
+
+	// Файл мог остаться от прошлого запуска, а id назначаются заново - отделяем сессию
+	std::string marker;
+	BinaryLogEncoder::session(marker);
+	fwrite(marker.data(), marker.size(), 1, _f);
+	fflush(_f);
+}
+
+void Sink::pushBinary(const std::string& record)
+{
+	if (_async)
+	{
+		// Отброшенная запись могла нести определения, на которые сошлются следующие
+		if (!_async->pushRaw(record))
+		{
+			_binary->discard(record);
+		}
+		return;
+	}
+
+	std::lock_guard<mutex_t> lockGuard(_mutex);
+	if (_f != nullptr)
+	{
+		// Без fflush: сбрасывается буфером stdio и по flush()
+		fwrite(record.data(), record.size(), 1, _f);
+	}
+}
+
+void Sink::push(Log::Detail level, const std::string& name, const char* format, va_list ap)
+{
+	if (_binary)
+	{
+		std::string record;
+		_binary->encode(record, level, name, Thread::self()->name(), format, ap);
+		pushBinary(record);
+		return;
+	}
+
+	push(level, name, std::string(format), ap);
+}
+
 void Sink::push(Log::Detail logLevel, const std::string& name, const std::string& message)
 {
+	if (_binary)
+	{
+		std::string record;
+		_binary->encode(record, logLevel, name, Thread::self()->name(), message);
+		pushBinary(record);
+		return;
+	}
+
 	const char* threadLabel = Thread::self()->name().c_str();
 
 	auto now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
@@ -149,6 +311,12 @@ void Sink::push(Log::Detail logLevel, const std::string& name, const std::string
 		threadLabel, name.c_str(), levelLabel[static_cast<int>(logLevel)]
 	);
 
+	if (_async && _f != nullptr)
+	{
+		_async->push(buff, (headerSize > 0) ? static_cast<size_t>(headerSize) : 0, message);
+		return;
+	}
+
 	std::unique_lock<mutex_t> lock(_mutex);
 
 	if (_f == nullptr)
@@ -194,6 +362,12 @@ void Sink::push(Log::Detail logLevel, const std::string& name, const std::string
 
 void Sink::push(Log::Detail level, const std::string& name, const std::string& format, va_list ap)
 {
+	if (_async && _f != nullptr)
+	{
+		push(level, name, formatMessage(format, ap));
+		return;
+	}
+
 	auto now = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 	time_t ts = now / 1'000'000;
 	auto msec = static_cast<uint32_t>(now % 1'000'000 / 1000);
@@ -328,6 +502,11 @@ void Sink::push(Log::Detail level, const std::string& name, const std::string& f
 // Принудительно сбросить на диск
 void Sink::flush()
 {
+	if (_async)
+	{
+		_async->sync();
+	}
+
 	std::lock_guard<mutex_t> lockGuard(_mutex);
 
 	if (_f == nullptr)
@@ -352,7 +531,7 @@ void Sink::flush()
 
 void Sink::rotate()
 {
-	if (_type == Type::FILE)
+	if (_type == Type::FILE || _type == Type::BINARY)
 	{
 		auto f = fopen(_path.c_str(), "a+");
 		if (f == nullptr)
@@ -373,6 +552,19 @@ void Sink::rotate()
 			}
 
 			_f = f;
+
+			if (_binary)
+			{
+				// В новом файле определения должны быть записаны заново. Записи, еще стоящие
+				// в очереди асинхронного вывода, попадут в новый файл, а ссылаются на определения,
+				// записанные в старый, - поэтому сразу пишем все известные определения
+				writeBinaryHeader();
+				std::string definitions;
+				BinaryLogEncoder::defineAll(definitions);
+				fwrite(definitions.data(), definitions.size(), 1, _f);
+				fflush(_f);
+				_binary->restart();
+			}
 		}
 
 		push(Log::Detail::INFO, "Logger", "Reopen logfile for rotation");
@@ -25,6 +25,8 @@
 #include "../configs/Setting.hpp"
 #include "Log.hpp"
 #include "../utils/Timer.hpp"
+#include "AsyncSinkWriter.hpp"
+#include "BinaryLogEncoder.hpp"
 
 #define PRE_ACCUMULATE_LOG
 
@@ -34,7 +36,8 @@ public:
 	enum class Type : uint8_t {
 		BLACKHOLE = 0,
 		CONSOLE,
-		FILE
+		FILE,
+		BINARY
 	};
 
 private:
@@ -51,6 +54,15 @@ private:
 	std::string _path;
 	std::string _preInitBuff;
 
+	/// Асинхронный вывод (если включен в настройках синка)
+	std::unique_ptr<AsyncSinkWriter> _async;
+
+	/// Кодировщик бинарного журнала (для синка типа BINARY)
+	std::unique_ptr<BinaryLogEncoder> _binary;
+
+	void writeBinaryHeader();
+	void pushBinary(const std::string& record);
+
 public:
 	Sink(const Sink&) = delete; // Copy-constructor
 	Sink& operator=(const Sink&) = delete; // Copy-assignment
@@ -68,6 +80,7 @@ public:
 
 	void push(Log::Detail level, const std::string& name, const std::string& message);
 	void push(Log::Detail level, const std::string& name, const std::string& format, va_list ap);
+	void push(Log::Detail level, const std::string& name, const char* format, va_list ap);
 
 	void flush();
 	void rotate();
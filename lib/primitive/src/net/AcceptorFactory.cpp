@@ -23,6 +23,21 @@
 #include "Acceptor.hpp"
 #include "SslAcceptor.hpp"
 #include "../utils/SslHelper.hpp"
+#include <iostream>
+
+Dummy AcceptorFactory::reg(const std::string& layer, LayerCreator creator)
+{
+	auto& factory = getInstance();
+
+	auto i = factory._layers.find(layer);
+	if (i != factory._layers.end())
+	{
+		std::cerr << "Internal error: Attempt to register acceptor with the same layer (" << layer << ")" << std::endl;
+		exit(EXIT_FAILURE);
+	}
+	factory._layers.emplace(layer, std::move(creator));
+	return Dummy{};
+}
 
 std::shared_ptr<AcceptorFactory::Creator> AcceptorFactory::creator(const Setting& setting)
 {
@@ -57,6 +72,37 @@ std::shared_ptr<AcceptorFactory::Creator> AcceptorFactory::creator(const Setting
 	{
 	}
 
+	std::string layer;
+	try
+	{
+		setting.lookupValue("layer", layer);
+	}
+	catch (const libconfig::SettingNotFoundException& exception)
+	{
+	}
+
+	if (!layer.empty())
+	{
+		auto& factory = getInstance();
+
+		auto i = factory._layers.find(layer);
+		if (i == factory._layers.end())
+		{
+			throw std::runtime_error("Bad config: unknown layer");
+		}
+		if (secure)
+		{
+			throw std::runtime_error("Bad config: layer is incompatible with secure");
+		}
+
+		return std::make_shared<Creator>(
+			[host = std::move(host), port, layerCreator = i->second](const std::shared_ptr<ServerTransport>& transport)
+			{
+				return layerCreator(transport, host, port);
+			}
+		);
+	}
+
 	if (secure)
 	{
 		return std::make_shared<Creator>(
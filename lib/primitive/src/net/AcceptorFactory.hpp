@@ -22,9 +22,11 @@
 #pragma once
 
 #include <functional>
+#include <map>
 #include <memory>
 
 #include "../configs/Setting.hpp"
+#include "../utils/Dummy.hpp"
 
 class Connection;
 class Acceptor;
@@ -35,6 +37,9 @@ class AcceptorFactory final
 public:
 	typedef std::function<std::shared_ptr<Connection>(const std::shared_ptr<ServerTransport>&)> Creator;
 
+	/// Создатель акцептора для дополнительного слоя поверх TCP (параметр "layer" в конфиге)
+	typedef std::function<std::shared_ptr<Connection>(const std::shared_ptr<ServerTransport>&, const std::string& host, std::uint16_t port)> LayerCreator;
+
 	AcceptorFactory(const AcceptorFactory&) = delete;
 	AcceptorFactory& operator=(const AcceptorFactory&) = delete;
 	AcceptorFactory(AcceptorFactory&&) noexcept = delete;
@@ -50,6 +55,10 @@ private:
 		return instance;
 	}
 
+	std::map<std::string, LayerCreator> _layers;
+
 public:
+	static Dummy reg(const std::string& layer, LayerCreator creator);
+
 	static std::shared_ptr<AcceptorFactory::Creator> creator(const Setting& setting);
 };
@@ -26,9 +26,12 @@
 #include "../utils/Daemon.hpp"
 #include "../thread/RollbackStackAndRestoreContext.hpp"
 #include "../thread/TaskManager.hpp"
+#include "../telemetry/Tracer.hpp"
 
 ConnectionManager::ConnectionManager()
 : _log("ConnectionManager")
+, _mutex("ConnectionManager")
+, _epool_mutex("ConnectionManager::epoll")
 {
 	_epfd = epoll_create(poolSize);
 	memset(_epev, 0, sizeof(_epev));
@@ -36,7 +39,7 @@ ConnectionManager::ConnectionManager()
 
 ConnectionManager::~ConnectionManager()
 {
-	std::lock_guard<std::recursive_mutex> guard(_mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
 	std::vector<std::shared_ptr<Connection>> connections;
 	for (auto& i : _allConnections)
 	{
@@ -53,7 +56,7 @@ ConnectionManager::~ConnectionManager()
 /// Зарегистрировать соединение
 void ConnectionManager::add(const std::shared_ptr<Connection>& connection)
 {
-	std::lock_guard<std::recursive_mutex> guard(getInstance()._mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(getInstance()._mutex);
 
 	if (getInstance()._allConnections.find(connection.get()) != getInstance()._allConnections.end())
 	{
@@ -98,7 +101,7 @@ bool ConnectionManager::remove(const std::shared_ptr<Connection>& connection)
 		getInstance()._log.trace("Remove %s from watching", connection->name().c_str());
 	}
 
-	std::lock_guard<std::recursive_mutex> guard(getInstance()._mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(getInstance()._mutex);
 	getInstance()._allConnections.erase(connection.get());
 	getInstance()._readyConnections.erase(connection);
 	getInstance()._capturedConnections.erase(connection);
@@ -110,7 +113,7 @@ bool ConnectionManager::remove(const std::shared_ptr<Connection>& connection)
 
 uint32_t ConnectionManager::rotateEvents(const std::shared_ptr<Connection>& connection)
 {
-	std::lock_guard<std::recursive_mutex> guard(getInstance()._mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(getInstance()._mutex);
 	uint32_t events = connection->rotateEvents();
 	return events;
 }
@@ -118,7 +121,7 @@ uint32_t ConnectionManager::rotateEvents(const std::shared_ptr<Connection>& conn
 void ConnectionManager::watch(const std::shared_ptr<Connection>& connection)
 {
 	// Для известных соенинений проверяем состояние захваченности
-	std::lock_guard<std::recursive_mutex> guard(getInstance()._mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(getInstance()._mutex);
 
 	// Те, что в обработке, не трогаем
 	if (connection->isCaptured())
@@ -157,9 +160,9 @@ void ConnectionManager::wait()
 
 	int n = 0;
 
-	while ([&](){std::lock_guard<std::recursive_mutex> lockGuard(_mutex); return _readyConnections.empty();}())
+	while ([&](){std::lock_guard<NamedRecursiveMutex> lockGuard(_mutex); return _readyConnections.empty();}())
 	{
-		if ([&](){std::lock_guard<std::recursive_mutex> lockGuard(_mutex); return _allConnections.empty();}())
+		if ([&](){std::lock_guard<NamedRecursiveMutex> lockGuard(_mutex); return _allConnections.empty();}())
 		{
 			std::this_thread::sleep_for(std::chrono::milliseconds(100));
 			break;
@@ -268,39 +271,51 @@ void ConnectionManager::wait()
 	_epool_mutex.unlock();
 }
 
-/// Зарегистрировать таймаут
-void ConnectionManager::timeout(const std::shared_ptr<Connection>& connection)
+/// Зарегистрировать событие, возникшее вне epoll
+void ConnectionManager::notify(const std::shared_ptr<Connection>& connection, ConnectionEvent::Type event)
 {
 	auto& instance = getInstance();
 
-	std::lock_guard<std::recursive_mutex> lockGuard(instance._mutex);
+	std::lock_guard<NamedRecursiveMutex> lockGuard(instance._mutex);
 
 	// Игнорируем незарегистрированные соединения
 	auto it = instance._allConnections.find(connection.get());
 	if (it == instance._allConnections.end())
 	{
-		instance._log.trace("Skip timeout adding for noregistered Connection %p", connection.get());
+		instance._log.trace("Skip event adding for noregistered Connection %p", connection.get());
 		return;
 	}
 
-	connection->appendEvents(static_cast<uint32_t>(ConnectionEvent::Type::TIMEOUT));
+	connection->appendEvents(static_cast<uint32_t>(event));
 
-	instance._log.trace("Catch event `T` on %s", connection->name().c_str());
+	instance._log.trace("Catch event `%s` on %s", ConnectionEvent::code(static_cast<uint32_t>(event)).c_str(), connection->name().c_str());
 
 	// Если не в списке захваченых...
 	if (instance._capturedConnections.find(connection) == instance._capturedConnections.end())
 	{
-		instance._log.trace("Insert %s into ready connection list and will be processed now (by timeout)", connection->name().c_str());
+		instance._log.trace("Insert %s into ready connection list and will be processed now (by event)", connection->name().c_str());
 
 		// ...добавляем в список готовых
 		instance._readyConnections.insert(connection);
 	}
 }
 
+/// Зарегистрировать таймаут
+void ConnectionManager::timeout(const std::shared_ptr<Connection>& connection)
+{
+	notify(connection, ConnectionEvent::Type::TIMEOUT);
+}
+
+/// Возобновить чтение приостановленного соединения
+void ConnectionManager::resume(const std::shared_ptr<Connection>& connection)
+{
+	notify(connection, ConnectionEvent::Type::READ);
+}
+
 /// Захватить соединение
 std::shared_ptr<Connection> ConnectionManager::capture()
 {
-	std::lock_guard<std::recursive_mutex> lockGuard(_mutex);
+	std::lock_guard<NamedRecursiveMutex> lockGuard(_mutex);
 
 	// Если нет готовых...
 	while (_readyConnections.empty())
@@ -343,7 +358,7 @@ std::shared_ptr<Connection> ConnectionManager::capture()
 /// Освободить соединение
 void ConnectionManager::release(const std::shared_ptr<Connection>& connection)
 {
-	std::lock_guard<std::recursive_mutex> guard(_mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
 
 	_log.trace("Release %s", connection->name().c_str());
 
@@ -353,6 +368,12 @@ void ConnectionManager::release(const std::shared_ptr<Connection>& connection)
 
 	if (!connection->isClosed())
 	{
+		// События, отложенные во время обработки, не теряем
+		if (connection->rotateEvents())
+		{
+			_readyConnections.insert(connection);
+		}
+
 		watch(connection);
 	}
 }
@@ -382,6 +403,8 @@ void ConnectionManager::dispatch()
 
 				getInstance()._log.trace("Begin processing on %s", connection->name().c_str());
 
+				Tracer::Scope traceScope("Connection processing", connection->name());
+
 				bool status;
 				try
 				{
@@ -27,6 +27,7 @@
 #include <mutex>
 #include <map>
 #include "Connection.hpp"
+#include "../thread/NamedMutex.hpp"
 
 class ConnectionManager final
 {
@@ -50,10 +51,10 @@ private:
 
 	Log _log;
 
-	std::recursive_mutex _mutex;
+	NamedRecursiveMutex _mutex;
 
 	/// Мютекс для эксклюзивного ожидания событий
-	std::mutex _epool_mutex;
+	NamedMutex _epool_mutex;
 
 	/// Реестр подключений
 	std::map<const Connection *, const std::shared_ptr<Connection>> _allConnections;
@@ -76,6 +77,9 @@ private:
 	/// Освободить соединение
 	void release(const std::shared_ptr<Connection>& conn);
 
+	/// Зарегистрировать событие, возникшее вне epoll
+	static void notify(const std::shared_ptr<Connection>& connection, ConnectionEvent::Type event);
+
 public:
 	/// Добавить соединение для наблюдения
 	static void watch(const std::shared_ptr<Connection>& connection);
@@ -89,6 +93,9 @@ public:
 	/// Зарегистрировать таймаут
 	static void timeout(const std::shared_ptr<Connection>& connection);
 
+	/// Возобновить чтение приостановленного соединения
+	static void resume(const std::shared_ptr<Connection>& connection);
+
 	/// Проверить и вернуть отложенные события
 	static uint32_t rotateEvents(const std::shared_ptr<Connection>& connection);
 
@@ -52,4 +52,12 @@ public:
 	{
 		return _inBuff.read(data, length);
 	}
+
+	/// Зарезервировать место под ожидаемый объем непрочитанных данных
+	inline bool reserve(size_t length)
+	{
+		std::lock_guard<NamedRecursiveMutex> guard(_inBuff.mutex());
+		auto have = _inBuff.dataLen();
+		return length > have ? _inBuff.prepare(length - have) : true;
+	}
 };
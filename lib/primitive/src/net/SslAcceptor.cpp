@@ -48,5 +48,5 @@ void SslAcceptor::createConnection(int sock, const sockaddr_in &cliaddr)
 
 	ConnectionManager::add(newConnection->ptr());
 
-	transport->metricConnectCount->addValue();
+	transport->metricConnectCount->add();
 }
@@ -285,7 +285,7 @@ bool SslConnection::writeToSocket()
 	// Отправляем данные
 	for (;;)
 	{
-		std::lock_guard<std::recursive_mutex> guard(_outBuff.mutex());
+		std::lock_guard<NamedRecursiveMutex> guard(_outBuff.mutex());
 
 		// Нечего отправлять
 		if (!hasDataForSend())
@@ -293,7 +293,7 @@ bool SslConnection::writeToSocket()
 			break;
 		}
 
-		int n = SSL_write(_sslConnect, _outBuff.dataPtr(), (_outBuff.dataLen() > 1ull<<12u) ? (1ull<<12u) : static_cast<int>(_outBuff.dataLen()));
+		int n = SSL_write(_sslConnect, _outBuff.frontPtr(), (_outBuff.frontLen() > 1ull<<12u) ? (1ull<<12u) : static_cast<int>(_outBuff.frontLen()));
 		if (n > 0)
 		{
 			_outBuff.skip(static_cast<size_t>(n));
@@ -362,7 +362,7 @@ bool SslConnection::readFromSocket()
 	// Пытаемся полностью заполнить буфер
 	for (;;)
 	{
-		std::lock_guard<std::recursive_mutex> guard(_inBuff.mutex());
+		std::lock_guard<NamedRecursiveMutex> guard(_inBuff.mutex());
 
 		_inBuff.prepare(1ull<<12u);
 
@@ -192,5 +192,5 @@ void TcpAcceptor::createConnection(int sock, const sockaddr_in &cliaddr)
 
 	ConnectionManager::add(newConnection->ptr());
 
-	transport->metricConnectCount->addValue();
+	transport->metricConnectCount->add();
 }
@@ -24,6 +24,7 @@
 #include <arpa/inet.h>
 #include <cstring>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include "../transport/ServerTransport.hpp"
 
 TcpConnection::TcpConnection(const std::shared_ptr<Transport>& transport, int sock, const sockaddr_in &sockaddr, bool outgoing)
@@ -31,6 +32,7 @@ TcpConnection::TcpConnection(const std::shared_ptr<Transport>& transport, int so
 , _outgoing(outgoing)
 , _noRead(false)
 , _noWrite(false)
+, _suspended(false)
 {
 	_sock = sock;
 
@@ -70,7 +72,7 @@ void TcpConnection::watch(epoll_event &ev)
 
 	ev.events |= EPOLLERR;
 
-	if (!_noRead)
+	if (!_noRead && !_suspended)
 	{
 		ev.events |= EPOLLIN | EPOLLRDNORM;
 	}
@@ -110,7 +112,7 @@ bool TcpConnection::processing()
 			writeToSocket();
 		}
 
-		if (isReadyForRead())
+		if (isReadyForRead() && !_suspended)
 		{
 			readFromSocket();
 		}
@@ -176,7 +178,7 @@ bool TcpConnection::writeToSocket()
 	// Отправляем данные
 	for (;;)
 	{
-		std::lock_guard<std::recursive_mutex> guard(_outBuff.mutex());
+		std::lock_guard<NamedRecursiveMutex> guard(_outBuff.mutex());
 
 		// Нечего отправлять
 		if (!hasDataForSend())
@@ -184,7 +186,11 @@ bool TcpConnection::writeToSocket()
 			break;
 		}
 
-		ssize_t n = ::write(_sock, _outBuff.dataPtr(), _outBuff.dataLen());
+		// Отправляем цепочку сегментов одним системным вызовом
+		iovec iov[64];
+		auto count = _outBuff.gather(iov, sizeof(iov) / sizeof(iov[0]));
+
+		ssize_t n = ::writev(_sock, iov, static_cast<int>(count));
 		if (n == -1)
 		{
 			// Повторяем вызов прерваный сигналом
@@ -233,7 +239,7 @@ bool TcpConnection::readFromSocket()
 			break;
 		}
 
-		std::lock_guard<std::recursive_mutex> guard(_inBuff.mutex());
+		std::lock_guard<NamedRecursiveMutex> guard(_inBuff.mutex());
 
 		_inBuff.prepare(bytes_available);
 
@@ -285,6 +291,17 @@ bool TcpConnection::readFromSocket()
 	return true;
 }
 
+void TcpConnection::resumeReading()
+{
+	if (!_suspended.exchange(false))
+	{
+		return;
+	}
+
+	// Данные в буфере надо разобрать, даже если на сокет больше ничего не придет
+	ConnectionManager::resume(ptr());
+}
+
 void TcpConnection::close()
 {
 	_noRead = true;
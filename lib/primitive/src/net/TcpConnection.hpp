@@ -22,6 +22,7 @@
 #pragma once
 
 #include "Connection.hpp"
+#include <atomic>
 #include "../utils/Buffer.hpp"
 #include "ReaderConnection.hpp"
 #include "WriterConnection.hpp"
@@ -41,6 +42,9 @@ protected:
 	/// Писать больше не будем
 	bool _noWrite;
 
+	/// Чтение приостановлено транспортом, пока не будет обработано прочитанное
+	std::atomic_bool _suspended;
+
 	virtual bool readFromSocket();
 
 	virtual bool writeToSocket();
@@ -90,6 +94,15 @@ public:
 		}
 	}
 
+	/// Приостановить чтение из сокета; непрочитанные данные остаются в буфере
+	void suspendReading()
+	{
+		_suspended = true;
+	}
+
+	/// Возобновить чтение и разбор оставшихся в буфере данных
+	void resumeReading();
+
 	void closeAfterSend()
 	{
 		_noRead = true;
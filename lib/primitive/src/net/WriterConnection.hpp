@@ -21,15 +21,21 @@
 
 #pragma once
 
-#include "../utils/Buffer.hpp"
+#include "../utils/ChainBuffer.hpp"
 #include "../utils/Writer.hpp"
 
 class WriterConnection : public Writer
 {
 protected:
-	Buffer _outBuff;
+	ChainBuffer _outBuff;
 
 public:
+	/// Мютекс очереди отправки (чтобы поставить данные из нескольких частей целиком)
+	inline auto& outMutex()
+	{
+		return _outBuff.mutex();
+	}
+
 	inline char* spacePtr() const override
 	{
 		return _outBuff.spacePtr();
@@ -51,4 +57,14 @@ public:
 	{
 		return _outBuff.write(data, length);
 	}
+
+	/// Поставить в очередь отправки готовые данные без копирования
+	inline void append(const SlabPtr& slab, const char* data, size_t length)
+	{
+		_outBuff.append(slab, data, length);
+	}
+	inline void append(const std::shared_ptr<const void>& holder, const char* data, size_t length)
+	{
+		_outBuff.append(holder, data, length);
+	}
 };
@@ -0,0 +1,48 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// Counter.cpp
+
+
+#include "Counter.hpp"
+
+Counter::Counter(std::string name)
+: _name(std::move(name))
+{
+	for (auto& shard : _shards)
+	{
+		shard.value.store(0, std::memory_order_relaxed);
+	}
+}
+
+size_t Counter::shardIndex()
+{
+	static std::atomic<size_t> nextIndex(0);
+	static thread_local size_t index = nextIndex.fetch_add(1, std::memory_order_relaxed) % SHARDS;
+	return index;
+}
+
+uint64_t Counter::value() const
+{
+	uint64_t sum = 0;
+	for (const auto& shard : _shards)
+	{
+		sum += shard.value.load(std::memory_order_relaxed);
+	}
+	return sum;
+}
@@ -0,0 +1,71 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// Counter.hpp
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/// Монотонный счетчик, разделенный на шарды по потокам.
+/// Каждый поток пишет в свою ячейку (отдельная кеш-линия), поэтому
+/// увеличение счетчика - одна relaxed-операция без конкуренции за линию.
+/// Значение получается суммированием шардов при чтении.
+class Counter final
+{
+public:
+	static constexpr size_t SHARDS = 16;
+
+private:
+	const std::string _name;
+
+	struct Shard
+	{
+		std::atomic<uint64_t> value;
+		char padding[64 - sizeof(std::atomic<uint64_t>)];
+	};
+	Shard _shards[SHARDS];
+
+	/// Номер шарда текущего потока
+	static size_t shardIndex();
+
+public:
+	Counter() = delete;
+	Counter(const Counter&) = delete;
+	Counter& operator=(const Counter&) = delete;
+	Counter(Counter&&) noexcept = delete;
+	Counter& operator=(Counter&&) noexcept = delete;
+
+	explicit Counter(std::string name);
+	~Counter() = default;
+
+	const std::string& name() const
+	{
+		return _name;
+	}
+
+	void add(uint64_t value = 1)
+	{
+		_shards[shardIndex()].value.fetch_add(value, std::memory_order_relaxed);
+	}
+
+	uint64_t value() const;
+};
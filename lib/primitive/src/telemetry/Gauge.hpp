@@ -0,0 +1,80 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// Gauge.hpp
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/// Мгновенное значение (число соединений, размер очереди и т.п.)
+class Gauge final
+{
+private:
+	const std::string _name;
+	std::atomic<int64_t> _value;
+
+public:
+	Gauge() = delete;
+	Gauge(const Gauge&) = delete;
+	Gauge& operator=(const Gauge&) = delete;
+	Gauge(Gauge&&) noexcept = delete;
+	Gauge& operator=(Gauge&&) noexcept = delete;
+
+	explicit Gauge(std::string name)
+	: _name(std::move(name))
+	, _value(0)
+	{
+	}
+	~Gauge() = default;
+
+	const std::string& name() const
+	{
+		return _name;
+	}
+
+	void set(int64_t value)
+	{
+		_value.store(value, std::memory_order_relaxed);
+	}
+
+	void add(int64_t value = 1)
+	{
+		_value.fetch_add(value, std::memory_order_relaxed);
+	}
+
+	void sub(int64_t value = 1)
+	{
+		_value.fetch_sub(value, std::memory_order_relaxed);
+	}
+
+	/// Поднять значение до value, если оно больше текущего
+	void setMax(int64_t value)
+	{
+		auto current = _value.load(std::memory_order_relaxed);
+		while (value > current && !_value.compare_exchange_weak(current, value, std::memory_order_relaxed));
+	}
+
+	int64_t value() const
+	{
+		return _value.load(std::memory_order_relaxed);
+	}
+};
@@ -0,0 +1,130 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// Histogram.cpp
+
+
+#include <algorithm>
+#include <cmath>
+#include "Histogram.hpp"
+
+Histogram::Histogram(std::string name)
+: _name(std::move(name))
+, _count(0)
+, _sum(0)
+, _max(0)
+{
+	for (auto& bucket : _buckets)
+	{
+		bucket.store(0, std::memory_order_relaxed);
+	}
+}
+
+size_t Histogram::bucketIndex(uint64_t value)
+{
+	if (value < SUB_BUCKETS)
+	{
+		return static_cast<size_t>(value);
+	}
+
+	// Номер старшего бита и номер группы (ширина корзин в группе - 2^group)
+	unsigned msb = 63 - static_cast<unsigned>(__builtin_clzll(value));
+	unsigned group = msb - PRECISION_BITS + 1;
+
+	return SUB_BUCKETS + (group - 1) * HALF_BUCKETS + static_cast<size_t>((value >> group) - HALF_BUCKETS);
+}
+
+uint64_t Histogram::bucketLowest(size_t index)
+{
+	if (index < SUB_BUCKETS)
+	{
+		return index;
+	}
+
+	unsigned group = static_cast<unsigned>((index - SUB_BUCKETS) / HALF_BUCKETS) + 1;
+	uint64_t top = (index - SUB_BUCKETS) % HALF_BUCKETS + HALF_BUCKETS;
+
+	return top << group;
+}
+
+uint64_t Histogram::bucketWidth(size_t index)
+{
+	if (index < SUB_BUCKETS)
+	{
+		return 1;
+	}
+
+	unsigned group = static_cast<unsigned>((index - SUB_BUCKETS) / HALF_BUCKETS) + 1;
+
+	return uint64_t(1) << group;
+}
+
+void Histogram::record(uint64_t value)
+{
+	_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+	_count.fetch_add(1, std::memory_order_relaxed);
+	_sum.fetch_add(value, std::memory_order_relaxed);
+
+	auto max = _max.load(std::memory_order_relaxed);
+	while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed));
+}
+
+double Histogram::mean() const
+{
+	auto count = _count.load(std::memory_order_relaxed);
+	if (count == 0)
+	{
+		return 0;
+	}
+	return static_cast<double>(_sum.load(std::memory_order_relaxed)) / static_cast<double>(count);
+}
+
+uint64_t Histogram::percentile(double q) const
+{
+	// Итог считаем по корзинам, а не по _count, чтобы снимок был согласован
+	uint64_t total = 0;
+	for (const auto& bucket : _buckets)
+	{
+		total += bucket.load(std::memory_order_relaxed);
+	}
+	if (total == 0)
+	{
+		return 0;
+	}
+
+	q = std::min(std::max(q, 0.0), 1.0);
+	auto rank = static_cast<uint64_t>(std::ceil(q * static_cast<double>(total)));
+	if (rank == 0)
+	{
+		rank = 1;
+	}
+
+	uint64_t seen = 0;
+	for (size_t index = 0; index < BUCKETS; ++index)
+	{
+		seen += _buckets[index].load(std::memory_order_relaxed);
+		if (seen >= rank)
+		{
+			// Середина корзины, но не больше наблюдавшегося максимума
+			auto value = bucketLowest(index) + bucketWidth(index) / 2;
+			return std::min(value, _max.load(std::memory_order_relaxed));
+		}
+	}
+
+	return _max.load(std::memory_order_relaxed);
+}
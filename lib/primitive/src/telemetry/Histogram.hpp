@@ -0,0 +1,104 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// Histogram.hpp
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/// Гистограмма в духе HDR: фиксированный набор корзин с логарифмически-линейной
+/// шкалой. Значения меньше SUB_BUCKETS учитываются точно, далее каждый диапазон
+/// [2^k, 2^(k+1)) делится на SUB_BUCKETS/2 равных корзин, что дает относительную
+/// погрешность не хуже ~3% во всем диапазоне uint64_t.
+/// Запись значения - несколько relaxed-операций, память не выделяется.
+class Histogram final
+{
+public:
+	static constexpr unsigned PRECISION_BITS = 5;
+	static constexpr size_t SUB_BUCKETS = size_t(1) << PRECISION_BITS;
+	static constexpr size_t HALF_BUCKETS = SUB_BUCKETS / 2;
+	static constexpr size_t BUCKETS = SUB_BUCKETS + (64 - PRECISION_BITS) * HALF_BUCKETS;
+
+private:
+	const std::string _name;
+
+	std::atomic<uint64_t> _buckets[BUCKETS];
+	std::atomic<uint64_t> _count;
+	std::atomic<uint64_t> _sum;
+	std::atomic<uint64_t> _max;
+
+	static size_t bucketIndex(uint64_t value);
+	static uint64_t bucketLowest(size_t index);
+	static uint64_t bucketWidth(size_t index);
+
+public:
+	Histogram() = delete;
+	Histogram(const Histogram&) = delete;
+	Histogram& operator=(const Histogram&) = delete;
+	Histogram(Histogram&&) noexcept = delete;
+	Histogram& operator=(Histogram&&) noexcept = delete;
+
+	explicit Histogram(std::string name);
+	~Histogram() = default;
+
+	const std::string& name() const
+	{
+		return _name;
+	}
+
+	void record(uint64_t value);
+
+	uint64_t count() const
+	{
+		return _count.load(std::memory_order_relaxed);
+	}
+
+	uint64_t sum() const
+	{
+		return _sum.load(std::memory_order_relaxed);
+	}
+
+	uint64_t max() const
+	{
+		return _max.load(std::memory_order_relaxed);
+	}
+
+	double mean() const;
+
+	/// Значение, не превышаемое долей q (0..1) записанных значений
+	uint64_t percentile(double q) const;
+
+	uint64_t p50() const
+	{
+		return percentile(0.5);
+	}
+
+	uint64_t p99() const
+	{
+		return percentile(0.99);
+	}
+
+	uint64_t p999() const
+	{
+		return percentile(0.999);
+	}
+};
@@ -267,3 +267,10 @@ Metric::type Metric::sum(size_t count)
 
 	return sum;
 }
+
+Metric::type Metric::last()
+{
+	std::lock_guard<std::mutex> lockGuard(_mutex);
+
+	return _points.empty() ? 0 : std::get<2>(_points.front());
+}
@@ -88,4 +88,7 @@ public:
 	type avg(std::chrono::steady_clock::duration interval);
 
 	type avgPerSec(std::chrono::steady_clock::duration interval);
+
+	/// Значение последнего кадра
+	type last();
 };
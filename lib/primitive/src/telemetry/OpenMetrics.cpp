@@ -0,0 +1,199 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// OpenMetrics.cpp
+
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "OpenMetrics.hpp"
+
+constexpr const char* OpenMetrics::CONTENT_TYPE;
+
+void OpenMetrics::render(const std::function<void(const char* data, size_t size)>& consumer)
+{
+	auto& instance = getInstance();
+
+	std::lock_guard<std::mutex> lockGuard(instance._mutex);
+
+	instance._buffer.clear();
+	instance._family.clear();
+
+	TelemetryManager::visit(instance);
+
+	instance._buffer += "# EOF\n";
+
+	consumer(instance._buffer.data(), instance._buffer.size());
+}
+
+void OpenMetrics::begin(const std::string& name, const char* type, const char* suffix)
+{
+	auto brace = name.find('{');
+
+	_name.clear();
+	for (size_t i = 0; i < std::min(brace, name.size()); ++i)
+	{
+		auto c = name[i];
+		if (
+			(c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':' ||
+			(c >= '0' && c <= '9' && !_name.empty())
+		)
+		{
+			_name += c;
+		}
+		else
+		{
+			_name += '_';
+		}
+	}
+
+	// Суффикс (например, _total у счетчика) не входит в имя семейства
+	if (suffix != nullptr)
+	{
+		auto length = strlen(suffix);
+		if (_name.size() > length && _name.compare(_name.size() - length, length, suffix) == 0)
+		{
+			_name.resize(_name.size() - length);
+		}
+	}
+
+	// Метки без фигурных скобок
+	_labels.clear();
+	if (brace != std::string::npos && name.size() > brace + 2 && name.back() == '}')
+	{
+		_labels.append(name, brace + 1, name.size() - brace - 2);
+	}
+
+	if (_name != _family)
+	{
+		_family = _name;
+
+		_buffer += "# TYPE ";
+		_buffer += _family;
+		_buffer += ' ';
+		_buffer += type;
+		_buffer += '\n';
+	}
+}
+
+void OpenMetrics::sampleName(const char* suffix, const char* extraLabel)
+{
+	_buffer += _name;
+	if (suffix != nullptr)
+	{
+		_buffer += suffix;
+	}
+
+	if (!_labels.empty() || extraLabel != nullptr)
+	{
+		_buffer += '{';
+		_buffer += _labels;
+		if (extraLabel != nullptr)
+		{
+			if (!_labels.empty())
+			{
+				_buffer += ',';
+			}
+			_buffer += extraLabel;
+		}
+		_buffer += '}';
+	}
+
+	_buffer += ' ';
+}
+
+void OpenMetrics::sample(const char* suffix, const char* extraLabel, double value)
+{
+	sampleName(suffix, extraLabel);
+
+	if (std::isnan(value))
+	{
+		_buffer += "NaN";
+	}
+	else if (std::isinf(value))
+	{
+		_buffer += value > 0 ? "+Inf" : "-Inf";
+	}
+	else
+	{
+		char number[32];
+		auto length = snprintf(number, sizeof(number), "%.10g", value);
+		_buffer.append(number, static_cast<size_t>(length));
+	}
+
+	_buffer += '\n';
+}
+
+void OpenMetrics::sample(const char* suffix, const char* extraLabel, uint64_t value)
+{
+	sampleName(suffix, extraLabel);
+
+	char number[24];
+	auto length = snprintf(number, sizeof(number), "%" PRIu64, value);
+	_buffer.append(number, static_cast<size_t>(length));
+
+	_buffer += '\n';
+}
+
+void OpenMetrics::sample(const char* suffix, const char* extraLabel, int64_t value)
+{
+	sampleName(suffix, extraLabel);
+
+	char number[24];
+	auto length = snprintf(number, sizeof(number), "%" PRId64, value);
+	_buffer.append(number, static_cast<size_t>(length));
+
+	_buffer += '\n';
+}
+
+void OpenMetrics::visit(Metric& metric)
+{
+	begin(metric.name(), "gauge");
+	sample(nullptr, nullptr, metric.last());
+}
+
+void OpenMetrics::visit(const Counter& counter)
+{
+	begin(counter.name(), "counter", "_total");
+	sample("_total", nullptr, counter.value());
+}
+
+void OpenMetrics::visit(const Gauge& gauge)
+{
+	begin(gauge.name(), "gauge");
+	sample(nullptr, nullptr, gauge.value());
+}
+
+void OpenMetrics::visit(const Histogram& histogram)
+{
+	begin(histogram.name(), "summary");
+	sample(nullptr, "quantile=\"0.5\"", histogram.p50());
+	sample(nullptr, "quantile=\"0.99\"", histogram.p99());
+	sample(nullptr, "quantile=\"0.999\"", histogram.p999());
+	sample("_count", nullptr, histogram.count());
+	sample("_sum", nullptr, histogram.sum());
+}
+
+void OpenMetrics::visit(const RateWindow& rate)
+{
+	begin(rate.name(), "gauge");
+	sample(nullptr, nullptr, rate.perSec());
+}
@@ -0,0 +1,78 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// OpenMetrics.hpp
+
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include "TelemetryManager.hpp"
+
+/// Выгрузка всех значений телеметрии в текстовом формате OpenMetrics
+/// (совместим с Prometheus). Имя вида "a/b/c{label="v"}" превращается
+/// в семейство a_b_c с метками {label="v"}.
+/// Текст собирается в переиспользуемый буфер, поэтому регулярный опрос
+/// после первого раза не выделяет память.
+class OpenMetrics final : private TelemetryManager::Visitor
+{
+public:
+	static constexpr const char* CONTENT_TYPE = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+	OpenMetrics(OpenMetrics const&) = delete;
+	void operator= (OpenMetrics const&) = delete;
+	OpenMetrics(OpenMetrics&&) noexcept = delete;
+	OpenMetrics& operator=(OpenMetrics&&) noexcept = delete;
+
+private:
+	OpenMetrics() = default;
+	~OpenMetrics() override = default;
+
+	static OpenMetrics &getInstance()
+	{
+		static OpenMetrics instance;
+		return instance;
+	}
+
+	std::mutex _mutex;
+	std::string _buffer;
+
+	/// Текущее семейство и разбор очередного имени
+	std::string _family;
+	std::string _name;
+	std::string _labels;
+
+	/// Разбирает имя; при смене семейства выводит строку # TYPE
+	void begin(const std::string& name, const char* type, const char* suffix = nullptr);
+	void sample(const char* suffix, const char* extraLabel, double value);
+	void sample(const char* suffix, const char* extraLabel, uint64_t value);
+	void sample(const char* suffix, const char* extraLabel, int64_t value);
+	void sampleName(const char* suffix, const char* extraLabel);
+
+	void visit(Metric& metric) override;
+	void visit(const Counter& counter) override;
+	void visit(const Gauge& gauge) override;
+	void visit(const Histogram& histogram) override;
+	void visit(const RateWindow& rate) override;
+
+public:
+	/// Собирает текст и передает его потребителю (буфер валиден только внутри вызова)
+	static void render(const std::function<void(const char* data, size_t size)>& consumer);
+};
@@ -0,0 +1,259 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// Profiler.cpp
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <sys/time.h>
+#include <unordered_map>
+#include <vector>
+#include "Profiler.hpp"
+#include "../log/Log.hpp"
+
+namespace
+{
+	/// Кадры самого обработчика и трамплина возврата из сигнала
+	constexpr int SKIP_FRAMES = 2;
+
+	std::string symbolize(void* address)
+	{
+		Dl_info dli{};
+		if (dladdr(address, &dli) == 0)
+		{
+			char buff[32];
+			snprintf(buff, sizeof(buff), "%p", address);
+			return buff;
+		}
+
+		if (dli.dli_sname != nullptr)
+		{
+			int status;
+			auto symbol = abi::__cxa_demangle(dli.dli_sname, nullptr, nullptr, &status);
+			if (status == 0)
+			{
+				std::string result(symbol);
+				free(symbol);
+				return result;
+			}
+			return dli.dli_sname;
+		}
+
+		// Символ не экспортирован: модуль и смещение внутри него
+		const char* module = dli.dli_fname != nullptr ? dli.dli_fname : "?";
+		if (auto slash = strrchr(module, '/'))
+		{
+			module = slash + 1;
+		}
+		char buff[32];
+		snprintf(buff, sizeof(buff), "+0x%zx",
+			reinterpret_cast<uintptr_t>(address) - reinterpret_cast<uintptr_t>(dli.dli_fbase));
+		return std::string(module) + buff;
+	}
+}
+
+Profiler::Profiler()
+: _running(false)
+, _capacity(0)
+, _head(0)
+, _dropped(0)
+, _frequency(0)
+, _prevAction()
+{
+}
+
+void Profiler::handler(int, siginfo_t*, void*)
+{
+	auto& instance = getInstance();
+	if (!instance._running.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	auto index = instance._head.fetch_add(1, std::memory_order_relaxed);
+	if (index >= instance._capacity)
+	{
+		instance._dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	auto savedErrno = errno;
+
+	auto& sample = instance._samples[index];
+	sample.depth = backtrace(sample.frames, MAX_DEPTH);
+	sample.ready.store(true, std::memory_order_release);
+
+	errno = savedErrno;
+}
+
+bool Profiler::start(unsigned frequency, size_t capacity)
+{
+	auto& instance = getInstance();
+
+	std::lock_guard<std::mutex> lockGuard(instance._mutex);
+
+	if (instance._running.load(std::memory_order_relaxed))
+	{
+		return false;
+	}
+
+	// Первый вызов backtrace подгружает libgcc_s (dlopen, malloc) -
+	// делаем его здесь, а не в обработчике сигнала
+	{
+		void* warmup[2];
+		backtrace(warmup, 2);
+	}
+
+	if (instance._capacity != capacity || !instance._samples)
+	{
+		instance._samples.reset(new Sample[capacity]);
+		instance._capacity = capacity;
+	}
+	for (size_t i = 0; i < instance._capacity; ++i)
+	{
+		instance._samples[i].ready.store(false, std::memory_order_relaxed);
+	}
+	instance._head.store(0, std::memory_order_relaxed);
+	instance._dropped.store(0, std::memory_order_relaxed);
+	instance._frequency = std::max(1u, std::min(frequency, 1000u));
+
+	struct sigaction act{};
+	sigemptyset(&act.sa_mask);
+	act.sa_flags = SA_SIGINFO | SA_RESTART;
+	act.sa_sigaction = Profiler::handler;
+	if (sigaction(SIGPROF, &act, &instance._prevAction) != 0)
+	{
+		throw std::runtime_error(std::string("Can't set handler of SIGPROF: ") + strerror(errno));
+	}
+
+	instance._running.store(true, std::memory_order_release);
+
+	itimerval timer{};
+	timer.it_interval.tv_sec = 0;
+	timer.it_interval.tv_usec = 1000000 / instance._frequency;
+	timer.it_value = timer.it_interval;
+	if (setitimer(ITIMER_PROF, &timer, nullptr) != 0)
+	{
+		auto error = errno;
+		instance._running.store(false, std::memory_order_relaxed);
+		sigaction(SIGPROF, &instance._prevAction, nullptr);
+		throw std::runtime_error(std::string("Can't start profiling timer: ") + strerror(error));
+	}
+
+	instance._begin = std::chrono::steady_clock::now();
+
+	Log("Profiler").info("Profiling started (%u Hz, buffer for %zu samples)", instance._frequency, instance._capacity);
+
+	return true;
+}
+
+void Profiler::stop()
+{
+	auto& instance = getInstance();
+
+	std::lock_guard<std::mutex> lockGuard(instance._mutex);
+
+	if (!instance._running.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	itimerval timer{};
+	setitimer(ITIMER_PROF, &timer, nullptr);
+
+	instance._running.store(false, std::memory_order_relaxed);
+
+	// Обработчик остается установленным: уже отправленный SIGPROF не должен
+	// попасть в обработчик по умолчанию, который завершает процесс
+	instance._end = std::chrono::steady_clock::now();
+
+	Log("Profiler").info("Profiling stopped (%zu samples, %zu dropped)", samples(), dropped());
+}
+
+size_t Profiler::samples()
+{
+	auto& instance = getInstance();
+	return std::min(instance._head.load(std::memory_order_relaxed), instance._capacity);
+}
+
+size_t Profiler::dropped()
+{
+	return getInstance()._dropped.load(std::memory_order_relaxed);
+}
+
+void Profiler::folded(std::ostream& os)
+{
+	auto& instance = getInstance();
+
+	std::lock_guard<std::mutex> lockGuard(instance._mutex);
+
+	std::unordered_map<void*, std::string> symbols;
+	std::map<std::string, size_t> stacks;
+
+	auto count = samples();
+	for (size_t i = 0; i < count; ++i)
+	{
+		auto& sample = instance._samples[i];
+		if (!sample.ready.load(std::memory_order_acquire))
+		{
+			continue;
+		}
+
+		std::string stack;
+		for (int n = sample.depth - 1; n >= SKIP_FRAMES; --n)
+		{
+			auto address = sample.frames[n];
+			// Адрес возврата указывает за инструкцию вызова; прерванный кадр - точный адрес
+			auto lookup = n > SKIP_FRAMES
+				? reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(address) - 1)
+				: address;
+
+			auto symbol = symbols.find(address);
+			if (symbol == symbols.end())
+			{
+				symbol = symbols.emplace(address, symbolize(lookup)).first;
+			}
+
+			if (!stack.empty())
+			{
+				stack.push_back(';');
+			}
+			stack.append(symbol->second);
+		}
+		if (stack.empty())
+		{
+			stack = "[unknown]";
+		}
+
+		++stacks[stack];
+	}
+
+	for (auto& stack : stacks)
+	{
+		os << stack.first << ' ' << stack.second << '\n';
+	}
+}
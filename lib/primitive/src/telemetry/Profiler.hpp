@@ -0,0 +1,98 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// Profiler.hpp
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+/// Семплирующий профилировщик процессорного времени.
+/// Таймер ITIMER_PROF шлет SIGPROF потоку, потребляющему процессор; обработчик
+/// снимает стек прерванного кода (в том числе стек задачи, переключенный через
+/// ucontext) и кладет его в заранее выделенный буфер без блокировок.
+/// Результат выдается в свернутом виде (folded stacks) для построения flamegraph.
+class Profiler final
+{
+public:
+	/// Максимальная глубина снимаемого стека
+	static constexpr int MAX_DEPTH = 64;
+
+	Profiler(Profiler const&) = delete;
+	void operator= (Profiler const&) = delete;
+	Profiler(Profiler&&) noexcept = delete;
+	Profiler& operator=(Profiler&&) noexcept = delete;
+
+private:
+	Profiler();
+	~Profiler() = default;
+
+	static Profiler &getInstance()
+	{
+		static Profiler instance;
+		return instance;
+	}
+
+	struct Sample
+	{
+		/// Семпл записан полностью
+		std::atomic_bool ready;
+		int depth;
+		void* frames[MAX_DEPTH];
+	};
+
+	std::mutex _mutex;
+	std::atomic_bool _running;
+	std::unique_ptr<Sample[]> _samples;
+	size_t _capacity;
+	std::atomic<size_t> _head;
+	std::atomic<size_t> _dropped;
+	unsigned _frequency;
+	std::chrono::steady_clock::time_point _begin;
+	std::chrono::steady_clock::time_point _end;
+	struct sigaction _prevAction;
+
+	static void handler(int sig, siginfo_t* info, void* context);
+
+public:
+	/// Начать семплирование с частотой frequency (Гц) в буфер на capacity семплов.
+	/// Ранее собранные семплы сбрасываются; false - профилировщик уже запущен
+	static bool start(unsigned frequency = 99, size_t capacity = 1u << 16);
+
+	/// Остановить семплирование (собранные семплы сохраняются до следующего запуска)
+	static void stop();
+
+	static bool running()
+	{
+		return getInstance()._running.load(std::memory_order_relaxed);
+	}
+
+	/// Число собранных семплов и семплов, не поместившихся в буфер
+	static size_t samples();
+	static size_t dropped();
+
+	/// Вывести собранные стеки в свернутом виде: "корень;...;лист количество"
+	static void folded(std::ostream& os);
+};
@@ -0,0 +1,93 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// RateWindow.cpp
+
+
+#include <algorithm>
+#include "RateWindow.hpp"
+
+RateWindow::RateWindow(std::string name, std::chrono::seconds window)
+: _name(std::move(name))
+, _seconds(static_cast<size_t>(std::max<std::chrono::seconds::rep>(window.count(), 1)))
+, _size(_seconds + 1)
+, _buckets(new std::atomic<uint64_t>[_size])
+{
+	for (size_t i = 0; i < _size; ++i)
+	{
+		_buckets[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+uint64_t RateWindow::currentSecond()
+{
+	return static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::seconds>(
+			std::chrono::steady_clock::now().time_since_epoch()
+		).count()
+	);
+}
+
+void RateWindow::add(uint64_t value)
+{
+	auto second = currentSecond();
+	auto stamp = second & STAMP_MASK;
+	auto& bucket = _buckets[second % _size];
+
+	auto word = bucket.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		auto bucketStamp = word >> COUNT_BITS;
+		if (bucketStamp == stamp)
+		{
+			bucket.fetch_add(value & COUNT_MASK, std::memory_order_relaxed);
+			return;
+		}
+		// Корзина уже занята более новой секундой (поток прочитал часы давно) - не затираем
+		if (((bucketStamp - stamp) & STAMP_MASK) <= _size)
+		{
+			return;
+		}
+		// Корзина от прошлого оборота - занимаем ее под текущую секунду
+		if (bucket.compare_exchange_weak(word, (stamp << COUNT_BITS) | (value & COUNT_MASK), std::memory_order_relaxed))
+		{
+			return;
+		}
+	}
+}
+
+double RateWindow::perSec(std::chrono::steady_clock::duration interval) const
+{
+	auto seconds = static_cast<size_t>(std::chrono::duration_cast<std::chrono::seconds>(interval).count());
+	seconds = std::min(std::max<size_t>(seconds, 1), _seconds);
+
+	auto second = currentSecond();
+
+	uint64_t sum = 0;
+	for (size_t i = 1; i <= seconds; ++i)
+	{
+		auto past = second - i;
+		auto word = _buckets[past % _size].load(std::memory_order_relaxed);
+		if ((word >> COUNT_BITS) == (past & STAMP_MASK))
+		{
+			sum += word & COUNT_MASK;
+		}
+	}
+
+	return static_cast<double>(sum) / static_cast<double>(seconds);
+}
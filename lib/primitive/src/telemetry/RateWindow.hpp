@@ -0,0 +1,80 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// RateWindow.hpp
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/// Скорость событий в скользящем окне (аналог Metric::avgPerSec).
+/// Окно разбито на посекундные корзины, переиспользуемые по кругу.
+/// Корзина - одно 64-битное слово: в старших битах метка секунды, в младших
+/// счетчик, поэтому учет события - чтение часов и одна-две relaxed-операции.
+class RateWindow final
+{
+private:
+	static constexpr unsigned COUNT_BITS = 40;
+	static constexpr uint64_t COUNT_MASK = (uint64_t(1) << COUNT_BITS) - 1;
+	static constexpr uint64_t STAMP_MASK = (uint64_t(1) << (64 - COUNT_BITS)) - 1;
+
+	const std::string _name;
+	const size_t _seconds;
+
+	/// Корзин на одну больше, чем секунд в окне: текущая секунда еще не завершена
+	const size_t _size;
+	std::unique_ptr<std::atomic<uint64_t>[]> _buckets;
+
+	static uint64_t currentSecond();
+
+public:
+	RateWindow() = delete;
+	RateWindow(const RateWindow&) = delete;
+	RateWindow& operator=(const RateWindow&) = delete;
+	RateWindow(RateWindow&&) noexcept = delete;
+	RateWindow& operator=(RateWindow&&) noexcept = delete;
+
+	RateWindow(std::string name, std::chrono::seconds window);
+	~RateWindow() = default;
+
+	const std::string& name() const
+	{
+		return _name;
+	}
+
+	std::chrono::seconds window() const
+	{
+		return std::chrono::seconds(_seconds);
+	}
+
+	void add(uint64_t value = 1);
+
+	/// Среднее число событий в секунду за последний interval (не больше окна),
+	/// по завершенным секундам
+	double perSec(std::chrono::steady_clock::duration interval) const;
+
+	double perSec() const
+	{
+		return perSec(window());
+	}
+};
@@ -95,3 +95,151 @@ const std::map<std::string, std::shared_ptr<Metric>>& TelemetryManager::metrics(
 	auto& instance = getInstance();
 	return instance._metrics;
 }
+
+std::shared_ptr<Counter> TelemetryManager::counter(const std::string& name)
+{
+	auto& instance = getInstance();
+
+	std::lock_guard<std::mutex> lockGuard(instance._mutex);
+
+	auto& counter = instance._counters[name];
+	if (!counter)
+	{
+		counter = std::make_shared<Counter>(name);
+	}
+	return counter;
+}
+
+std::shared_ptr<Gauge> TelemetryManager::gauge(const std::string& name)
+{
+	auto& instance = getInstance();
+
+	std::lock_guard<std::mutex> lockGuard(instance._mutex);
+
+	auto& gauge = instance._gauges[name];
+	if (!gauge)
+	{
+		gauge = std::make_shared<Gauge>(name);
+	}
+	return gauge;
+}
+
+std::shared_ptr<Histogram> TelemetryManager::histogram(const std::string& name)
+{
+	auto& instance = getInstance();
+
+	std::lock_guard<std::mutex> lockGuard(instance._mutex);
+
+	auto& histogram = instance._histograms[name];
+	if (!histogram)
+	{
+		histogram = std::make_shared<Histogram>(name);
+	}
+	return histogram;
+}
+
+std::shared_ptr<RateWindow> TelemetryManager::rate(const std::string& name, std::chrono::seconds window)
+{
+	auto& instance = getInstance();
+
+	std::lock_guard<std::mutex> lockGuard(instance._mutex);
+
+	auto& rate = instance._rates[name];
+	if (!rate)
+	{
+		rate = std::make_shared<RateWindow>(name, window);
+	}
+	return rate;
+}
+
+std::map<std::string, std::shared_ptr<Counter>> TelemetryManager::counters()
+{
+	auto& instance = getInstance();
+	std::lock_guard<std::mutex> lockGuard(instance._mutex);
+	return instance._counters;
+}
+
+std::map<std::string, std::shared_ptr<Gauge>> TelemetryManager::gauges()
+{
+	auto& instance = getInstance();
+	std::lock_guard<std::mutex> lockGuard(instance._mutex);
+	return instance._gauges;
+}
+
+std::map<std::string, std::shared_ptr<Histogram>> TelemetryManager::histograms()
+{
+	auto& instance = getInstance();
+	std::lock_guard<std::mutex> lockGuard(instance._mutex);
+	return instance._histograms;
+}
+
+std::map<std::string, std::shared_ptr<RateWindow>> TelemetryManager::rates()
+{
+	auto& instance = getInstance();
+	std::lock_guard<std::mutex> lockGuard(instance._mutex);
+	return instance._rates;
+}
+
+std::string TelemetryManager::labeled(
+	const std::string& family,
+	std::initializer_list<std::pair<const char*, std::string>> labels
+)
+{
+	std::string name;
+	name.reserve(family.size() + 32 * labels.size());
+	name += family;
+
+	char separator = '{';
+	for (const auto& label : labels)
+	{
+		name += separator;
+		name += label.first;
+		name += "=\"";
+		for (auto c : label.second)
+		{
+			switch (c)
+			{
+				case '\\': name += "\\\\"; break;
+				case '"': name += "\\\""; break;
+				case '\n': name += "\\n"; break;
+				default: name += c;
+			}
+		}
+		name += '"';
+		separator = ',';
+	}
+	if (separator == ',')
+	{
+		name += '}';
+	}
+
+	return name;
+}
+
+void TelemetryManager::visit(Visitor& visitor)
+{
+	auto& instance = getInstance();
+
+	std::lock_guard<std::mutex> lockGuard(instance._mutex);
+
+	for (const auto& i : instance._metrics)
+	{
+		visitor.visit(*i.second);
+	}
+	for (const auto& i : instance._counters)
+	{
+		visitor.visit(*i.second);
+	}
+	for (const auto& i : instance._gauges)
+	{
+		visitor.visit(*i.second);
+	}
+	for (const auto& i : instance._rates)
+	{
+		visitor.visit(*i.second);
+	}
+	for (const auto& i : instance._histograms)
+	{
+		visitor.visit(*i.second);
+	}
+}
@@ -25,7 +25,12 @@
 #include <memory>
 #include <map>
 #include <mutex>
+#include <initializer_list>
 #include "Metric.hpp"
+#include "Counter.hpp"
+#include "Gauge.hpp"
+#include "Histogram.hpp"
+#include "RateWindow.hpp"
 
 class TelemetryManager final
 {
@@ -48,6 +53,10 @@ private:
 	std::mutex _mutex;
 
 	std::map<std::string, std::shared_ptr<Metric>> _metrics;
+	std::map<std::string, std::shared_ptr<Counter>> _counters;
+	std::map<std::string, std::shared_ptr<Gauge>> _gauges;
+	std::map<std::string, std::shared_ptr<Histogram>> _histograms;
+	std::map<std::string, std::shared_ptr<RateWindow>> _rates;
 
 public:
 	static std::shared_ptr<Metric> metric(
@@ -69,4 +78,41 @@ public:
 	);
 
 	static const std::map<std::string, std::shared_ptr<Metric>>& metrics();
+
+	/// Примитивы без блокировок при записи: объект создается при первом
+	/// обращении, дальше вызывающая сторона хранит указатель у себя
+	static std::shared_ptr<Counter> counter(const std::string& name);
+	static std::shared_ptr<Gauge> gauge(const std::string& name);
+	static std::shared_ptr<Histogram> histogram(const std::string& name);
+	static std::shared_ptr<RateWindow> rate(
+		const std::string& name,
+		std::chrono::seconds window = std::chrono::seconds(15)
+	);
+
+	/// Снимки реестров (для экспорта)
+	static std::map<std::string, std::shared_ptr<Counter>> counters();
+	static std::map<std::string, std::shared_ptr<Gauge>> gauges();
+	static std::map<std::string, std::shared_ptr<Histogram>> histograms();
+	static std::map<std::string, std::shared_ptr<RateWindow>> rates();
+
+	/// Имя с метками в формате family{label="value",...}.
+	/// Экспортер группирует по family, метки выводит как есть
+	static std::string labeled(
+		const std::string& family,
+		std::initializer_list<std::pair<const char*, std::string>> labels
+	);
+
+	/// Обход всех зарегистрированных значений под блокировкой реестра,
+	/// в порядке имен и без копирования реестров
+	class Visitor
+	{
+	public:
+		virtual ~Visitor() = default;
+		virtual void visit(Metric& metric) = 0;
+		virtual void visit(const Counter& counter) = 0;
+		virtual void visit(const Gauge& gauge) = 0;
+		virtual void visit(const Histogram& histogram) = 0;
+		virtual void visit(const RateWindow& rate) = 0;
+	};
+	static void visit(Visitor& visitor);
 };
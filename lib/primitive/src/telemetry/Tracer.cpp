@@ -0,0 +1,260 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// Tracer.cpp
+
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "Tracer.hpp"
+#include "../log/Log.hpp"
+#include "../thread/Thread.hpp"
+
+namespace
+{
+	int64_t toMicros(Tracer::Time time)
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+	}
+
+	void writeEscaped(std::ostream& os, const char* str)
+	{
+		for (; *str; ++str)
+		{
+			auto c = *str;
+			if (c == '"' || c == '\\')
+			{
+				os << '\\' << c;
+			}
+			else if (static_cast<unsigned char>(c) < 0x20)
+			{
+				os << ' ';
+			}
+			else
+			{
+				os << c;
+			}
+		}
+	}
+}
+
+Tracer::Tracer()
+: _enabled(false)
+, _dumpRequested(false)
+, _capacity(8192)
+, _path("trace")
+{
+}
+
+void Tracer::enable(size_t eventsPerThread, std::string path)
+{
+	auto& instance = getInstance();
+
+	{
+		std::lock_guard<std::mutex> lockGuard(instance._mutex);
+
+		instance._capacity = std::max<size_t>(eventsPerThread, 64);
+		if (!path.empty())
+		{
+			instance._path = std::move(path);
+		}
+	}
+
+	instance._enabled.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::disable()
+{
+	getInstance()._enabled.store(false, std::memory_order_relaxed);
+}
+
+Tracer::Ring* Tracer::ring()
+{
+	thread_local std::shared_ptr<Ring> ring;
+	if (ring)
+	{
+		return ring.get();
+	}
+
+	auto& instance = getInstance();
+
+	std::lock_guard<std::mutex> lockGuard(instance._mutex);
+
+	ring = std::make_shared<Ring>();
+	ring->capacity = instance._capacity;
+	ring->events.reset(new Event[ring->capacity]);
+	for (size_t i = 0; i < ring->capacity; ++i)
+	{
+		ring->events[i].seq.store(0, std::memory_order_relaxed);
+	}
+	ring->head.store(0, std::memory_order_relaxed);
+	ring->tid = static_cast<uint32_t>(syscall(SYS_gettid));
+	if (auto thread = Thread::self())
+	{
+		ring->threadName = thread->name();
+	}
+	else
+	{
+		ring->threadName = "thread-" + std::to_string(ring->tid);
+	}
+
+	// Кольцо остается в реестре и после завершения потока - его события нужны в выгрузке
+	instance._rings.emplace_back(ring);
+
+	return ring.get();
+}
+
+void Tracer::record(Kind kind, const char* label, const std::string* name, Time queued, Time until, Time begin, Time end)
+{
+	auto ring = Tracer::ring();
+
+	auto index = ring->head.load(std::memory_order_relaxed);
+	auto& event = ring->events[index % ring->capacity];
+
+	event.seq.store(2 * index + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	event.kind = kind;
+	event.label = label;
+	if (name != nullptr)
+	{
+		auto length = std::min(name->size(), sizeof(event.name) - 1);
+		memcpy(event.name, name->data(), length);
+		event.name[length] = 0;
+	}
+	else
+	{
+		event.name[0] = 0;
+	}
+	event.queued = toMicros(queued);
+	event.until = toMicros(until);
+	event.begin = toMicros(begin);
+	event.end = toMicros(end);
+
+	event.seq.store(2 * index + 2, std::memory_order_release);
+	ring->head.store(index + 1, std::memory_order_release);
+}
+
+void Tracer::dump(std::ostream& os)
+{
+	auto& instance = getInstance();
+
+	std::vector<std::shared_ptr<Ring>> rings;
+	{
+		std::lock_guard<std::mutex> lockGuard(instance._mutex);
+		rings = instance._rings;
+	}
+
+	auto pid = static_cast<int>(getpid());
+
+	os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	bool first = true;
+	for (const auto& ring : rings)
+	{
+		os << (first ? "" : ",")
+			<< "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << ring->tid
+			<< ",\"args\":{\"name\":\"";
+		writeEscaped(os, ring->threadName.c_str());
+		os << "\"}}";
+		first = false;
+
+		auto head = ring->head.load(std::memory_order_acquire);
+		auto from = head > ring->capacity ? head - ring->capacity : 0;
+
+		for (auto index = from; index < head; ++index)
+		{
+			const auto& slot = ring->events[index % ring->capacity];
+
+			auto seq = slot.seq.load(std::memory_order_acquire);
+			if (seq != 2 * index + 2)
+			{
+				continue; // Перезаписан или пишется прямо сейчас
+			}
+
+			Event event;
+			event.kind = slot.kind;
+			event.label = slot.label;
+			memcpy(event.name, slot.name, sizeof(event.name));
+			event.queued = slot.queued;
+			event.until = slot.until;
+			event.begin = slot.begin;
+			event.end = slot.end;
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (slot.seq.load(std::memory_order_relaxed) != seq)
+			{
+				continue;
+			}
+			event.name[sizeof(event.name) - 1] = 0;
+
+			os << ",\n{\"name\":\"";
+			writeEscaped(os, event.label);
+			os << "\",\"cat\":\"" << (event.kind == Kind::Task ? "task" : "span") << "\""
+				<< ",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << ring->tid
+				<< ",\"ts\":" << event.begin << ",\"dur\":" << (event.end - event.begin)
+				<< ",\"args\":{";
+			if (event.kind == Kind::Task)
+			{
+				// Задержка от постановки в очередь и опоздание относительно назначенного времени
+				os << "\"queued_us\":" << (event.begin - event.queued)
+					<< ",\"late_us\":" << (event.begin - std::max(event.until, event.queued));
+			}
+			else
+			{
+				os << "\"name\":\"";
+				writeEscaped(os, event.name);
+				os << "\"";
+			}
+			os << "}}";
+		}
+	}
+
+	os << "\n]}\n";
+}
+
+std::string Tracer::dumpToFile()
+{
+	auto& instance = getInstance();
+
+	std::string path;
+	{
+		std::lock_guard<std::mutex> lockGuard(instance._mutex);
+		path = instance._path;
+	}
+	path += "-" + std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
+		std::chrono::system_clock::now().time_since_epoch()
+	).count()) + ".json";
+
+	std::ofstream file(path, std::ios::out | std::ios::trunc);
+	if (!file.is_open())
+	{
+		Log("Tracer").warn("Can't open file '%s' for trace dump", path.c_str());
+		return std::string();
+	}
+
+	dump(file);
+
+	Log("Tracer").info("Trace dumped into '%s'", path.c_str());
+
+	return path;
+}
@@ -0,0 +1,181 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// Tracer.hpp
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/// Трассировка исполнения задач и обработки соединений (включается по требованию).
+/// События пишутся в кольцевой буфер своего потока без блокировок и выгружаются
+/// в формате Chrome trace-event JSON (chrome://tracing, Perfetto).
+/// Выгрузку можно запросить из обработчика сигнала: запрос только ставит флаг,
+/// а сам файл пишет ближайший рабочий поток после завершения своей задачи.
+class Tracer final
+{
+public:
+	using Clock = std::chrono::steady_clock;
+	using Time = Clock::time_point;
+
+	Tracer(Tracer const&) = delete;
+	void operator= (Tracer const&) = delete;
+	Tracer(Tracer&&) noexcept = delete;
+	Tracer& operator=(Tracer&&) noexcept = delete;
+
+private:
+	Tracer();
+	~Tracer() = default;
+
+	static Tracer &getInstance()
+	{
+		static Tracer instance;
+		return instance;
+	}
+
+	enum class Kind : uint8_t
+	{
+		Task,
+		Span
+	};
+
+	struct Event
+	{
+		/// Версия слота (seqlock): нечетная - идет запись
+		std::atomic<uint64_t> seq;
+		Kind kind;
+		const char* label;
+		char name[40];
+		int64_t queued;
+		int64_t until;
+		int64_t begin;
+		int64_t end;
+	};
+
+	struct Ring
+	{
+		std::unique_ptr<Event[]> events;
+		size_t capacity;
+		std::atomic<uint64_t> head;
+		uint32_t tid;
+		std::string threadName;
+	};
+
+	std::atomic_bool _enabled;
+	std::atomic_bool _dumpRequested;
+
+	std::mutex _mutex;
+	size_t _capacity;
+	std::string _path;
+	std::vector<std::shared_ptr<Ring>> _rings;
+
+	static Ring* ring();
+
+	static void record(Kind kind, const char* label, const std::string* name, Time queued, Time until, Time begin, Time end);
+
+public:
+	/// Включить трассировку; eventsPerThread - размер кольца каждого потока,
+	/// path - префикс имени файла выгрузки
+	static void enable(size_t eventsPerThread, std::string path);
+	static void disable();
+
+	static bool enabled()
+	{
+		return getInstance()._enabled.load(std::memory_order_relaxed);
+	}
+
+	/// Исполненная задача: когда поставлена в очередь, на какое время назначена,
+	/// когда фактически начата и завершена
+	static void task(const char* label, Time queued, Time until, Time begin, Time end)
+	{
+		record(Kind::Task, label, nullptr, queued, until, begin, end);
+	}
+
+	/// Произвольный интервал (например, обработка событий соединения)
+	static void span(const char* label, const std::string& name, Time begin, Time end)
+	{
+		record(Kind::Span, label, &name, Time(), Time(), begin, end);
+	}
+
+	/// Интервал от создания до разрушения объекта
+	class Scope final
+	{
+		const char* _label;
+		const std::string& _name;
+		Time _begin;
+		bool _active;
+
+	public:
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+		Scope(Scope&&) noexcept = delete;
+		Scope& operator=(Scope&&) noexcept = delete;
+
+		Scope(const char* label, const std::string& name)
+		: _label(label)
+		, _name(name)
+		, _active(Tracer::enabled())
+		{
+			if (_active)
+			{
+				_begin = Clock::now();
+			}
+		}
+
+		~Scope()
+		{
+			if (_active)
+			{
+				Tracer::span(_label, _name, _begin, Clock::now());
+			}
+		}
+	};
+
+	/// Записать все накопленные события
+	static void dump(std::ostream& os);
+
+	/// Записать в файл <path>-<unixtime>.json; возвращает имя файла
+	static std::string dumpToFile();
+
+	/// Запросить выгрузку (безопасно для обработчика сигнала)
+	static void requestDump()
+	{
+		getInstance()._dumpRequested.store(true, std::memory_order_relaxed);
+	}
+
+	/// Выполнить запрошенную выгрузку, если она была запрошена
+	static void poll()
+	{
+		auto& instance = getInstance();
+		if (instance._dumpRequested.load(std::memory_order_relaxed))
+		{
+			if (instance._dumpRequested.exchange(false, std::memory_order_relaxed))
+			{
+				dumpToFile();
+			}
+		}
+	}
+};
@@ -0,0 +1,55 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// NamedMutex.cpp
+
+
+#include "NamedMutex.hpp"
+
+#ifdef MUTEX_STATS
+
+#include <map>
+#include <string>
+#include "../telemetry/TelemetryManager.hpp"
+
+MutexStats::MutexStats(const char* name)
+: _acquisitions(TelemetryManager::counter(TelemetryManager::labeled("mutex/acquisitions", {{"lock", name}})))
+, _contended(TelemetryManager::counter(TelemetryManager::labeled("mutex/contended", {{"lock", name}})))
+, _waitTime(TelemetryManager::histogram(TelemetryManager::labeled("mutex/wait_time_ns", {{"lock", name}})))
+, _maxHoldTime(TelemetryManager::gauge(TelemetryManager::labeled("mutex/max_hold_time_ns", {{"lock", name}})))
+{
+}
+
+MutexStats* MutexStats::get(const char* name)
+{
+	// Собственный реестр: обычный мьютекс, чтобы не считать самого себя.
+	// Не разрушается при выходе - мьютексы синглтонов могут пережить его
+	static std::mutex mutex;
+	static auto registry = new std::map<std::string, std::unique_ptr<MutexStats>>;
+
+	std::lock_guard<std::mutex> lockGuard(mutex);
+
+	auto& stats = (*registry)[name];
+	if (!stats)
+	{
+		stats.reset(new MutexStats(name));
+	}
+	return stats.get();
+}
+
+#endif
@@ -0,0 +1,179 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// NamedMutex.hpp
+
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#ifdef MUTEX_STATS
+#include "../telemetry/Counter.hpp"
+#include "../telemetry/Gauge.hpp"
+#include "../telemetry/Histogram.hpp"
+#endif
+
+/// Статистика блокировок по имени мьютекса (общая для всех мьютексов с этим именем).
+/// Публикуется через TelemetryManager с меткой lock="<имя>"
+class MutexStats final
+{
+public:
+	MutexStats(const MutexStats&) = delete;
+	MutexStats& operator=(const MutexStats&) = delete;
+	MutexStats(MutexStats&&) noexcept = delete;
+	MutexStats& operator=(MutexStats&&) noexcept = delete;
+
+#ifdef MUTEX_STATS
+private:
+	std::shared_ptr<Counter> _acquisitions;
+	std::shared_ptr<Counter> _contended;
+	std::shared_ptr<Histogram> _waitTime;
+	std::shared_ptr<Gauge> _maxHoldTime;
+
+public:
+	explicit MutexStats(const char* name);
+	~MutexStats() = default;
+
+	/// Экземпляр статистики для имени (создается при первом обращении)
+	static MutexStats* get(const char* name);
+
+	void acquired(bool contended, uint64_t waitNanos)
+	{
+		_acquisitions->add();
+		if (contended)
+		{
+			_contended->add();
+		}
+		_waitTime->record(waitNanos);
+	}
+
+	void released(uint64_t holdNanos)
+	{
+		_maxHoldTime->setMax(static_cast<int64_t>(holdNanos));
+	}
+#endif
+};
+
+/// Мьютекс с именем места блокировки, совместимый по интерфейсу с Mutex
+/// (подходит для std::lock_guard, std::unique_lock, std::condition_variable_any).
+/// При сборке с MUTEX_STATS считает захваты, время ожидания и максимальное
+/// время удержания; без него - просто обертка над Mutex без накладных расходов.
+template <typename Mutex>
+class BasicNamedMutex final
+{
+private:
+	Mutex _mutex;
+
+#ifdef MUTEX_STATS
+	using Clock = std::chrono::steady_clock;
+
+	MutexStats* _stats;
+	Clock::time_point _lockedAt;
+	size_t _depth; // Глубина захвата (для рекурсивного мьютекса)
+
+	static uint64_t nanos(Clock::duration duration)
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+	}
+
+	void locked()
+	{
+		if (_depth++ == 0)
+		{
+			_lockedAt = Clock::now();
+		}
+	}
+#endif
+
+public:
+	BasicNamedMutex(const BasicNamedMutex&) = delete;
+	BasicNamedMutex& operator=(const BasicNamedMutex&) = delete;
+	BasicNamedMutex(BasicNamedMutex&&) noexcept = delete;
+	BasicNamedMutex& operator=(BasicNamedMutex&&) noexcept = delete;
+
+#ifdef MUTEX_STATS
+	explicit BasicNamedMutex(const char* name)
+	: _stats(MutexStats::get(name))
+	, _depth(0)
+	{
+	}
+
+	void lock()
+	{
+		if (_mutex.try_lock())
+		{
+			_stats->acquired(false, 0);
+		}
+		else
+		{
+			auto beginTime = Clock::now();
+			_mutex.lock();
+			_stats->acquired(true, nanos(Clock::now() - beginTime));
+		}
+		locked();
+	}
+
+	bool try_lock()
+	{
+		if (!_mutex.try_lock())
+		{
+			return false;
+		}
+		_stats->acquired(false, 0);
+		locked();
+		return true;
+	}
+
+	void unlock()
+	{
+		if (--_depth == 0)
+		{
+			_stats->released(nanos(Clock::now() - _lockedAt));
+		}
+		_mutex.unlock();
+	}
+#else
+	explicit BasicNamedMutex(const char*)
+	{
+	}
+
+	void lock()
+	{
+		_mutex.lock();
+	}
+
+	bool try_lock()
+	{
+		return _mutex.try_lock();
+	}
+
+	void unlock()
+	{
+		_mutex.unlock();
+	}
+#endif
+
+	~BasicNamedMutex() = default;
+};
+
+using NamedMutex = BasicNamedMutex<std::mutex>;
+using NamedRecursiveMutex = BasicNamedMutex<std::recursive_mutex>;
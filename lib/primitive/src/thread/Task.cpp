@@ -23,10 +23,12 @@
 #include "../utils/Daemon.hpp"
 #include "Thread.hpp"
 #include "ThreadPool.hpp"
+#include "../telemetry/Tracer.hpp"
 
 Task::Task(Func&& function, Time until, const char* label)
 : _function(std::move(function))
 , _until(until)
+, _queued(Tracer::enabled() ? Clock::now() : Time())
 , _label(label)
 , _parentTaskContext(Thread::getContext())
 {
@@ -35,6 +37,7 @@ Task::Task(Func&& function, Time until, const char* label)
 Task::Task(Task&& that) noexcept
 : _function(std::move(that._function))
 , _until(that._until)
+, _queued(that._queued)
 , _label(that._label)
 , _parentTaskContext(that._parentTaskContext)
 {
@@ -51,6 +54,7 @@ Task& Task::operator=(Task&& that) noexcept
 
 	_function = std::move(that._function);
 	_until = that._until;
+	_queued = that._queued;
 	_label = that._label;
 	_parentTaskContext = that._parentTaskContext;
 	that._function = static_cast<void(*)()>(nullptr);
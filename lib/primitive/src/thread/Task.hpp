@@ -38,6 +38,7 @@ public:
 private:
 	Func _function;
 	Time _until;
+	Time _queued;
 	const char* _label;
 	mutable ucontext_t* _parentTaskContext;
 
@@ -59,6 +60,12 @@ public:
 		return _until;
 	}
 
+	// Время постановки в очередь (фиксируется только при включенной трассировке)
+	const Time& queued() const
+	{
+		return _queued;
+	}
+
 	// Метка задачи (имя, название и т.п., для отладки)
 	const char* label() const
 	{
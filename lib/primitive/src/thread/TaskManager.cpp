@@ -23,6 +23,7 @@
 #include "../utils/Daemon.hpp"
 #include "ThreadPool.hpp"
 #include "RollbackStackAndRestoreContext.hpp"
+#include "../telemetry/Tracer.hpp"
 
 #if __cplusplus < 201703L
 #define constexpr
@@ -30,6 +31,7 @@
 
 TaskManager::TaskManager()
 : _log("TaskManager")//, Log::Detail::TRACE)
+, _mutex("TaskManager")
 {
 }
 
@@ -149,6 +151,9 @@ void TaskManager::executeOne()
 
 	ThreadPool::wakeup();
 
+	bool tracing = Tracer::enabled();
+	auto beginTime = tracing ? Task::Clock::now() : Task::Time();
+
 	try
 	{
 		task.execute();
@@ -161,6 +166,12 @@ void TaskManager::executeOne()
 	{
 		instance._log.warn("Uncatched exception at execute task of pool: %s", exception.what());
 	}
+
+	if (tracing)
+	{
+		Tracer::task(task.label(), task.queued(), task.until(), beginTime, Task::Clock::now());
+		Tracer::poll();
+	}
 }
 
 bool TaskManager::empty()
@@ -28,6 +28,7 @@
 #include <mutex>
 #include <set>
 #include "Task.hpp"
+#include "NamedMutex.hpp"
 #include "../log/Log.hpp"
 
 class TaskManager final
@@ -50,7 +51,7 @@ public:
 	}
 
 private:
-	using mutex_t =	std::mutex;
+	using mutex_t =	NamedMutex;
 
 	Log _log;
 	mutex_t _mutex;
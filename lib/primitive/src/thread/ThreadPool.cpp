@@ -27,8 +27,11 @@
 
 // the constructor just launches some amount of _workers
 ThreadPool::ThreadPool()
-: _log("ThreadPool")
+: _contextsMutex("ThreadPool::contexts")
+, _log("ThreadPool")
+, _counterMutex("ThreadPool::counter")
 , _lastWorkerId(0)
+, _workerMutex("ThreadPool::workers")
 {
 }
 
@@ -36,7 +39,7 @@ void ThreadPool::hold()
 {
 	auto& pool = getInstance();
 
-	std::lock_guard<std::mutex> lockGuard(pool._counterMutex);
+	std::lock_guard<NamedMutex> lockGuard(pool._counterMutex);
 	++pool._hold;
 	pool._workersWakeupCondition.notify_one();
 }
@@ -45,7 +48,7 @@ void ThreadPool::unhold()
 {
 	auto& pool = getInstance();
 
-	std::lock_guard<std::mutex> lockGuard(pool._counterMutex);
+	std::lock_guard<NamedMutex> lockGuard(pool._counterMutex);
 	--pool._hold;
 }
 
@@ -53,7 +56,7 @@ void ThreadPool::setThreadNum(size_t num)
 {
 	auto& pool = getInstance();
 
-	std::lock_guard<std::mutex> lockGuard(pool._workerMutex);
+	std::lock_guard<NamedMutex> lockGuard(pool._workerMutex);
 
 	size_t remain = (num < pool._workers.size()) ? 0 : (num - pool._workers.size());
 	while (remain-- > 0)
@@ -64,11 +67,19 @@ void ThreadPool::setThreadNum(size_t num)
 	pool._workersWakeupCondition.notify_one();
 }
 
+size_t ThreadPool::getThreadNum()
+{
+	auto& pool = getInstance();
+
+	std::lock_guard<NamedMutex> lockGuard(pool._workerMutex);
+	return pool._workers.size();
+}
+
 size_t ThreadPool::genThreadId()
 {
 	auto& pool = getInstance();
 
-	std::lock_guard<std::mutex> lockGuard(pool._counterMutex);
+	std::lock_guard<NamedMutex> lockGuard(pool._counterMutex);
 	return ++pool._lastWorkerId;
 }
 
@@ -82,7 +93,7 @@ void ThreadPool::createThread()
 		auto continueCondition =
 			[this,&waitUntil]
 			{
-				std::lock_guard<std::mutex> lockGuard(_counterMutex);
+				std::lock_guard<NamedMutex> lockGuard(_counterMutex);
 				if (Daemon::shutingdown())
 				{
 					return true;
@@ -101,7 +112,7 @@ void ThreadPool::createThread()
 		while (!TaskManager::empty() || _hold)
 		{
 			{
-				std::unique_lock<std::mutex> lock(_workerMutex);
+				std::unique_lock<NamedMutex> lock(_workerMutex);
 
 				// Condition for run thread
 				if (!_workersWakeupCondition.wait_until(lock, waitUntil, continueCondition))
@@ -113,7 +124,7 @@ void ThreadPool::createThread()
 			// Execute task
 			TaskManager::executeOne();
 
-			std::lock_guard<std::mutex> lockGuard(_contextsMutex);
+			std::lock_guard<NamedMutex> lockGuard(_contextsMutex);
 
 			if (!_readyForContinueContexts.empty() && Thread::getCurrContextCount() > Thread::sizeContextForReplace())
 			{
@@ -162,7 +173,7 @@ void ThreadPool::wait()
 	{
 		// Wait end all threads
 		{
-			std::lock_guard<std::mutex> lockGuard(pool._workerMutex);
+			std::lock_guard<NamedMutex> lockGuard(pool._workerMutex);
 			for (auto i = pool._workers.begin(); i != pool._workers.end(); )
 			{
 				auto ci = i++;
@@ -190,7 +201,7 @@ Thread *ThreadPool::getThread(Thread::Id tid)
 {
 	auto& pool = getInstance();
 
-	std::lock_guard<std::mutex> lockGuard(pool._workerMutex);
+	std::lock_guard<NamedMutex> lockGuard(pool._workerMutex);
 
 	auto i = pool._workers.find(tid);
 	if (i == pool._workers.end())
@@ -204,7 +215,7 @@ bool ThreadPool::empty()
 {
 	auto& pool = getInstance();
 
-	std::lock_guard<std::mutex> lockGuard(pool._workerMutex);
+	std::lock_guard<NamedMutex> lockGuard(pool._workerMutex);
 
 	return pool._workers.empty();
 }
@@ -218,7 +229,7 @@ void ThreadPool::continueContext(ucontext_t* context)
 
 	auto& pool = getInstance();
 
-	std::lock_guard<std::mutex> lockGuard(pool._contextsMutex);
+	std::lock_guard<NamedMutex> lockGuard(pool._contextsMutex);
 
 //	pool._log.info("Begin continueContext <= %p", context);
 
@@ -27,6 +27,7 @@
 #include <condition_variable>
 #include <queue>
 #include "Thread.hpp"
+#include "NamedMutex.hpp"
 
 class ThreadPool final
 {
@@ -56,6 +57,8 @@ public:
 
 	static void setThreadNum(size_t num);
 
+	static size_t getThreadNum();
+
 	static size_t genThreadId();
 
 //	static void enqueue(const std::shared_ptr<Task::Func>& function);
@@ -71,7 +74,7 @@ public:
 	static void unhold();
 
 public:// TODO временно
-	std::mutex _contextsMutex;
+	NamedMutex _contextsMutex;
 	std::queue<ucontext_t *> _readyForContinueContexts;
 public:
 	static void continueContext(ucontext_t* context);
@@ -79,7 +82,7 @@ public:
 private:
 	Log _log;
 
-	std::mutex _counterMutex;
+	NamedMutex _counterMutex;
 	size_t _lastWorkerId;
 
 	size_t _hold;
@@ -88,8 +91,8 @@ private:
 	std::map<Thread::Id, Thread*> _workers;
 
 	// synchronization
-	std::mutex _workerMutex;
-	std::condition_variable _workersWakeupCondition;
+	NamedMutex _workerMutex;
+	std::condition_variable_any _workersWakeupCondition;
 
 	void createThread();
 };
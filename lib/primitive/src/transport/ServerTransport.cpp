@@ -44,10 +44,10 @@ ServerTransport::ServerTransport(const Setting& setting)
 
 	_acceptorCreator = AcceptorFactory::creator(setting);
 
-	metricConnectCount = TelemetryManager::metric("transport/" + _name + "/connections", 1);
-	metricRequestCount = TelemetryManager::metric("transport/" + _name + "/requests", 1);
-	metricAvgRequestPerSec = TelemetryManager::metric("transport/" + _name + "/requests_per_second", std::chrono::seconds(15));
-	metricAvgExecutionTime = TelemetryManager::metric("transport/" + _name + "/requests_exec_time", std::chrono::seconds(15));
+	metricConnectCount = TelemetryManager::counter(TelemetryManager::labeled("transport/connections", {{"transport", _name}}));
+	metricRequestCount = TelemetryManager::counter(TelemetryManager::labeled("transport/requests", {{"transport", _name}}));
+	metricAvgRequestPerSec = TelemetryManager::rate(TelemetryManager::labeled("transport/requests_per_second", {{"transport", _name}}));
+	metricExecutionTime = TelemetryManager::histogram(TelemetryManager::labeled("transport/requests_exec_time_us", {{"transport", _name}}));
 }
 
 bool ServerTransport::enable()
@@ -30,7 +30,9 @@
 #include "../configs/Setting.hpp"
 #include "../serialization/SerializerFactory.hpp"
 #include "../utils/Context.hpp"
-#include "../telemetry/Metric.hpp"
+#include "../telemetry/Counter.hpp"
+#include "../telemetry/Histogram.hpp"
+#include "../telemetry/RateWindow.hpp"
 
 #include <memory>
 #include <functional>
@@ -51,10 +53,10 @@ public:
 	explicit ServerTransport(const Setting& setting);
 	~ServerTransport() override = default;
 
-	std::shared_ptr<Metric> metricConnectCount;
-	std::shared_ptr<Metric> metricRequestCount;
-	std::shared_ptr<Metric> metricAvgRequestPerSec;
-	std::shared_ptr<Metric> metricAvgExecutionTime;
+	std::shared_ptr<Counter> metricConnectCount;
+	std::shared_ptr<Counter> metricRequestCount;
+	std::shared_ptr<RateWindow> metricAvgRequestPerSec;
+	std::shared_ptr<Histogram> metricExecutionTime;
 
 	virtual bool enable() final;
 	virtual bool disable() final;
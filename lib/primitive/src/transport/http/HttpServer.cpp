@@ -340,20 +340,17 @@ bool HttpServer::processing(const std::shared_ptr<Connection>& connection_)
 				)
 			);
 
-			if (metricRequestCount) metricRequestCount->addValue();
-			if (metricAvgRequestPerSec) metricAvgRequestPerSec->addValue();
+			metricRequestCount->add();
+			metricAvgRequestPerSec->add();
 			auto beginTime = std::chrono::steady_clock::now();
 
 			context->handle();
 
-			auto now = std::chrono::steady_clock::now();
-			auto timeSpent =
-				static_cast<double>(std::chrono::steady_clock::duration(now - beginTime).count()) /
-				static_cast<double>(std::chrono::steady_clock::duration(std::chrono::seconds(1)).count());
-			if (timeSpent > 0)
-			{
-				if (metricAvgExecutionTime) metricAvgExecutionTime->addValue(timeSpent, now);
-			}
+			metricExecutionTime->record(static_cast<uint64_t>(
+				std::chrono::duration_cast<std::chrono::microseconds>(
+					std::chrono::steady_clock::now() - beginTime
+				).count()
+			));
 
 			connection->resetContext();
 			n++;
@@ -60,7 +60,7 @@ void WsContext::setEstablished()
 	{
 		transport->metricRequestCount = prevTransport->metricRequestCount;
 		transport->metricAvgRequestPerSec = prevTransport->metricAvgRequestPerSec;
-		transport->metricAvgExecutionTime = prevTransport->metricAvgExecutionTime;
+		transport->metricExecutionTime = prevTransport->metricExecutionTime;
 	}
 
 	connection->setTransport(transport);
@@ -24,7 +24,9 @@
 
 #include "../Transport.hpp"
 #include "../../net/TcpConnection.hpp"
-#include "../../telemetry/Metric.hpp"
+#include "../../telemetry/Counter.hpp"
+#include "../../telemetry/Histogram.hpp"
+#include "../../telemetry/RateWindow.hpp"
 
 class WsPipe final : public Transport
 {
@@ -43,9 +45,9 @@ public:
 
 	~WsPipe() override;
 
-	std::shared_ptr<Metric> metricRequestCount;
-	std::shared_ptr<Metric> metricAvgRequestPerSec;
-	std::shared_ptr<Metric> metricAvgExecutionTime;
+	std::shared_ptr<Counter> metricRequestCount;
+	std::shared_ptr<RateWindow> metricAvgRequestPerSec;
+	std::shared_ptr<Histogram> metricExecutionTime;
 
 	bool processing(const std::shared_ptr<Connection>& connection) override;
 
@@ -24,14 +24,15 @@
 #include <cstring>
 
 Buffer::Buffer()
-: _getPosition(0)
+: _mutex("Buffer")
+, _getPosition(0)
 , _putPosition(0)
 {
 }
 
 const std::vector<char>& Buffer::data()
 {
-	std::lock_guard<std::recursive_mutex> guard(_mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
 
 	// Если есть прочитанные данные в начале буффера
 	if (_getPosition > 0)
@@ -51,31 +52,31 @@ const std::vector<char>& Buffer::data()
 
 const char *Buffer::dataPtr() const
 {
-	std::lock_guard<std::recursive_mutex> guard(_mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
 	return _data.data() + _getPosition;
 }
 
 size_t Buffer::dataLen() const
 {
-	std::lock_guard<std::recursive_mutex> guard(_mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
 	return _putPosition - _getPosition;
 }
 
 char *Buffer::spacePtr() const
 {
-	std::lock_guard<std::recursive_mutex> guard(_mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
 	return const_cast<char *>(_data.data()) + _putPosition;
 }
 
 size_t Buffer::spaceLen() const
 {
-	std::lock_guard<std::recursive_mutex> guard(_mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
 	return _data.size() - _putPosition;
 }
 
 size_t Buffer::size() const
 {
-	std::lock_guard<std::recursive_mutex> guard(_mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
 	return _data.size();
 }
 
@@ -85,7 +86,7 @@ bool Buffer::show(void *data, size_t length) const
 	{
 		return true;
 	}
-	std::lock_guard<std::recursive_mutex> guard(_mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
 	if (_putPosition - _getPosition < length)
 	{
 		return false;
@@ -100,7 +101,7 @@ bool Buffer::skip(size_t length)
 	{
 		return true;
 	}
-	std::lock_guard<std::recursive_mutex> guard(_mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
 	if (_putPosition - _getPosition < length)
 	{
 		return false;
@@ -115,18 +116,14 @@ bool Buffer::read(void *data_, size_t length)
 	{
 		return true;
 	}
-	std::lock_guard<std::recursive_mutex> guard(_mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
 	if (_putPosition - _getPosition < length)
 	{
 		return false;
 	}
 
-	auto data = static_cast<char *>(data_);
-
-	while (length-- > 0)
-	{
-		*data++ = _data[_getPosition++];
-	}
+	memcpy(data_, _data.data() + _getPosition, length);
+	_getPosition += length;
 	return true;
 }
 
@@ -136,7 +133,7 @@ bool Buffer::prepare(size_t length)
 	{
 		return true;
 	}
-	std::lock_guard<std::recursive_mutex> guard(_mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
 	// Недостаточно места в конце буффера
 	if (_putPosition + length > _data.size())
 	{
@@ -154,7 +151,9 @@ bool Buffer::prepare(size_t length)
 	// Все еще недостаточно места в конце буффера
 	if (_putPosition + length > _data.size())
 	{
-		_data.resize(((_putPosition + length) / (1ull<<12) + 1) * (1ull<<12));
+		// Растем геометрически, чтобы серия мелких записей не приводила к квадратичному копированию
+		auto need = std::max(_putPosition + length, _data.size() + _data.size() / 2);
+		_data.resize((need / (1ull<<12) + 1) * (1ull<<12));
 	}
 	return true;
 }
@@ -165,7 +164,7 @@ bool Buffer::forward(size_t length)
 	{
 		return true;
 	}
-	std::lock_guard<std::recursive_mutex> guard(_mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
 	if (length > spaceLen())
 	{
 		return false;
@@ -182,16 +181,12 @@ bool Buffer::write(const void *data_, size_t length)
 	{
 		return true;
 	}
-	std::lock_guard<std::recursive_mutex> guard(_mutex);
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
 
 	prepare(length);
 
 
-	auto data = static_cast<const char *>(data_);
-
-	while (length-- > 0)
-	{
-		_data[_putPosition++] = *data++;
-	}
+	memcpy(_data.data() + _putPosition, data_, length);
+	_putPosition += length;
 	return true;
 }
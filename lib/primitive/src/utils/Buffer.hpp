@@ -26,13 +26,14 @@
 
 #include <cstddef>
 #include <mutex>
+#include "../thread/NamedMutex.hpp"
 #include <vector>
 
 class Buffer : public Reader, public Writer
 {
 protected:
 	/// Мютекс защиты буфера ввода
-	mutable std::recursive_mutex _mutex;
+	mutable NamedRecursiveMutex _mutex;
 
 	/// Вектор, контейнер данных буфера
 	std::vector<char> _data;
@@ -0,0 +1,277 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// ChainBuffer.cpp
+
+
+#include "ChainBuffer.hpp"
+#include <algorithm>
+#include <cstring>
+
+ChainBuffer::ChainBuffer()
+: _mutex("ChainBuffer")
+, _size(0)
+{
+}
+
+ChainBuffer::Segment* ChainBuffer::tail()
+{
+	if (_segments.empty() || _segments.back().limit == nullptr)
+	{
+		return nullptr;
+	}
+	return &_segments.back();
+}
+
+size_t ChainBuffer::dataLen() const
+{
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
+	return _size;
+}
+
+const char* ChainBuffer::frontPtr() const
+{
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
+	for (const auto& segment : _segments)
+	{
+		if (segment.end > segment.begin)
+		{
+			return segment.begin;
+		}
+	}
+	return nullptr;
+}
+
+size_t ChainBuffer::frontLen() const
+{
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
+	for (const auto& segment : _segments)
+	{
+		if (segment.end > segment.begin)
+		{
+			return static_cast<size_t>(segment.end - segment.begin);
+		}
+	}
+	return 0;
+}
+
+size_t ChainBuffer::gather(iovec* iov, size_t count) const
+{
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
+
+	size_t n = 0;
+	for (const auto& segment : _segments)
+	{
+		if (n >= count)
+		{
+			break;
+		}
+		if (segment.end == segment.begin)
+		{
+			continue;
+		}
+		iov[n].iov_base = const_cast<char*>(segment.begin);
+		iov[n].iov_len = static_cast<size_t>(segment.end - segment.begin);
+		++n;
+	}
+	return n;
+}
+
+bool ChainBuffer::show(void* data_, size_t length) const
+{
+	if (length == 0)
+	{
+		return true;
+	}
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
+	if (_size < length)
+	{
+		return false;
+	}
+
+	auto data = static_cast<char*>(data_);
+
+	for (const auto& segment : _segments)
+	{
+		auto n = std::min(length, static_cast<size_t>(segment.end - segment.begin));
+		memcpy(data, segment.begin, n);
+		data += n;
+		length -= n;
+		if (length == 0)
+		{
+			break;
+		}
+	}
+	return true;
+}
+
+bool ChainBuffer::skip(size_t length)
+{
+	if (length == 0)
+	{
+		return true;
+	}
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
+	if (_size < length)
+	{
+		return false;
+	}
+
+	_size -= length;
+
+	while (length > 0)
+	{
+		auto& segment = _segments.front();
+		auto n = std::min(length, static_cast<size_t>(segment.end - segment.begin));
+		segment.begin += n;
+		length -= n;
+
+		// Полностью прочитанный сегмент освобождаем (блок возвращается в пул)
+		if (segment.begin == segment.end)
+		{
+			_segments.pop_front();
+		}
+	}
+	return true;
+}
+
+bool ChainBuffer::read(void* data, size_t length)
+{
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
+	return show(data, length) && skip(length);
+}
+
+char* ChainBuffer::spacePtr() const
+{
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
+	auto segment = const_cast<ChainBuffer*>(this)->tail();
+	return segment ? segment->end : nullptr;
+}
+
+size_t ChainBuffer::spaceLen() const
+{
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
+	auto segment = const_cast<ChainBuffer*>(this)->tail();
+	return segment ? static_cast<size_t>(segment->limit - segment->end) : 0;
+}
+
+bool ChainBuffer::prepare(size_t length)
+{
+	if (length == 0)
+	{
+		return true;
+	}
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
+
+	auto segment = tail();
+	if (segment && static_cast<size_t>(segment->limit - segment->end) >= length)
+	{
+		return true;
+	}
+
+	if (length <= Slab::capacity)
+	{
+		auto slab = SlabPtr::make();
+		auto ptr = slab->data();
+		_segments.push_back({std::move(slab), nullptr, ptr, ptr, ptr + Slab::capacity});
+	}
+	else
+	{
+		// Непрерывное пространство больше блока - выделяем отдельно
+		std::shared_ptr<char> holder(new char[length], std::default_delete<char[]>());
+		auto ptr = holder.get();
+		_segments.push_back({SlabPtr(), std::move(holder), ptr, ptr, ptr + length});
+	}
+	return true;
+}
+
+bool ChainBuffer::forward(size_t length)
+{
+	if (length == 0)
+	{
+		return true;
+	}
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
+
+	auto segment = tail();
+	if (!segment || length > static_cast<size_t>(segment->limit - segment->end))
+	{
+		return false;
+	}
+
+	segment->end += length;
+	_size += length;
+	return true;
+}
+
+bool ChainBuffer::write(const void* data_, size_t length)
+{
+	if (length == 0)
+	{
+		return true;
+	}
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
+
+	auto data = static_cast<const char*>(data_);
+
+	while (length > 0)
+	{
+		auto segment = tail();
+		if (!segment || segment->limit == segment->end)
+		{
+			auto slab = SlabPtr::make();
+			auto ptr = slab->data();
+			_segments.push_back({std::move(slab), nullptr, ptr, ptr, ptr + Slab::capacity});
+			segment = &_segments.back();
+		}
+
+		auto n = std::min(length, static_cast<size_t>(segment->limit - segment->end));
+		memcpy(segment->end, data, n);
+		segment->end += n;
+		_size += n;
+		data += n;
+		length -= n;
+	}
+	return true;
+}
+
+void ChainBuffer::append(const SlabPtr& slab, const char* data, size_t length)
+{
+	if (length == 0)
+	{
+		return;
+	}
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
+
+	auto ptr = const_cast<char*>(data);
+	_segments.push_back({slab, nullptr, ptr, ptr + length, nullptr});
+	_size += length;
+}
+
+void ChainBuffer::append(const std::shared_ptr<const void>& holder, const char* data, size_t length)
+{
+	if (length == 0)
+	{
+		return;
+	}
+	std::lock_guard<NamedRecursiveMutex> guard(_mutex);
+
+	auto ptr = const_cast<char*>(data);
+	_segments.push_back({SlabPtr(), holder, ptr, ptr + length, nullptr});
+	_size += length;
+}
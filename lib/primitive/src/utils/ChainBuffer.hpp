@@ -0,0 +1,102 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// ChainBuffer.hpp
+
+
+#pragma once
+
+#include "Slab.hpp"
+#include "Writer.hpp"
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include "../thread/NamedMutex.hpp"
+#include <sys/uio.h>
+
+/// Буфер вывода в виде цепочки сегментов.
+/// Запись копирует данные в блоки пула (Slab) ровно один раз, без переразмещения
+/// уже записанного. Готовые сериализованные данные можно добавить без копирования
+/// (append) - сегмент лишь держит ссылку на их владельца. Для отправки сегменты
+/// собираются в массив iovec (gather) под writev().
+class ChainBuffer : public Writer
+{
+protected:
+	struct Segment
+	{
+		SlabPtr slab;                       // Блок пула (если данные в нем)
+		std::shared_ptr<const void> holder; // Внешний владелец данных (если данные не в блоке)
+		const char* begin;                  // Начало непрочитанных данных
+		char* end;                          // Конец записанных данных
+		char* limit;                        // Граница для дозаписи (nullptr - сегмент только для чтения)
+	};
+
+	/// Мютекс защиты буфера
+	mutable NamedRecursiveMutex _mutex;
+
+	/// Сегменты данных
+	std::deque<Segment> _segments;
+
+	/// Объем непрочитанных данных
+	size_t _size;
+
+	/// Сегмент, доступный для дозаписи, или nullptr
+	Segment* tail();
+
+public:
+	ChainBuffer(const ChainBuffer&) = delete;
+	ChainBuffer& operator=(const ChainBuffer&) = delete;
+	ChainBuffer(ChainBuffer&&) noexcept = delete;
+	ChainBuffer& operator=(ChainBuffer&&) noexcept = delete;
+
+	ChainBuffer();
+	virtual ~ChainBuffer() = default;
+
+	inline auto& mutex()
+	{ return _mutex; }
+
+	size_t dataLen() const;
+
+	/// Первый непрерывный фрагмент данных
+	const char* frontPtr() const;
+	size_t frontLen() const;
+
+	/// Заполнить iovec фрагментами данных, возвращает количество заполненных элементов
+	size_t gather(iovec* iov, size_t count) const;
+
+	bool show(void* data, size_t length) const;
+	bool skip(size_t length);
+	bool read(void* data, size_t length);
+
+	char* spacePtr() const override;
+	size_t spaceLen() const override;
+
+	bool prepare(size_t length) override;
+	bool forward(size_t length) override;
+	bool write(const void* data, size_t length) override;
+
+	using Writer::write;
+
+	/// Добавить данные из блока пула без копирования
+	void append(const SlabPtr& slab, const char* data, size_t length);
+
+	/// Добавить данные внешнего владельца без копирования
+	void append(const std::shared_ptr<const void>& holder, const char* data, size_t length);
+};
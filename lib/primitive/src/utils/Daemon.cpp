@@ -22,6 +22,7 @@
 #include "Daemon.hpp"
 #include "../thread/ThreadPool.hpp"
 #include "../log/LoggerManager.hpp"
+#include "../telemetry/Tracer.hpp"
 
 #include <cxxabi.h>
 #include <climits>
@@ -234,9 +235,14 @@ void Daemon::SignalsHandler(int sig, siginfo_t* info, void* context)
 			case SIGUSR2:
 				log.info("Received signal USR2. Unload stacks and info");
 				log.flush();
+				Tracer::requestDump();
 				needBacktrace = true;
 				goto actions;
 
+			case SIGPROF:
+				// Запоздавший тик профилировщика (см. Profiler)
+				return;
+
 			default:
 				log.debug("Received signal `%s`", sys_siglist[sig]);
 				log.flush();
@@ -0,0 +1,152 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// Slab.cpp
+
+
+#include "Slab.hpp"
+#include <mutex>
+#include <utility>
+#include <vector>
+
+constexpr size_t Slab::capacity;
+
+class SlabPool final
+{
+private:
+	/// Сколько блоков держит у себя каждый поток
+	static const size_t threadCacheCapacity = 64;
+
+	/// Сколько свободных блоков держит общий пул (остальные освобождаются)
+	static const size_t sharedCapacity = 1024;
+
+	std::mutex _mutex;
+	std::vector<Slab*> _free;
+
+	struct ThreadCache final
+	{
+		std::vector<Slab*> slabs;
+
+		~ThreadCache()
+		{
+			// Поток завершается: отдаем свое в общий пул
+			for (auto slab : slabs)
+			{
+				SlabPool::getInstance().putShared(slab);
+			}
+		}
+	};
+
+	static ThreadCache& threadCache()
+	{
+		static thread_local ThreadCache cache;
+		return cache;
+	}
+
+	SlabPool() = default;
+	~SlabPool()
+	{
+		for (auto slab : _free)
+		{
+			delete slab;
+		}
+	}
+
+	void putShared(Slab* slab)
+	{
+		{
+			std::lock_guard<std::mutex> lockGuard(_mutex);
+			if (_free.size() < sharedCapacity)
+			{
+				_free.push_back(slab);
+				return;
+			}
+		}
+		delete slab;
+	}
+
+public:
+	SlabPool(const SlabPool&) = delete;
+	SlabPool& operator=(const SlabPool&) = delete;
+	SlabPool(SlabPool&&) noexcept = delete;
+	SlabPool& operator=(SlabPool&&) noexcept = delete;
+
+	static SlabPool& getInstance()
+	{
+		static SlabPool instance;
+		return instance;
+	}
+
+	Slab* get()
+	{
+		Slab* slab = nullptr;
+
+		auto& cache = threadCache().slabs;
+		if (!cache.empty())
+		{
+			slab = cache.back();
+			cache.pop_back();
+		}
+		else
+		{
+			std::lock_guard<std::mutex> lockGuard(_mutex);
+			if (!_free.empty())
+			{
+				slab = _free.back();
+				_free.pop_back();
+			}
+		}
+
+		if (slab == nullptr)
+		{
+			slab = new Slab();
+		}
+
+		slab->_refs.store(1, std::memory_order_relaxed);
+		return slab;
+	}
+
+	void put(Slab* slab)
+	{
+		auto& cache = threadCache().slabs;
+		if (cache.size() < threadCacheCapacity)
+		{
+			cache.push_back(slab);
+			return;
+		}
+		putShared(slab);
+	}
+};
+
+Slab::Slab()
+: _refs(0)
+{
+}
+
+Slab* Slab::acquire()
+{
+	return SlabPool::getInstance().get();
+}
+
+void Slab::release()
+{
+	if (_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		SlabPool::getInstance().put(this);
+	}
+}
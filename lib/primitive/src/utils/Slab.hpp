@@ -0,0 +1,151 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// Slab.hpp
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/// Блок памяти фиксированного размера для цепочечных буферов ввода-вывода.
+/// Время жизни управляется встроенным счетчиком ссылок, освобожденные блоки
+/// возвращаются в пул: сначала в кеш текущего потока (без блокировок),
+/// при его переполнении - в общий пул.
+class Slab final
+{
+public:
+	static constexpr size_t capacity = 1u<<14; // 16 KB
+
+private:
+	std::atomic<uint32_t> _refs;
+	char _data[capacity];
+
+	Slab();
+	~Slab() = default;
+
+	friend class SlabPool;
+
+public:
+	Slab(const Slab&) = delete;
+	Slab& operator=(const Slab&) = delete;
+	Slab(Slab&&) noexcept = delete;
+	Slab& operator=(Slab&&) noexcept = delete;
+
+	/// Взять блок из пула (счетчик ссылок равен 1)
+	static Slab* acquire();
+
+	inline void addRef()
+	{
+		_refs.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/// Отпустить ссылку; последняя ссылка возвращает блок в пул
+	void release();
+
+	inline bool unique() const
+	{
+		return _refs.load(std::memory_order_acquire) == 1;
+	}
+
+	inline char* data()
+	{
+		return _data;
+	}
+	inline const char* data() const
+	{
+		return _data;
+	}
+};
+
+/// Владеющий указатель на блок (аналог intrusive_ptr)
+class SlabPtr final
+{
+private:
+	Slab* _slab;
+
+public:
+	SlabPtr()
+	: _slab(nullptr)
+	{}
+
+	/// Принимает уже захваченную ссылку (например, из Slab::acquire())
+	explicit SlabPtr(Slab* slab)
+	: _slab(slab)
+	{}
+
+	SlabPtr(const SlabPtr& that)
+	: _slab(that._slab)
+	{
+		if (_slab) _slab->addRef();
+	}
+
+	SlabPtr(SlabPtr&& that) noexcept
+	: _slab(that._slab)
+	{
+		that._slab = nullptr;
+	}
+
+	SlabPtr& operator=(const SlabPtr& that)
+	{
+		if (this != &that)
+		{
+			SlabPtr tmp(that);
+			std::swap(_slab, tmp._slab);
+		}
+		return *this;
+	}
+
+	SlabPtr& operator=(SlabPtr&& that) noexcept
+	{
+		std::swap(_slab, that._slab);
+		return *this;
+	}
+
+	~SlabPtr()
+	{
+		if (_slab) _slab->release();
+	}
+
+	static SlabPtr make()
+	{
+		return SlabPtr(Slab::acquire());
+	}
+
+	void reset()
+	{
+		if (_slab) _slab->release();
+		_slab = nullptr;
+	}
+
+	Slab* get() const
+	{
+		return _slab;
+	}
+	Slab* operator->() const
+	{
+		return _slab;
+	}
+	explicit operator bool() const
+	{
+		return _slab != nullptr;
+	}
+};
@@ -0,0 +1,335 @@
+//  Copyright (c) 2017-2019 Tkeycoin Dao. All rights reserved.
+//  Copyright (c) 2019-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+// logdecode.cpp
+
+
+// Декодер бинарного журнала: печатает записи в том же виде, что и текстовый синк.
+// Использование: logdecode <файл журнала>
+
+#include "../src/log/BinaryLogFormat.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+const char* levelLabel[] = {
+	"TRC",
+	"DEB",
+	"INF",
+	"WRN",
+	"ERR",
+	"CRT"
+};
+
+class Reader final
+{
+private:
+	const std::vector<char>& _data;
+	size_t _pos;
+
+public:
+	explicit Reader(const std::vector<char>& data, size_t pos = 0)
+	: _data(data)
+	, _pos(pos)
+	{}
+
+	bool eof() const
+	{
+		return _pos >= _data.size();
+	}
+
+	size_t position() const
+	{
+		return _pos;
+	}
+
+	template<typename T>
+	bool get(T& value)
+	{
+		if (_data.size() - _pos < sizeof(T))
+		{
+			return false;
+		}
+		memcpy(&value, _data.data() + _pos, sizeof(T));
+		_pos += sizeof(T);
+		return true;
+	}
+
+	bool getString(std::string& value)
+	{
+		uint32_t size;
+		if (!get(size) || _data.size() - _pos < size)
+		{
+			return false;
+		}
+		value.assign(_data.data() + _pos, size);
+		_pos += size;
+		return true;
+	}
+
+	bool getBlock(Reader& block)
+	{
+		uint32_t size;
+		if (!get(size) || _data.size() - _pos < size)
+		{
+			return false;
+		}
+		block._pos = _pos;
+		_pos += size;
+		return true;
+	}
+};
+
+struct Format
+{
+	std::string text;
+	std::vector<BinaryLogFormat::Spec> specs;
+	bool supported;
+};
+
+/// Текст строки формата между спецификаторами ('%%' -> '%')
+void appendLiteral(std::string& out, const std::string& text, size_t from, size_t to)
+{
+	for (auto i = from; i < to; ++i)
+	{
+		out.push_back(text[i]);
+		if (text[i] == '%' && i + 1 < to && text[i + 1] == '%')
+		{
+			++i;
+		}
+	}
+}
+
+std::string render(const Format& format, Reader& args)
+{
+	std::string out;
+	char buff[512];
+	size_t pos = 0;
+
+	for (const auto& spec : format.specs)
+	{
+		appendLiteral(out, format.text, pos, spec.begin);
+		std::string conv = format.text.substr(spec.begin, spec.end - spec.begin);
+		pos = spec.end;
+
+		int n = 0;
+		switch (spec.arg)
+		{
+			case BinaryLogFormat::Arg::STRING:
+			{
+				std::string value;
+				if (!args.getString(value)) return out + "<truncated>";
+				n = snprintf(buff, sizeof(buff), conv.c_str(), value.c_str());
+				if (n >= static_cast<int>(sizeof(buff)))
+				{
+					// Длинная строка: форматируем без ограничения буфера
+					std::vector<char> big(static_cast<size_t>(n) + 1);
+					snprintf(big.data(), big.size(), conv.c_str(), value.c_str());
+					out.append(big.data(), static_cast<size_t>(n));
+					continue;
+				}
+				break;
+			}
+			case BinaryLogFormat::Arg::DOUBLE:
+			{
+				double value;
+				if (!args.get(value)) return out + "<truncated>";
+				n = snprintf(buff, sizeof(buff), conv.c_str(), value);
+				break;
+			}
+			default:
+			{
+				uint64_t value;
+				if (!args.get(value)) return out + "<truncated>";
+				switch (spec.arg)
+				{
+					case BinaryLogFormat::Arg::INT:      n = snprintf(buff, sizeof(buff), conv.c_str(), static_cast<int>(value)); break;
+					case BinaryLogFormat::Arg::LONG:     n = snprintf(buff, sizeof(buff), conv.c_str(), static_cast<long>(value)); break;
+					case BinaryLogFormat::Arg::LONGLONG: n = snprintf(buff, sizeof(buff), conv.c_str(), static_cast<long long>(value)); break;
+					case BinaryLogFormat::Arg::SIZE:     n = snprintf(buff, sizeof(buff), conv.c_str(), static_cast<size_t>(value)); break;
+					case BinaryLogFormat::Arg::POINTER:  n = snprintf(buff, sizeof(buff), conv.c_str(), reinterpret_cast<void*>(static_cast<uintptr_t>(value))); break;
+					default:;
+				}
+			}
+		}
+		if (n > 0)
+		{
+			out.append(buff, std::min(static_cast<size_t>(n), sizeof(buff) - 1));
+		}
+	}
+	appendLiteral(out, format.text, pos, format.text.size());
+
+	return out;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: %s <binary-log-file>\n", argv[0]);
+		return 1;
+	}
+
+	std::ifstream file(argv[1], std::ios::binary);
+	if (!file)
+	{
+		fprintf(stderr, "Can't open file '%s': %s\n", argv[1], strerror(errno));
+		return 1;
+	}
+	std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	if (data.size() < sizeof(BinaryLogFormat::MAGIC) || memcmp(data.data(), BinaryLogFormat::MAGIC, sizeof(BinaryLogFormat::MAGIC)) != 0)
+	{
+		fprintf(stderr, "File '%s' is not a binary log\n", argv[1]);
+		return 1;
+	}
+
+	std::unordered_map<uint32_t, Format> formats;
+	std::unordered_map<uint32_t, std::string> strings;
+
+	// Файл делится на сессии (отметки SESSION): в каждой свои id, поэтому таблицы
+	// определений заводятся для каждой сессии заново
+	size_t begin = sizeof(BinaryLogFormat::MAGIC);
+	while (begin < data.size())
+	{
+		formats.clear();
+		strings.clear();
+
+		size_t end = data.size();
+
+		// Первый проход: определения (могут идти после использующих их записей) и граница сессии
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			Reader reader(data, begin);
+			while (reader.position() < end)
+			{
+				auto position = reader.position();
+
+				BinaryLogFormat::Record type;
+				uint32_t id;
+				if (!reader.get(type) || !reader.get(id))
+				{
+					fprintf(stderr, "Truncated record at end of file\n");
+					return 2;
+				}
+
+				if (type == BinaryLogFormat::Record::SESSION)
+				{
+					uint64_t timestamp;
+					if (!reader.get(timestamp))
+					{
+						fprintf(stderr, "Truncated record at end of file\n");
+						return 2;
+					}
+					if (position != begin)
+					{
+						end = position;
+						break;
+					}
+					continue;
+				}
+
+				if (type == BinaryLogFormat::Record::FORMAT || type == BinaryLogFormat::Record::STRING)
+				{
+					std::string text;
+					if (!reader.getString(text))
+					{
+						fprintf(stderr, "Truncated record at end of file\n");
+						return 2;
+					}
+					if (pass == 0)
+					{
+						if (type == BinaryLogFormat::Record::FORMAT)
+						{
+							auto& format = formats[id];
+							format.text = text;
+							format.supported = BinaryLogFormat::parse(text.c_str(), format.specs);
+						}
+						else
+						{
+							strings[id] = text;
+						}
+					}
+					continue;
+				}
+
+				if (type != BinaryLogFormat::Record::ENTRY)
+				{
+					fprintf(stderr, "Unknown record type %u\n", static_cast<unsigned>(type));
+					return 2;
+				}
+
+				uint64_t timestamp;
+				uint32_t nameId;
+				uint32_t threadId;
+				uint8_t level;
+				Reader args(data);
+				if (!reader.get(timestamp) || !reader.get(nameId) || !reader.get(threadId) || !reader.get(level) || !reader.getBlock(args))
+				{
+					fprintf(stderr, "Truncated record at end of file\n");
+					return 2;
+				}
+				if (pass == 0)
+				{
+					continue;
+				}
+
+				time_t ts = static_cast<time_t>(timestamp / 1'000'000);
+				auto msec = static_cast<unsigned>(timestamp % 1'000'000 / 1000);
+				auto usec = static_cast<unsigned>(timestamp % 1'000);
+				tm tm{};
+				localtime_r(&ts, &tm);
+
+				std::string message;
+				auto f = formats.find(id);
+				if (f == formats.end() || !f->second.supported)
+				{
+					message = "<unknown format #" + std::to_string(id) + ">";
+				}
+				else
+				{
+					message = render(f->second, args);
+				}
+
+				printf("%02u-%02u-%02u %02u:%02u:%02u.%03u'%03u\t%s\t%s\t%s\t%s\n",
+					tm.tm_year%100, tm.tm_mon+1, tm.tm_mday,
+					tm.tm_hour, tm.tm_min, tm.tm_sec,
+					msec, usec,
+					strings[threadId].c_str(), strings[nameId].c_str(),
+					level < sizeof(levelLabel) / sizeof(levelLabel[0]) ? levelLabel[level] : "???",
+					message.c_str()
+				);
+			}
+		}
+
+		begin = end;
+	}
+
+	return 0;
+}
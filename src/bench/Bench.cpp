@@ -0,0 +1,217 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// Bench.cpp
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <vector>
+#include <crypto/sha256.h>
+#include <serialization/JsonSerializer.hpp>
+#include <serialization/SArr.hpp>
+#include <serialization/SObj.hpp>
+#include <serialization/SerializerFactory.hpp>
+#include "Bench.hpp"
+
+namespace
+{
+	std::atomic<uint64_t> allocationCounter{0};
+}
+
+// Allocations are counted by replacing global operator new for the whole executable
+
+void* operator new(size_t size)
+{
+	allocationCounter.fetch_add(1, std::memory_order_relaxed);
+	if (auto ptr = malloc(size ? size : 1))
+	{
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	free(ptr);
+}
+
+namespace bench
+{
+
+uint64_t allocations()
+{
+	return allocationCounter.load(std::memory_order_relaxed);
+}
+
+Bench::Bench(std::string name, Clock::duration minTime, size_t samples)
+: _name(std::move(name))
+, _minTime(minTime)
+, _samples(std::max<size_t>(samples, 1))
+, _bytesPerOp(0)
+, _iterations(0)
+, _nsPerOp(0)
+, _allocsPerOp(0)
+{
+}
+
+void Bench::measure(const std::function<void(uint64_t)>& loop)
+{
+	// Warm-up doubles as calibration: grow count of iterations until one pass lasts minTime
+	uint64_t iterations = 1;
+	for (;;)
+	{
+		auto begin = Clock::now();
+		loop(iterations);
+		auto elapsed = Clock::now() - begin;
+
+		if (elapsed >= _minTime)
+		{
+			break;
+		}
+		if (elapsed < _minTime / 10)
+		{
+			iterations *= 10;
+		}
+		else
+		{
+			auto scale = static_cast<double>(_minTime.count()) / std::max<Clock::rep>(elapsed.count(), 1);
+			iterations = static_cast<uint64_t>(iterations * scale * 1.1) + 1;
+		}
+	}
+
+	std::vector<double> nsPerOp;
+	nsPerOp.reserve(_samples);
+
+	uint64_t allocs = 0;
+	for (size_t sample = 0; sample < _samples; ++sample)
+	{
+		auto allocsBefore = allocations();
+		auto begin = Clock::now();
+		loop(iterations);
+		auto elapsed = Clock::now() - begin;
+		allocs += allocations() - allocsBefore;
+
+		nsPerOp.push_back(
+			static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / iterations
+		);
+	}
+
+	std::sort(nsPerOp.begin(), nsPerOp.end());
+
+	_iterations = iterations;
+	_nsPerOp = nsPerOp[nsPerOp.size() / 2];
+	_allocsPerOp = static_cast<double>(allocs) / (iterations * _samples);
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+	std::string filter;
+	std::chrono::milliseconds minTime(50);
+	size_t samples = 5;
+	std::string sha256;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg.compare(0, 9, "--filter=") == 0)
+		{
+			filter = arg.substr(9);
+		}
+		else if (arg.compare(0, 11, "--min-time=") == 0)
+		{
+			minTime = std::chrono::milliseconds(std::strtoul(arg.c_str() + 11, nullptr, 10));
+		}
+		else if (arg.compare(0, 10, "--samples=") == 0)
+		{
+			samples = std::strtoul(arg.c_str() + 10, nullptr, 10);
+		}
+		else if (arg.compare(0, 9, "--sha256=") == 0)
+		{
+			sha256 = arg.substr(9);
+		}
+		else
+		{
+			std::cerr << "Usage: " << argv[0] << " [--filter=<substring>] [--min-time=<ms per sample>] [--samples=<count>] [--sha256=<implementation>]" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::string backend;
+	try
+	{
+		backend = SHA256AutoDetect(sha256);
+	}
+	catch (const std::exception& exception)
+	{
+		std::cerr << exception.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	SArr results;
+	for (auto& benchmark : bench::Registry::benchmarks())
+	{
+		if (!filter.empty() && benchmark.first.find(filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		bench::Bench bench(benchmark.first, minTime, samples);
+		benchmark.second(bench);
+
+		std::cerr << bench.name() << ": " << bench.nsPerOp() << " ns/op" << std::endl;
+
+		SObj result;
+		result.emplace("name", bench.name());
+		result.emplace("iterations", bench.iterations());
+		result.emplace("ns_per_op", bench.nsPerOp());
+		result.emplace("allocs_per_op", bench.allocsPerOp());
+		if (bench.bytesPerOp())
+		{
+			result.emplace("bytes_per_op", bench.bytesPerOp());
+			result.emplace("bytes_per_sec", bench.bytesPerSec());
+		}
+		results.emplace_back(std::move(result));
+	}
+
+	SObj report;
+	report.emplace("sha256", backend);
+	report.emplace("min_time_ms", minTime.count());
+	report.emplace("samples", samples);
+	report.emplace("benchmarks", std::move(results));
+
+	// Encoder rewinds output, so it can't write into std::cout directly
+	std::cout << SerializerFactory::create("json")->encode(report) << std::endl;
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,134 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// Bench.hpp
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+
+namespace bench
+{
+
+class Bench final
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+private:
+	const std::string _name;
+	const Clock::duration _minTime;
+	const size_t _samples;
+
+	uint64_t _bytesPerOp;
+	uint64_t _iterations;
+	double _nsPerOp;
+	double _allocsPerOp;
+
+	void measure(const std::function<void(uint64_t)>& loop);
+
+public:
+	Bench() = delete; // Default-constructor
+	Bench(Bench&&) noexcept = delete; // Move-constructor
+	Bench(const Bench&) = delete; // Copy-constructor
+	~Bench() = default; // Destructor
+	Bench& operator=(Bench&&) noexcept = delete; // Move-assignment
+	Bench& operator=(Bench const&) = delete; // Copy-assignment
+
+	Bench(std::string name, Clock::duration minTime, size_t samples);
+
+	// Amount of data processed by one operation (used for bytes/s)
+	Bench& bytes(uint64_t bytesPerOp)
+	{
+		_bytesPerOp = bytesPerOp;
+		return *this;
+	}
+
+	// Warms up, calibrates count of iterations so that one sample lasts
+	// at least minTime, and keeps the median of several samples
+	template<typename Op>
+	void run(Op&& op)
+	{
+		measure(
+			[&op](uint64_t iterations)
+			{
+				for (uint64_t i = 0; i < iterations; ++i)
+				{
+					op();
+				}
+			}
+		);
+	}
+
+	const std::string& name() const { return _name; }
+	uint64_t iterations() const { return _iterations; }
+	double nsPerOp() const { return _nsPerOp; }
+	double allocsPerOp() const { return _allocsPerOp; }
+	double bytesPerSec() const { return _nsPerOp > 0 ? _bytesPerOp * 1e9 / _nsPerOp : 0; }
+	uint64_t bytesPerOp() const { return _bytesPerOp; }
+};
+
+// Count of dynamic allocations made by the process so far
+uint64_t allocations();
+
+// Keeps the compiler from dropping computation whose result is unused
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+	asm volatile("" : : "g"(&value) : "memory");
+}
+
+using BenchFunction = void (*)(Bench&);
+
+class Registry final
+{
+public:
+	Registry() = delete; // Default-constructor
+	Registry(Registry&&) noexcept = delete; // Move-constructor
+	Registry(const Registry&) = delete; // Copy-constructor
+	~Registry() = delete; // Destructor
+	Registry& operator=(Registry&&) noexcept = delete; // Move-assignment
+	Registry& operator=(Registry const&) = delete; // Copy-assignment
+
+	static std::map<std::string, BenchFunction>& benchmarks()
+	{
+		static std::map<std::string, BenchFunction> benchmarks;
+		return benchmarks;
+	}
+
+	static bool add(const std::string& name, BenchFunction function)
+	{
+		return benchmarks().emplace(name, function).second;
+	}
+};
+
+}
+
+#define BENCHMARK(Name)                                                         \
+	static void Name(bench::Bench& bench);                                      \
+	[[maybe_unused]] static const bool Name##_registered = bench::Registry::add(#Name, Name); \
+	static void Name(bench::Bench& bench)
@@ -0,0 +1,73 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// base58.cpp
+
+#include <vector>
+#include <other/Base58.hpp>
+#include "Bench.hpp"
+
+BENCHMARK(Base58Encode)
+{
+	std::vector<uint8_t> data{
+		17, 79, 8, 99, 150, 189, 208, 162, 22, 23, 203, 163, 36, 58, 147,
+		227, 139, 2, 215, 100, 91, 38, 11, 141, 253, 40, 117, 21, 16, 90,
+		200, 24
+	};
+	bench.bytes(data.size()).run(
+		[&]
+		{
+			auto encoded = Base58::EncodeBase58(data);
+			bench::doNotOptimize(encoded);
+		}
+	);
+}
+
+BENCHMARK(Base58CheckEncode)
+{
+	std::vector<uint8_t> data{
+		0, 17, 79, 8, 99, 150, 189, 208, 162, 22, 23, 203, 163, 36, 58,
+		147, 227, 139, 2, 215, 100
+	};
+	bench.bytes(data.size()).run(
+		[&]
+		{
+			auto encoded = Base58::EncodeBase58Check(data);
+			bench::doNotOptimize(encoded);
+		}
+	);
+}
+
+BENCHMARK(Base58Decode)
+{
+	const char* address = "17VZNX1SN5NtKa8UQFxwQbFeFc3iqRYhem";
+	std::vector<uint8_t> decoded;
+	bench.run(
+		[&]
+		{
+			decoded.clear();
+			Base58::DecodeBase58(address, decoded);
+			bench::doNotOptimize(decoded);
+		}
+	);
+}
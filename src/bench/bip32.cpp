@@ -0,0 +1,84 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// bip32.cpp
+
+#include <thread>
+#include <crypto/keys/ExtKeyDeriver.hpp>
+#include "Bench.hpp"
+
+namespace
+{
+	const uint32_t H = ExtKeyDeriver::HARDENED;
+
+	CExtKey master()
+	{
+		const uint8_t seed[16] = {1};
+		CExtKey key;
+		key.SetSeed(seed, sizeof(seed));
+		return key;
+	}
+
+	void deriveRange(bench::Bench& bench, size_t threads)
+	{
+		ExtKeyDeriver deriver(master());
+		uint32_t first = 0;
+		bench.run(
+			[&]
+			{
+				auto keys = deriver.deriveRange({44 | H, 0 | H, 0 | H, 0}, first, 1000, threads);
+				first += 1000;
+				bench::doNotOptimize(keys);
+			}
+		);
+	}
+}
+
+// Receive key derived from master step by step, as without cache
+BENCHMARK(BIP32_FromRoot)
+{
+	auto key = master();
+	uint32_t index = 0;
+	bench.run(
+		[&]
+		{
+			CExtKey purpose, coin, account, chain, child;
+			key.Derive(purpose, 44 | H);
+			purpose.Derive(coin, 0 | H);
+			coin.Derive(account, 0 | H);
+			account.Derive(chain, 0);
+			chain.Derive(child, index++);
+			auto pubkey = child.key.GetPubKey();
+			bench::doNotOptimize(pubkey);
+		}
+	);
+}
+
+BENCHMARK(BIP32_Range_1000)
+{
+	deriveRange(bench, 1);
+}
+
+BENCHMARK(BIP32_Range_1000_threads)
+{
+	deriveRange(bench, std::max<size_t>(1, std::thread::hardware_concurrency()));
+}
@@ -0,0 +1,62 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// buffer.cpp
+
+#include <array>
+#include <utils/Buffer.hpp>
+#include <utils/ChainBuffer.hpp>
+#include "Bench.hpp"
+
+namespace
+{
+	// Typical protocol message is written by small header fields and a payload
+	template<class Buf>
+	void writeAndRead(bench::Bench& bench)
+	{
+		Buf buffer;
+		std::array<char, 24> header{};
+		std::array<char, 1000> payload{};
+		std::array<char, 1024> out{};
+
+		bench.bytes(header.size() + payload.size()).run(
+			[&]
+			{
+				buffer.write(header.data(), header.size());
+				buffer.write(payload.data(), payload.size());
+				buffer.read(out.data(), header.size());
+				buffer.read(out.data(), payload.size());
+			}
+		);
+	}
+}
+
+BENCHMARK(BufferWriteRead)
+{
+	writeAndRead<Buffer>(bench);
+}
+
+BENCHMARK(ChainBufferWriteRead)
+{
+	writeAndRead<ChainBuffer>(bench);
+}
@@ -0,0 +1,96 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// chacha20poly1305.cpp
+
+#include <cstring>
+#include <vector>
+#include <crypto/chacha20poly1305.h>
+#include "Bench.hpp"
+
+namespace
+{
+	const uint8_t key[32] = {1};
+	const size_t frameSize = 1 << 16;
+}
+
+BENCHMARK(Memcpy_64K)
+{
+	std::vector<uint8_t> in(frameSize, 0x5a);
+	std::vector<uint8_t> out(frameSize);
+	bench.bytes(in.size()).run(
+		[&]
+		{
+			memcpy(out.data(), in.data(), in.size());
+			bench::doNotOptimize(out);
+		}
+	);
+}
+
+BENCHMARK(ChaCha20_64K)
+{
+	std::vector<uint8_t> data(frameSize, 0x5a);
+	ChaCha20 chacha20(key, sizeof(key));
+	bench.bytes(data.size()).run(
+		[&]
+		{
+			chacha20.Crypt(data.data(), data.data(), data.size());
+		}
+	);
+}
+
+BENCHMARK(Poly1305_64K)
+{
+	std::vector<uint8_t> data(frameSize, 0x5a);
+	uint8_t tag[Poly1305::TAGLEN];
+	bench.bytes(data.size()).run(
+		[&]
+		{
+			Poly1305(key).Update(data.data(), data.size()).Finalize(tag);
+			bench::doNotOptimize(tag);
+		}
+	);
+}
+
+BENCHMARK(ChaCha20Poly1305_64K)
+{
+	std::vector<uint8_t> data(frameSize + FSChaCha20Poly1305::EXPANSION, 0x5a);
+	FSChaCha20Poly1305 aead(key, 224);
+	bench.bytes(frameSize).run(
+		[&]
+		{
+			aead.Encrypt(data.data(), frameSize, nullptr, 0, data.data());
+		}
+	);
+}
+
+BENCHMARK(ChaCha20Poly1305_256b)
+{
+	std::vector<uint8_t> data(256 + FSChaCha20Poly1305::EXPANSION, 0x5a);
+	FSChaCha20Poly1305 aead(key, 224);
+	bench.bytes(256).run(
+		[&]
+		{
+			aead.Encrypt(data.data(), 256, nullptr, 0, data.data());
+		}
+	);
+}
@@ -0,0 +1,139 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// crypto_hash.cpp
+
+#include <vector>
+#include <crypto/sha256.h>
+#include <other/MerkleTree.hpp>
+#include "Bench.hpp"
+
+BENCHMARK(SHA256_32b)
+{
+	std::vector<uint8_t> data(32, 0);
+	bench.bytes(data.size()).run(
+		[&]
+		{
+			CSHA256().Write(data.data(), data.size()).Finalize(data.data());
+		}
+	);
+}
+
+BENCHMARK(SHA256_1M)
+{
+	std::vector<uint8_t> data(1000000, 0);
+	uint8_t hash[CSHA256::OUTPUT_SIZE];
+	bench.bytes(data.size()).run(
+		[&]
+		{
+			CSHA256().Write(data.data(), data.size()).Finalize(hash);
+			bench::doNotOptimize(hash);
+		}
+	);
+}
+
+BENCHMARK(SHA256D64_1024)
+{
+	std::vector<uint8_t> data(64 * 1024, 0);
+	bench.bytes(data.size()).run(
+		[&]
+		{
+			SHA256D64(data.data(), data.data(), 1024);
+		}
+	);
+}
+
+namespace
+{
+	// Messages of typical transaction sizes, 150..400 bytes
+	void sha256dBatch(bench::Bench& bench, bool multi)
+	{
+		std::vector<std::vector<uint8_t>> messages(1000);
+		std::vector<const unsigned char*> inputs;
+		std::vector<size_t> lengths;
+		size_t total = 0;
+		for (size_t i = 0; i < messages.size(); ++i)
+		{
+			messages[i].assign(150 + (i * 37) % 250, static_cast<uint8_t>(i));
+			inputs.push_back(messages[i].data());
+			lengths.push_back(messages[i].size());
+			total += messages[i].size();
+		}
+		std::vector<uint8_t> hashes(32 * messages.size());
+		bench.bytes(total).run(
+			[&]
+			{
+				if (multi)
+				{
+					SHA256DMulti(hashes.data(), inputs.data(), lengths.data(), messages.size());
+				}
+				else
+				{
+					for (size_t i = 0; i < messages.size(); ++i)
+					{
+						uint8_t hash[CSHA256::OUTPUT_SIZE];
+						CSHA256().Write(inputs[i], lengths[i]).Finalize(hash);
+						CSHA256().Write(hash, sizeof(hash)).Finalize(&hashes[32 * i]);
+					}
+				}
+				bench::doNotOptimize(hashes);
+			}
+		);
+	}
+
+	void merkleRoot(bench::Bench& bench, size_t count, size_t threads)
+	{
+		std::vector<uint8_t> leaves(32 * count);
+		for (size_t i = 0; i < leaves.size(); ++i)
+		{
+			leaves[i] = static_cast<uint8_t>(i * 7 + i / 32);
+		}
+		bench.bytes(leaves.size()).run(
+			[&]
+			{
+				auto root = MerkleRoot(leaves, threads);
+				bench::doNotOptimize(root);
+			}
+		);
+	}
+}
+
+BENCHMARK(SHA256D_1000tx)
+{
+	sha256dBatch(bench, false);
+}
+
+BENCHMARK(SHA256D_1000tx_multi)
+{
+	sha256dBatch(bench, true);
+}
+
+BENCHMARK(MerkleRoot_9001)
+{
+	merkleRoot(bench, 9001, 1);
+}
+
+BENCHMARK(MerkleRoot_9001_4threads)
+{
+	merkleRoot(bench, 9001, 4);
+}
@@ -0,0 +1,88 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// json.cpp
+
+#include <serialization/JsonSerializer.hpp>
+#include <serialization/SArr.hpp>
+#include <serialization/SObj.hpp>
+#include <serialization/SerializerFactory.hpp>
+#include "Bench.hpp"
+
+namespace
+{
+	// Looks like the result of RPC 'getpeerinfo' for a few peers
+	SVal samplePeers()
+	{
+		SArr peers;
+		for (int i = 0; i < 8; ++i)
+		{
+			SObj peer;
+			peer.emplace("id", i);
+			peer.emplace("addr", "192.168.0." + std::to_string(i + 10) + ":8299");
+			peer.emplace("subver", "/tkey:2.0.0/");
+			peer.emplace("inbound", (i & 1) != 0);
+			peer.emplace("bytessent", 1234567 + i);
+			peer.emplace("bytesrecv", 7654321 + i);
+			peer.emplace("pingtime", 0.0425 * (i + 1));
+
+			SObj perMsg;
+			perMsg.emplace("inv", 100 * i);
+			perMsg.emplace("tx", 50 * i);
+			perMsg.emplace("headers", 10 * i);
+			peer.emplace("bytessent_per_msg", std::move(perMsg));
+
+			peers.emplace_back(std::move(peer));
+		}
+		return peers;
+	}
+}
+
+BENCHMARK(JsonEncode)
+{
+	auto serializer = SerializerFactory::create("json");
+	auto value = samplePeers();
+	auto size = serializer->encode(value).size();
+
+	bench.bytes(size).run(
+		[&]
+		{
+			auto json = serializer->encode(value);
+			bench::doNotOptimize(json);
+		}
+	);
+}
+
+BENCHMARK(JsonDecode)
+{
+	auto serializer = SerializerFactory::create("json");
+	auto json = serializer->encode(samplePeers());
+
+	bench.bytes(json.size()).run(
+		[&]
+		{
+			auto value = serializer->decode(json);
+			bench::doNotOptimize(value);
+		}
+	);
+}
@@ -0,0 +1,98 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// script.cpp
+
+#include <other/hash.h>
+#include <script/Interpreter.hpp>
+#include "Bench.hpp"
+
+namespace
+{
+	void evalScript(bench::Bench& bench, const Script& script)
+	{
+		BaseSignatureChecker checker;
+		ScriptError error;
+		bench.bytes(script.size()).run(
+			[&]
+			{
+				auto result = Interpreter::EvalScript(script, Flags<ScriptVerifyFlags>{}, checker, SigVersion::BASE, &error);
+				bench::doNotOptimize(result);
+			}
+		);
+	}
+}
+
+// Spending of P2PKH output: signature check itself fails with the base checker,
+// so this measures interpreter overhead plus HASH160 of the public key
+BENCHMARK(EvalScript_P2PKH)
+{
+	std::vector<uint8_t> signature(72, 0x30);
+	std::vector<uint8_t> pubKey(33, 0x02);
+	auto pubKeyHash = Hash160(pubKey);
+
+	Script script;
+	script
+		<< signature
+		<< pubKey
+		<< OpCode::OP_DUP
+		<< OpCode::OP_HASH160
+		<< std::vector<uint8_t>(pubKeyHash.begin(), pubKeyHash.end())
+		<< OpCode::OP_EQUALVERIFY
+		<< OpCode::OP_CHECKSIG;
+
+	evalScript(bench, script);
+}
+
+// Bare 1-of-2 multisig
+BENCHMARK(EvalScript_Multisig)
+{
+	std::vector<uint8_t> signature(72, 0x30);
+	std::vector<uint8_t> pubKey1(33, 0x02);
+	std::vector<uint8_t> pubKey2(33, 0x03);
+
+	Script script;
+	script
+		<< OpCode::OP_0
+		<< signature
+		<< 1
+		<< pubKey1
+		<< pubKey2
+		<< 2
+		<< OpCode::OP_CHECKMULTISIG;
+
+	evalScript(bench, script);
+}
+
+// Arithmetic and stack manipulation without cryptography
+BENCHMARK(EvalScript_Arithmetic)
+{
+	Script script;
+	for (int i = 0; i < 20; ++i)
+	{
+		script << i << OpCode::OP_DUP << OpCode::OP_ADD << OpCode::OP_DROP;
+	}
+	script << 1;
+
+	evalScript(bench, script);
+}
@@ -0,0 +1,79 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// signature.cpp
+
+#include <crypto/keys/CKey.hpp>
+#include <crypto/keys/SignatureVerifier.hpp>
+#include "Bench.hpp"
+
+namespace
+{
+	// 1000 valid signatures made by 10 keys (hot keys, like in consolidation transactions)
+	std::vector<SignatureVerifier::Item> signatures()
+	{
+		std::vector<CKey> keys(10);
+		for (auto& key : keys)
+		{
+			key.MakeNewKey(true);
+		}
+
+		std::vector<SignatureVerifier::Item> items(1000);
+		for (size_t i = 0; i < items.size(); ++i)
+		{
+			auto& key = keys[i % keys.size()];
+			items[i].pubkey = key.GetPubKey();
+			items[i].hash[0] = static_cast<uint8_t>(i);
+			items[i].hash[1] = static_cast<uint8_t>(i >> 8);
+			key.Sign(items[i].hash, items[i].signature);
+		}
+		return items;
+	}
+}
+
+BENCHMARK(EcdsaVerify_1000)
+{
+	auto items = signatures();
+	bench.run(
+		[&]
+		{
+			size_t valid = 0;
+			for (auto& item : items)
+			{
+				valid += item.pubkey.Verify(item.hash, item.signature);
+			}
+			bench::doNotOptimize(valid);
+		}
+	);
+}
+
+BENCHMARK(EcdsaVerifyBatch_1000)
+{
+	auto items = signatures();
+	bench.run(
+		[&]
+		{
+			auto results = SignatureVerifier::verify(items);
+			bench::doNotOptimize(results);
+		}
+	);
+}
@@ -0,0 +1,126 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// transaction.cpp
+
+#include <sstream>
+#include <blockchain/Transaction.hpp>
+#include <other/HashStreams.hpp>
+#include "Bench.hpp"
+
+namespace
+{
+	void append(std::string& out, uint64_t value, size_t size)
+	{
+		for (size_t i = 0; i < size; ++i)
+		{
+			out.push_back(static_cast<char>(value >> (8 * i)));
+		}
+	}
+
+	void appendP2PKH(std::string& out, uint8_t seed)
+	{
+		out.push_back(25);
+		out.append("\x76\xa9\x14", 3);
+		out.append(20, static_cast<char>(seed));
+		out.append("\x88\xac", 2);
+	}
+
+	// Serialized transaction with two P2PKH-like inputs and two P2PKH outputs
+	std::string sampleTransaction()
+	{
+		std::string raw;
+		append(raw, 1, 4); // version
+		raw.push_back(2); // count of inputs
+		for (uint8_t input = 0; input < 2; ++input)
+		{
+			raw.append(32, static_cast<char>(0x10 + input)); // previous tx hash
+			append(raw, input, 4); // previous output index
+			raw.push_back(106); // signature (72) and public key (33) pushes
+			raw.push_back(72);
+			raw.append(72, static_cast<char>(0x30));
+			raw.push_back(33);
+			raw.append(33, static_cast<char>(0x02));
+			append(raw, 0xffffffff, 4); // sequence
+		}
+		raw.push_back(2); // count of outputs
+		append(raw, 5000000000, 8);
+		appendP2PKH(raw, 0x21);
+		append(raw, 1234567, 8);
+		appendP2PKH(raw, 0x42);
+		append(raw, 0, 4); // source chain
+		append(raw, 0, 4); // destination chain
+		append(raw, 0, 4); // lock time
+		return raw;
+	}
+}
+
+BENCHMARK(TransactionUnserialize)
+{
+	auto raw = sampleTransaction();
+	bench.bytes(raw.size()).run(
+		[&]
+		{
+			std::istringstream iss(raw);
+			Transaction tx;
+			tx.Unserialize(iss);
+			bench::doNotOptimize(tx);
+		}
+	);
+}
+
+BENCHMARK(TransactionSerialize)
+{
+	auto raw = sampleTransaction();
+	std::istringstream iss(raw);
+	Transaction tx;
+	tx.Unserialize(iss);
+
+	bench.bytes(raw.size()).run(
+		[&]
+		{
+			std::ostringstream oss;
+			tx.Serialize(oss);
+			bench::doNotOptimize(oss);
+		}
+	);
+}
+
+BENCHMARK(TransactionHash)
+{
+	auto raw = sampleTransaction();
+	std::istringstream iss(raw);
+	Transaction tx;
+	tx.Unserialize(iss);
+
+	// Transaction::hash() caches its result, so the uncached path is measured
+	bench.bytes(raw.size()).run(
+		[&]
+		{
+			Hash256Stream hs;
+			tx.Serialize(hs);
+			auto hash = hs.hash();
+			bench::doNotOptimize(hash);
+		}
+	);
+}
@@ -0,0 +1,111 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// uint256map.cpp
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include <types/Uint256Map.hpp>
+#include "Bench.hpp"
+
+namespace
+{
+	std::vector<uint256> randomKeys(size_t count)
+	{
+		std::mt19937_64 random(42);
+		std::vector<uint256> keys(count);
+		for (auto& key : keys)
+		{
+			for (size_t i = 0; i < key.size(); i += 8)
+			{
+				auto value = random();
+				std::copy_n(reinterpret_cast<const uint8_t*>(&value), 8, key.begin() + i);
+			}
+		}
+		return keys;
+	}
+
+	// 1000 dependent lookups (like walking of chain by prev hashes) in map of 1M entries
+	template<class Map>
+	void lookup(bench::Bench& bench)
+	{
+		auto keys = randomKeys(1000000);
+		Map map;
+		for (size_t i = 0; i < keys.size(); ++i)
+		{
+			map.emplace(keys[i], (i * 7919 + 1) % keys.size());
+		}
+		size_t index = 0;
+		bench.run(
+			[&]
+			{
+				for (size_t i = 0; i < 1000; ++i)
+				{
+					index = map.find(keys[index])->second;
+				}
+				bench::doNotOptimize(index);
+			}
+		);
+	}
+
+	// Insert 1000 keys, then erase them
+	template<class Map>
+	void churn(bench::Bench& bench)
+	{
+		auto keys = randomKeys(1000);
+		Map map;
+		bench.run(
+			[&]
+			{
+				for (size_t i = 0; i < keys.size(); ++i)
+				{
+					map.emplace(keys[i], i);
+				}
+				for (auto& key : keys)
+				{
+					map.erase(key);
+				}
+			}
+		);
+	}
+}
+
+BENCHMARK(UnorderedMapLookup_1M)
+{
+	lookup<std::unordered_map<uint256, size_t>>(bench);
+}
+
+BENCHMARK(Uint256MapLookup_1M)
+{
+	lookup<Uint256Map<size_t>>(bench);
+}
+
+BENCHMARK(UnorderedMapChurn_1000)
+{
+	churn<std::unordered_map<uint256, size_t>>(bench);
+}
+
+BENCHMARK(Uint256MapChurn_1000)
+{
+	churn<Uint256Map<size_t>>(bench);
+}
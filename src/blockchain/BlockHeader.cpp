@@ -25,8 +25,10 @@
 
 #include <serialization/SObj.hpp>
 #include <other/HashStreams.hpp>
+#include <crypto/sha256.h>
 #include "BlockHeader.hpp"
 #include <iomanip>
+#include <sstream>
 
 void BlockHeader::Serialize(std::ostream& os) const
 {
@@ -87,3 +89,123 @@ const uint256& BlockHeader::hash() const
 	}
 	return _hash;
 }
+
+void BlockHeader::computeHashes(const std::vector<std::shared_ptr<BlockHeader>>& headers)
+{
+	// Only header fields are hashed (as in hash()), even if an item is a whole block:
+	// virtual Serialize of Block appends transactions
+	std::ostringstream oss;
+	std::vector<size_t> offsets{0};
+	for (auto& header : headers)
+	{
+		header->BlockHeader::Serialize(oss);
+		offsets.push_back(static_cast<size_t>(oss.tellp()));
+	}
+
+	auto data = oss.str();
+	auto count = headers.size();
+
+	std::vector<const uint8_t*> inputs(count);
+	std::vector<size_t> lengths(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		inputs[i] = reinterpret_cast<const uint8_t*>(data.data()) + offsets[i];
+		lengths[i] = offsets[i + 1] - offsets[i];
+	}
+
+	std::vector<uint8_t> hashes(count * CSHA256::OUTPUT_SIZE);
+	SHA256DMulti(hashes.data(), inputs.data(), lengths.data(), count);
+
+	auto hash = hashes.cbegin();
+	for (auto& header : headers)
+	{
+		std::copy(hash, hash + header->_hash.size(), header->_hash.begin());
+		header->_validHash = true;
+		hash += header->_hash.size();
+	}
+}
+
+uint256 BlockHeader::target(uint32_t bits)
+{
+	uint32_t exponent = bits >> 24;
+	uint32_t mantissa = bits & 0x007fffff;
+
+	if (mantissa == 0)
+	{
+		throw std::runtime_error("Zero target");
+	}
+	if (bits & 0x00800000)
+	{
+		throw std::runtime_error("Negative target");
+	}
+	if (exponent > 34 || (mantissa > 0xff && exponent > 33) || (mantissa > 0xffff && exponent > 32))
+	{
+		throw std::runtime_error("Overflowed target");
+	}
+
+	// value = mantissa * 256^(exponent-3), little-endian
+	uint256 target;
+	if (exponent < 3)
+	{
+		mantissa >>= 8 * (3 - exponent);
+		exponent = 3;
+	}
+	for (size_t i = exponent - 3; i < target.size() && mantissa; ++i, mantissa >>= 8)
+	{
+		target[i] = static_cast<uint8_t>(mantissa);
+	}
+	return target;
+}
+
+bool BlockHeader::checkProofOfWork() const
+{
+	try
+	{
+		return !(target(_bits) < hash());
+	}
+	catch (const std::runtime_error&)
+	{
+		return false;
+	}
+}
+
+void BlockHeader::checkSequence(const std::vector<std::shared_ptr<BlockHeader>>& headers, std::shared_ptr<BlockHeader> prev, size_t height, uint32_t powLimit, size_t retargetInterval)
+{
+	// All hashes at once, in SIMD lanes
+	computeHashes(headers);
+
+	auto limit = target(powLimit);
+
+	for (auto& header : headers)
+	{
+		if (prev && header->prev() != prev->hash())
+		{
+			throw std::runtime_error("Non-continuous headers sequence at " + header->hash().str());
+		}
+
+		auto headerTarget = target(header->bits());
+		if (limit < headerTarget)
+		{
+			throw std::runtime_error("Target of header " + header->hash().str() + " is above limit");
+		}
+		if (headerTarget < header->hash())
+		{
+			throw std::runtime_error("Proof of work of header " + header->hash().str() + " doesn't meet its target");
+		}
+
+		// Retarget rule of this chain is not verified yet, so transitions are checked only if configured
+		if (prev && header->bits() != prev->bits() && retargetInterval != 0)
+		{
+			if (height != -1 && height % retargetInterval != 0)
+			{
+				throw std::runtime_error("Difficulty of header " + header->hash().str() + " is changed out of retarget height");
+			}
+		}
+
+		prev = header;
+		if (height != -1)
+		{
+			++height;
+		}
+	}
+}
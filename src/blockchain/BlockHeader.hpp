@@ -27,6 +27,8 @@
 
 #include <cstdint>
 #include <cassert>
+#include <memory>
+#include <vector>
 
 #include "../types/Blobs.hpp"
 #include "../serialization/Serialization.hpp"
@@ -79,6 +81,33 @@ public:
 	[[nodiscard]]
 	const uint256& hash() const;
 
+	// Computes hashes of all headers in one batched pass (multi-buffer SHA256) and caches them
+	static void computeHashes(const std::vector<std::shared_ptr<BlockHeader>>& headers);
+
+	[[nodiscard]]
+	uint32_t timestamp() const
+	{
+		return _timestamp;
+	}
+
+	[[nodiscard]]
+	uint32_t bits() const
+	{
+		return _bits;
+	}
+
+	// Decodes compact representation of target; throws if it is zero, negative or overflowed
+	[[nodiscard]]
+	static uint256 target(uint32_t bits);
+
+	[[nodiscard]]
+	bool checkProofOfWork() const;
+
+	// Validates headers following `prev` (null if unknown) at `height` (-1 if unknown): continuity,
+	// target not above `powLimit`, proof of work, and difficulty changes only at heights multiple
+	// of `retargetInterval` (0 - at any); throws on first invalid header
+	static void checkSequence(const std::vector<std::shared_ptr<BlockHeader>>& headers, std::shared_ptr<BlockHeader> prev, size_t height, uint32_t powLimit, size_t retargetInterval);
+
 	[[nodiscard]]
 	const uint256& prev() const
 	{
@@ -0,0 +1,162 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// BlockHeader_test.cpp
+
+#include "Block.hpp"
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+TEST(BlockHeader, Target)
+{
+	EXPECT_EQ(BlockHeader::target(0x1d00ffff), uint256("00000000ffff0000000000000000000000000000000000000000000000000000"));
+	EXPECT_EQ(BlockHeader::target(0x1b0404cb), uint256("00000000000404cb000000000000000000000000000000000000000000000000"));
+	EXPECT_EQ(BlockHeader::target(0x03123456), uint256("123456"));
+	EXPECT_EQ(BlockHeader::target(0x02123456), uint256("1234"));
+	EXPECT_EQ(BlockHeader::target(0x22000001), uint256("0100000000000000000000000000000000000000000000000000000000000000"));
+
+	EXPECT_THROW((void)BlockHeader::target(0x1d000000), std::runtime_error); // zero
+	EXPECT_THROW((void)BlockHeader::target(0x1d800001), std::runtime_error); // negative
+	EXPECT_THROW((void)BlockHeader::target(0x23000001), std::runtime_error); // overflow
+	EXPECT_THROW((void)BlockHeader::target(0x22000100), std::runtime_error); // overflow
+}
+
+TEST(BlockHeader, ComputeHashes)
+{
+	std::vector<std::shared_ptr<BlockHeader>> headers;
+	for (int i = 0; i < 10; ++i)
+	{
+		headers.emplace_back(std::make_shared<BlockHeader>());
+	}
+
+	BlockHeader::computeHashes(headers);
+
+	BlockHeader sample;
+	for (auto& header : headers)
+	{
+		EXPECT_EQ(header->hash(), sample.hash());
+	}
+
+	// Hash of empty header is far above any sane target
+	EXPECT_FALSE(sample.checkProofOfWork());
+}
+
+namespace
+{
+	// Header with the first nonce which meets (or, if `valid` is false, misses) target of `bits`
+	std::shared_ptr<BlockHeader> mine(const uint256& prev, uint32_t bits, bool valid = true)
+	{
+		for (uint32_t nonce = 0; ; ++nonce)
+		{
+			std::stringstream ss;
+			::SerializeList(ss, uint32_t(1), prev, uint256(), uint32_t(0), bits, nonce, uint32_t(0));
+
+			auto header = std::make_shared<BlockHeader>();
+			header->Unserialize(ss);
+			if (header->checkProofOfWork() == valid)
+			{
+				return header;
+			}
+		}
+	}
+
+	// Chain from genesis; difficulty of header at `height` is taken from `bits`
+	std::vector<std::shared_ptr<BlockHeader>> mineChain(const std::vector<uint32_t>& bits)
+	{
+		std::vector<std::shared_ptr<BlockHeader>> headers;
+		for (auto b : bits)
+		{
+			headers.emplace_back(mine(headers.empty() ? uint256() : headers.back()->hash(), b));
+		}
+		return headers;
+	}
+
+	const uint32_t powLimit = 0x207fffff;
+}
+
+TEST(BlockHeader, ComputeHashesOfBlocks)
+{
+	auto header = mine(uint256(), powLimit);
+
+	// Block serializes its transactions too, but hash covers header only
+	auto block = std::make_shared<Block>(*header);
+	block->txList() = std::make_shared<std::vector<std::shared_ptr<Transaction>>>();
+
+	std::vector<std::shared_ptr<BlockHeader>> headers{block};
+	BlockHeader::computeHashes(headers);
+
+	EXPECT_EQ(block->hash(), header->hash());
+}
+
+TEST(BlockHeader, CheckSequenceLinking)
+{
+	auto headers = mineChain({powLimit, powLimit, powLimit, powLimit});
+	EXPECT_NO_THROW(BlockHeader::checkSequence(headers, nullptr, 0, powLimit, 0));
+
+	// Continuation of known header
+	std::vector<std::shared_ptr<BlockHeader>> tail(headers.begin() + 1, headers.end());
+	EXPECT_NO_THROW(BlockHeader::checkSequence(tail, headers.front(), 1, powLimit, 0));
+
+	// Gap in sequence
+	std::swap(headers[1], headers[2]);
+	EXPECT_THROW(BlockHeader::checkSequence(headers, nullptr, 0, powLimit, 0), std::runtime_error);
+
+	// Batch doesn't follow given header
+	EXPECT_THROW(BlockHeader::checkSequence(tail, tail.back(), -1, powLimit, 0), std::runtime_error);
+}
+
+TEST(BlockHeader, CheckSequenceTarget)
+{
+	// Target above limit, even if hash meets it
+	auto easy = mineChain({0x2100ffff});
+	EXPECT_THROW(BlockHeader::checkSequence(easy, nullptr, 0, powLimit, 0), std::runtime_error);
+	EXPECT_NO_THROW(BlockHeader::checkSequence(easy, nullptr, 0, 0x2100ffff, 0));
+
+	// Hash doesn't meet own target
+	std::vector<std::shared_ptr<BlockHeader>> weak{mine(uint256(), powLimit, false)};
+	EXPECT_THROW(BlockHeader::checkSequence(weak, nullptr, 0, powLimit, 0), std::runtime_error);
+
+	// Invalid compact target
+	std::vector<std::shared_ptr<BlockHeader>> zero{std::make_shared<BlockHeader>()};
+	EXPECT_THROW(BlockHeader::checkSequence(zero, nullptr, 0, powLimit, 0), std::runtime_error);
+}
+
+TEST(BlockHeader, CheckSequenceRetargetInterval)
+{
+	const uint32_t harder = 0x203fffff;
+
+	// Difficulty changes at height 4, multiple of interval
+	auto headers = mineChain({powLimit, powLimit, powLimit, powLimit, harder, harder});
+	EXPECT_NO_THROW(BlockHeader::checkSequence(headers, nullptr, 0, powLimit, 4));
+
+	// ...but not of this one
+	EXPECT_THROW(BlockHeader::checkSequence(headers, nullptr, 0, powLimit, 3), std::runtime_error);
+
+	// Any height if interval is not configured
+	EXPECT_NO_THROW(BlockHeader::checkSequence(headers, nullptr, 0, powLimit, 0));
+
+	// Unknown height: transition can't be checked
+	std::vector<std::shared_ptr<BlockHeader>> tail(headers.begin() + 3, headers.end());
+	EXPECT_NO_THROW(BlockHeader::checkSequence(tail, headers[2], -1, powLimit, 3));
+	EXPECT_THROW(BlockHeader::checkSequence(tail, headers[2], 3, powLimit, 3), std::runtime_error);
+}
@@ -26,6 +26,7 @@
 #include <serialization/SObj.hpp>
 #include <serialization/SArr.hpp>
 #include <other/HashStreams.hpp>
+#include <other/MerkleTree.hpp>
 #include "Transaction.hpp"
 #include "../serialization/SerializationWrapper.hpp"
 
@@ -114,3 +115,18 @@ const uint256& Transaction::hash() const
 	}
 	return _hash;
 }
+
+std::vector<uint8_t> Transaction::computeHashes(const std::vector<std::shared_ptr<Transaction>>& txs)
+{
+	auto hashes = MerkleLeaves(txs.begin(), txs.end());
+
+	auto hash = hashes.cbegin();
+	for (auto& tx : txs)
+	{
+		std::copy(hash, hash + tx->_hash.size(), tx->_hash.begin());
+		tx->_validHash = true;
+		hash += tx->_hash.size();
+	}
+
+	return hashes;
+}
@@ -27,6 +27,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <optional>
 #include <vector>
 #include "../types/VariableLengthInteger.hpp"
@@ -75,6 +76,10 @@ public:
 	[[nodiscard]]
 	const uint256& hash() const;
 
+	// Computes hashes of all transactions in one batched pass (multi-buffer SHA256)
+	// and caches them; returns them concatenated, i.e. as leaves of merkle tree
+	static std::vector<uint8_t> computeHashes(const std::vector<std::shared_ptr<Transaction>>& txs);
+
 	[[nodiscard]]
 	bool HasWitness() const
 	{
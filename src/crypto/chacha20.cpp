@@ -19,6 +19,92 @@ constexpr static inline uint32_t rotl32(uint32_t v, int c) { return (v << c) | (
   a += b; d = rotl32(d ^ a, 8); \
   c += d; b = rotl32(b ^ c, 7);
 
+#if defined(USE_ASM) && defined(__SSE2__)
+namespace chacha20_sse2
+{
+void Crypt_4way(const uint32_t* input, const unsigned char* m, unsigned char* c);
+}
+#endif
+
+#if defined(ENABLE_AVX2)
+namespace chacha20_avx2
+{
+void Crypt_8way(const uint32_t* input, const unsigned char* m, unsigned char* c);
+}
+#endif
+
+namespace {
+
+/** One block of keystream, XORed with m (unless it is null) into c. */
+void Block(const uint32_t* j, const unsigned char* m, unsigned char* c)
+{
+    uint32_t x[16];
+    memcpy(x, j, sizeof(x));
+    for (int i = 20; i > 0; i -= 2) {
+        QUARTERROUND(x[0], x[4], x[8], x[12])
+        QUARTERROUND(x[1], x[5], x[9], x[13])
+        QUARTERROUND(x[2], x[6], x[10], x[14])
+        QUARTERROUND(x[3], x[7], x[11], x[15])
+        QUARTERROUND(x[0], x[5], x[10], x[15])
+        QUARTERROUND(x[1], x[6], x[11], x[12])
+        QUARTERROUND(x[2], x[7], x[8], x[13])
+        QUARTERROUND(x[3], x[4], x[9], x[14])
+    }
+    for (int i = 0; i < 16; ++i) {
+        uint32_t v = x[i] + j[i];
+        WriteLE32(c + 4 * i, m ? v ^ ReadLE32(m + 4 * i) : v);
+    }
+}
+
+typedef void (*CryptMultiFn)(const uint32_t*, const unsigned char*, unsigned char*);
+
+/** Kernel processing several consecutive blocks at once in SIMD lanes (null if there is none). */
+struct CryptMulti
+{
+    CryptMultiFn fn;
+    size_t blocks;
+};
+
+CryptMulti DetectMulti()
+{
+#if defined(ENABLE_AVX2)
+    if (__builtin_cpu_supports("avx2")) return {chacha20_avx2::Crypt_8way, 8};
+#endif
+#if defined(USE_ASM) && defined(__SSE2__)
+    return {chacha20_sse2::Crypt_4way, 4};
+#else
+    return {nullptr, 0};
+#endif
+}
+
+void Advance(uint32_t* input, uint64_t blocks)
+{
+    uint64_t counter = ((uint64_t)input[13] << 32 | input[12]) + blocks;
+    input[12] = counter;
+    input[13] = counter >> 32;
+}
+
+/** Whole blocks of keystream (XORed with m, unless it is null) from current position, advancing it. */
+void Blocks(uint32_t* input, const unsigned char* m, unsigned char* c, size_t blocks)
+{
+    static const CryptMulti multi = DetectMulti();
+
+    for (; multi.fn && blocks >= multi.blocks; blocks -= multi.blocks) {
+        multi.fn(input, m, c);
+        Advance(input, multi.blocks);
+        if (m) m += 64 * multi.blocks;
+        c += 64 * multi.blocks;
+    }
+    for (; blocks > 0; --blocks) {
+        Block(input, m, c);
+        Advance(input, 1);
+        if (m) m += 64;
+        c += 64;
+    }
+}
+
+} // namespace
+
 static const unsigned char sigma[] = "expand 32-byte k";
 static const unsigned char tau[] = "expand 16-byte k";
 
@@ -74,108 +160,21 @@ void ChaCha20::Seek(uint64_t pos)
 
 void ChaCha20::Output(unsigned char* c, size_t bytes)
 {
-    uint32_t x0, x1, x2, x3, x4, x5, x6, x7, x8, x9, x10, x11, x12, x13, x14, x15;
-    uint32_t j0, j1, j2, j3, j4, j5, j6, j7, j8, j9, j10, j11, j12, j13, j14, j15;
-    unsigned char *ctarget = nullptr;
-    unsigned char tmp[64];
-    unsigned int i;
-
-    if (!bytes) return;
-
-    j0 = input[0];
-    j1 = input[1];
-    j2 = input[2];
-    j3 = input[3];
-    j4 = input[4];
-    j5 = input[5];
-    j6 = input[6];
-    j7 = input[7];
-    j8 = input[8];
-    j9 = input[9];
-    j10 = input[10];
-    j11 = input[11];
-    j12 = input[12];
-    j13 = input[13];
-    j14 = input[14];
-    j15 = input[15];
-
-    for (;;) {
-        if (bytes < 64) {
-            ctarget = c;
-            c = tmp;
-        }
-        x0 = j0;
-        x1 = j1;
-        x2 = j2;
-        x3 = j3;
-        x4 = j4;
-        x5 = j5;
-        x6 = j6;
-        x7 = j7;
-        x8 = j8;
-        x9 = j9;
-        x10 = j10;
-        x11 = j11;
-        x12 = j12;
-        x13 = j13;
-        x14 = j14;
-        x15 = j15;
-        for (i = 20;i > 0;i -= 2) {
-            QUARTERROUND( x0, x4, x8,x12)
-            QUARTERROUND( x1, x5, x9,x13)
-            QUARTERROUND( x2, x6,x10,x14)
-            QUARTERROUND( x3, x7,x11,x15)
-            QUARTERROUND( x0, x5,x10,x15)
-            QUARTERROUND( x1, x6,x11,x12)
-            QUARTERROUND( x2, x7, x8,x13)
-            QUARTERROUND( x3, x4, x9,x14)
-        }
-        x0 += j0;
-        x1 += j1;
-        x2 += j2;
-        x3 += j3;
-        x4 += j4;
-        x5 += j5;
-        x6 += j6;
-        x7 += j7;
-        x8 += j8;
-        x9 += j9;
-        x10 += j10;
-        x11 += j11;
-        x12 += j12;
-        x13 += j13;
-        x14 += j14;
-        x15 += j15;
-
-        ++j12;
-        if (!j12) ++j13;
-
-        WriteLE32(c + 0, x0);
-        WriteLE32(c + 4, x1);
-        WriteLE32(c + 8, x2);
-        WriteLE32(c + 12, x3);
-        WriteLE32(c + 16, x4);
-        WriteLE32(c + 20, x5);
-        WriteLE32(c + 24, x6);
-        WriteLE32(c + 28, x7);
-        WriteLE32(c + 32, x8);
-        WriteLE32(c + 36, x9);
-        WriteLE32(c + 40, x10);
-        WriteLE32(c + 44, x11);
-        WriteLE32(c + 48, x12);
-        WriteLE32(c + 52, x13);
-        WriteLE32(c + 56, x14);
-        WriteLE32(c + 60, x15);
-
-        if (bytes <= 64) {
-            if (bytes < 64) {
-                for (i = 0;i < bytes;++i) ctarget[i] = c[i];
-            }
-            input[12] = j12;
-            input[13] = j13;
-            return;
-        }
-        bytes -= 64;
-        c += 64;
+    Blocks(input, nullptr, c, bytes / 64);
+    if (bytes % 64) {
+        unsigned char tmp[64];
+        Blocks(input, nullptr, tmp, 1);
+        memcpy(c + bytes - bytes % 64, tmp, bytes % 64);
+    }
+}
+
+void ChaCha20::Crypt(const unsigned char* m, unsigned char* c, size_t bytes)
+{
+    Blocks(input, m, c, bytes / 64);
+    if (bytes % 64) {
+        unsigned char tmp[64];
+        Blocks(input, nullptr, tmp, 1);
+        size_t offset = bytes - bytes % 64;
+        for (size_t i = 0; i < bytes % 64; ++i) c[offset + i] = m[offset + i] ^ tmp[i];
     }
 }
@@ -22,6 +22,10 @@ public:
     void SetIV(uint64_t iv);
     void Seek(uint64_t pos);
     void Output(unsigned char* output, size_t bytes);
+
+    /** Encrypt or decrypt: XOR input with keystream into output (they may be the same buffer).
+     *  As with Output, a partially used block of keystream is discarded. */
+    void Crypt(const unsigned char* input, unsigned char* output, size_t bytes);
 };
 
 #endif // BITCOIN_CRYPTO_CHACHA20_H
@@ -0,0 +1,103 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// ChaCha20 for 8 consecutive blocks at once: word i of all blocks is kept in
+// one AVX2 register (lane = block).
+
+#ifdef ENABLE_AVX2
+
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace chacha20_avx2 {
+namespace {
+
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi32(x, y); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+template<int n> __m256i inline Rotl(__m256i x) { return _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - n)); }
+template<> __m256i inline Rotl<16>(__m256i x)
+{
+    return _mm256_shuffle_epi8(x, _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2, 13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2));
+}
+template<> __m256i inline Rotl<8>(__m256i x)
+{
+    return _mm256_shuffle_epi8(x, _mm256_set_epi8(14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3, 14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3));
+}
+
+void inline __attribute__((always_inline)) QuarterRound(__m256i& a, __m256i& b, __m256i& c, __m256i& d)
+{
+    a = Add(a, b); d = Rotl<16>(Xor(d, a));
+    c = Add(c, d); b = Rotl<12>(Xor(b, c));
+    a = Add(a, b); d = Rotl<8>(Xor(d, a));
+    c = Add(c, d); b = Rotl<7>(Xor(b, c));
+}
+
+/** 4x4 transpose in each 128-bit half: words 4k..4k+3 of blocks i (low half) and i + 4 (high half) into r[i]. */
+void inline Transpose(__m256i a, __m256i b, __m256i c, __m256i d, __m256i* r)
+{
+    __m256i t0 = _mm256_unpacklo_epi32(a, b);
+    __m256i t1 = _mm256_unpacklo_epi32(c, d);
+    __m256i t2 = _mm256_unpackhi_epi32(a, b);
+    __m256i t3 = _mm256_unpackhi_epi32(c, d);
+    r[0] = _mm256_unpacklo_epi64(t0, t1);
+    r[1] = _mm256_unpackhi_epi64(t0, t1);
+    r[2] = _mm256_unpacklo_epi64(t2, t3);
+    r[3] = _mm256_unpackhi_epi64(t2, t3);
+}
+
+void inline Write32(const unsigned char* m, unsigned char* c, size_t offset, __m256i v)
+{
+    if (m) v = Xor(v, _mm256_loadu_si256((const __m256i*)(m + offset)));
+    _mm256_storeu_si256((__m256i*)(c + offset), v);
+}
+
+} // namespace
+
+void Crypt_8way(const uint32_t* input, const unsigned char* m, unsigned char* c)
+{
+    __m256i j[16];
+    for (int i = 0; i < 16; ++i) j[i] = _mm256_set1_epi32(input[i]);
+
+    // 64-bit block counter of each lane
+    uint32_t lo[8], hi[8];
+    for (int i = 0; i < 8; ++i) {
+        lo[i] = input[12] + i;
+        hi[i] = input[13] + (lo[i] < input[12]);
+    }
+    j[12] = _mm256_set_epi32(lo[7], lo[6], lo[5], lo[4], lo[3], lo[2], lo[1], lo[0]);
+    j[13] = _mm256_set_epi32(hi[7], hi[6], hi[5], hi[4], hi[3], hi[2], hi[1], hi[0]);
+
+    __m256i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = j[i];
+
+    for (int i = 20; i > 0; i -= 2) {
+        QuarterRound(x[0], x[4], x[8], x[12]);
+        QuarterRound(x[1], x[5], x[9], x[13]);
+        QuarterRound(x[2], x[6], x[10], x[14]);
+        QuarterRound(x[3], x[7], x[11], x[15]);
+        QuarterRound(x[0], x[5], x[10], x[15]);
+        QuarterRound(x[1], x[6], x[11], x[12]);
+        QuarterRound(x[2], x[7], x[8], x[13]);
+        QuarterRound(x[3], x[4], x[9], x[14]);
+    }
+
+    for (int i = 0; i < 16; ++i) x[i] = Add(x[i], j[i]);
+
+    // r[k][i]: words 4k..4k+3 of blocks i and i + 4
+    __m256i r[4][4];
+    for (int k = 0; k < 4; ++k) {
+        Transpose(x[4 * k], x[4 * k + 1], x[4 * k + 2], x[4 * k + 3], r[k]);
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        Write32(m, c, 64 * i, _mm256_permute2x128_si256(r[0][i], r[1][i], 0x20));
+        Write32(m, c, 64 * i + 32, _mm256_permute2x128_si256(r[2][i], r[3][i], 0x20));
+        Write32(m, c, 64 * (i + 4), _mm256_permute2x128_si256(r[0][i], r[1][i], 0x31));
+        Write32(m, c, 64 * (i + 4) + 32, _mm256_permute2x128_si256(r[2][i], r[3][i], 0x31));
+    }
+}
+
+} // namespace chacha20_avx2
+
+#endif
@@ -0,0 +1,89 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// ChaCha20 for 4 consecutive blocks at once: word i of all blocks is kept in
+// one SSE2 register (lane = block), so all four blocks are processed by the
+// same instructions.
+
+#if defined(USE_ASM) && defined(__SSE2__)
+
+#include <stdint.h>
+#include <emmintrin.h>
+
+namespace chacha20_sse2 {
+namespace {
+
+__m128i inline Add(__m128i x, __m128i y) { return _mm_add_epi32(x, y); }
+__m128i inline Xor(__m128i x, __m128i y) { return _mm_xor_si128(x, y); }
+template<int n> __m128i inline Rotl(__m128i x) { return _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - n)); }
+template<> __m128i inline Rotl<16>(__m128i x) { return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xb1), 0xb1); }
+
+void inline __attribute__((always_inline)) QuarterRound(__m128i& a, __m128i& b, __m128i& c, __m128i& d)
+{
+    a = Add(a, b); d = Rotl<16>(Xor(d, a));
+    c = Add(c, d); b = Rotl<12>(Xor(b, c));
+    a = Add(a, b); d = Rotl<8>(Xor(d, a));
+    c = Add(c, d); b = Rotl<7>(Xor(b, c));
+}
+
+/** Words 4k..4k+3 of four blocks (one register per word) into output of each block. */
+void inline Write4(const unsigned char* m, unsigned char* c, int k, __m128i a, __m128i b, __m128i x, __m128i d)
+{
+    __m128i t0 = _mm_unpacklo_epi32(a, b);
+    __m128i t1 = _mm_unpacklo_epi32(x, d);
+    __m128i t2 = _mm_unpackhi_epi32(a, b);
+    __m128i t3 = _mm_unpackhi_epi32(x, d);
+    __m128i r[4] = {
+        _mm_unpacklo_epi64(t0, t1),
+        _mm_unpackhi_epi64(t0, t1),
+        _mm_unpacklo_epi64(t2, t3),
+        _mm_unpackhi_epi64(t2, t3),
+    };
+    for (int i = 0; i < 4; ++i) {
+        unsigned char* out = c + 64 * i + 16 * k;
+        if (m) r[i] = Xor(r[i], _mm_loadu_si128((const __m128i*)(m + 64 * i + 16 * k)));
+        _mm_storeu_si128((__m128i*)out, r[i]);
+    }
+}
+
+} // namespace
+
+void Crypt_4way(const uint32_t* input, const unsigned char* m, unsigned char* c)
+{
+    __m128i j[16];
+    for (int i = 0; i < 16; ++i) j[i] = _mm_set1_epi32(input[i]);
+
+    // 64-bit block counter of each lane
+    uint32_t lo[4], hi[4];
+    for (int i = 0; i < 4; ++i) {
+        lo[i] = input[12] + i;
+        hi[i] = input[13] + (lo[i] < input[12]);
+    }
+    j[12] = _mm_set_epi32(lo[3], lo[2], lo[1], lo[0]);
+    j[13] = _mm_set_epi32(hi[3], hi[2], hi[1], hi[0]);
+
+    __m128i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = j[i];
+
+    for (int i = 20; i > 0; i -= 2) {
+        QuarterRound(x[0], x[4], x[8], x[12]);
+        QuarterRound(x[1], x[5], x[9], x[13]);
+        QuarterRound(x[2], x[6], x[10], x[14]);
+        QuarterRound(x[3], x[7], x[11], x[15]);
+        QuarterRound(x[0], x[5], x[10], x[15]);
+        QuarterRound(x[1], x[6], x[11], x[12]);
+        QuarterRound(x[2], x[7], x[8], x[13]);
+        QuarterRound(x[3], x[4], x[9], x[14]);
+    }
+
+    for (int i = 0; i < 16; ++i) x[i] = Add(x[i], j[i]);
+
+    for (int k = 0; k < 4; ++k) {
+        Write4(m, c, k, x[4 * k], x[4 * k + 1], x[4 * k + 2], x[4 * k + 3]);
+    }
+}
+
+} // namespace chacha20_sse2
+
+#endif
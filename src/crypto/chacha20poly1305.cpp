@@ -0,0 +1,177 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <crypto/common.h>
+#include <crypto/chacha20poly1305.h>
+
+#include <string.h>
+
+namespace {
+
+/** Poly1305 key comes from block 0 of the keystream for the nonce; payload uses the following blocks. */
+void SetNonce(ChaCha20& chacha20, AEADChaCha20Poly1305::Nonce96 nonce, uint32_t block)
+{
+    chacha20.SetIV(nonce.second);
+    chacha20.Seek((uint64_t)nonce.first << 32 | block);
+}
+
+void ComputeTag(ChaCha20& chacha20, const unsigned char* aad, size_t aadlen,
+                const unsigned char* cipher, size_t cipherlen, unsigned char* tag)
+{
+    static const unsigned char PADDING[16] = {0};
+
+    unsigned char first_block[64];
+    chacha20.Output(first_block, sizeof(first_block));
+
+    Poly1305 poly1305(first_block);
+    poly1305.Update(aad, aadlen).Update(PADDING, (16 - aadlen % 16) % 16);
+    poly1305.Update(cipher, cipherlen).Update(PADDING, (16 - cipherlen % 16) % 16);
+
+    unsigned char lengths[16];
+    WriteLE64(lengths + 0, aadlen);
+    WriteLE64(lengths + 8, cipherlen);
+    poly1305.Update(lengths, sizeof(lengths));
+    poly1305.Finalize(tag);
+
+    memset(first_block, 0, sizeof(first_block));
+}
+
+/** Compare without leaking the position of the first difference. */
+bool TagEqual(const unsigned char* a, const unsigned char* b, size_t len)
+{
+    unsigned char diff = 0;
+    for (size_t i = 0; i < len; ++i) diff |= a[i] ^ b[i];
+    return diff == 0;
+}
+
+} // namespace
+
+AEADChaCha20Poly1305::AEADChaCha20Poly1305(const unsigned char key[KEYLEN])
+    : m_chacha20(key, KEYLEN)
+{
+}
+
+void AEADChaCha20Poly1305::SetKey(const unsigned char key[KEYLEN])
+{
+    m_chacha20.SetKey(key, KEYLEN);
+}
+
+void AEADChaCha20Poly1305::Encrypt(const unsigned char* plain, size_t plainlen, const unsigned char* aad, size_t aadlen,
+                                   Nonce96 nonce, unsigned char* cipher)
+{
+    SetNonce(m_chacha20, nonce, 1);
+    m_chacha20.Crypt(plain, cipher, plainlen);
+
+    SetNonce(m_chacha20, nonce, 0);
+    ComputeTag(m_chacha20, aad, aadlen, cipher, plainlen, cipher + plainlen);
+}
+
+bool AEADChaCha20Poly1305::Decrypt(const unsigned char* cipher, size_t cipherlen, const unsigned char* aad, size_t aadlen,
+                                   Nonce96 nonce, unsigned char* plain)
+{
+    if (cipherlen < EXPANSION) return false;
+    size_t plainlen = cipherlen - EXPANSION;
+
+    unsigned char tag[EXPANSION];
+    SetNonce(m_chacha20, nonce, 0);
+    ComputeTag(m_chacha20, aad, aadlen, cipher, plainlen, tag);
+    if (!TagEqual(tag, cipher + plainlen, EXPANSION)) return false;
+
+    SetNonce(m_chacha20, nonce, 1);
+    m_chacha20.Crypt(cipher, plain, plainlen);
+    return true;
+}
+
+void AEADChaCha20Poly1305::Keystream(Nonce96 nonce, unsigned char* output, size_t bytes)
+{
+    SetNonce(m_chacha20, nonce, 1);
+    m_chacha20.Output(output, bytes);
+}
+
+FSChaCha20::FSChaCha20(const unsigned char key[KEYLEN], uint32_t rekey_interval)
+    : m_chacha20(key, KEYLEN)
+    , m_rekey_interval(rekey_interval)
+{
+    Start();
+}
+
+FSChaCha20::~FSChaCha20()
+{
+    memset(m_buffer, 0, sizeof(m_buffer));
+}
+
+void FSChaCha20::Start()
+{
+    m_chacha20.SetIV(m_rekey_counter);
+    m_chacha20.Seek(0);
+    m_buffer_pos = sizeof(m_buffer);
+}
+
+void FSChaCha20::Crypt(const unsigned char* input, unsigned char* output, size_t bytes)
+{
+    while (bytes > 0) {
+        if (m_buffer_pos == sizeof(m_buffer)) {
+            m_chacha20.Output(m_buffer, sizeof(m_buffer));
+            m_buffer_pos = 0;
+        }
+        size_t n = sizeof(m_buffer) - m_buffer_pos;
+        if (n > bytes) n = bytes;
+        for (size_t i = 0; i < n; ++i) output[i] = input[i] ^ m_buffer[m_buffer_pos + i];
+        m_buffer_pos += n;
+        input += n;
+        output += n;
+        bytes -= n;
+    }
+
+    if (++m_chunk_counter == m_rekey_interval) {
+        // New key is the next 32 bytes of keystream
+        unsigned char new_key[KEYLEN];
+        for (size_t i = 0; i < KEYLEN; ++i) {
+            if (m_buffer_pos == sizeof(m_buffer)) {
+                m_chacha20.Output(m_buffer, sizeof(m_buffer));
+                m_buffer_pos = 0;
+            }
+            new_key[i] = m_buffer[m_buffer_pos++];
+        }
+        m_chacha20.SetKey(new_key, KEYLEN);
+        memset(new_key, 0, sizeof(new_key));
+        m_chunk_counter = 0;
+        ++m_rekey_counter;
+        Start();
+    }
+}
+
+FSChaCha20Poly1305::FSChaCha20Poly1305(const unsigned char key[KEYLEN], uint32_t rekey_interval)
+    : m_aead(key)
+    , m_rekey_interval(rekey_interval)
+{
+}
+
+void FSChaCha20Poly1305::NextPacket()
+{
+    if (++m_packet_counter == m_rekey_interval) {
+        // New key is the keystream for a nonce no packet uses
+        unsigned char new_key[KEYLEN];
+        m_aead.Keystream({0xFFFFFFFF, m_rekey_counter}, new_key, sizeof(new_key));
+        m_aead.SetKey(new_key);
+        memset(new_key, 0, sizeof(new_key));
+        m_packet_counter = 0;
+        ++m_rekey_counter;
+    }
+}
+
+void FSChaCha20Poly1305::Encrypt(const unsigned char* plain, size_t plainlen, const unsigned char* aad, size_t aadlen,
+                                 unsigned char* cipher)
+{
+    m_aead.Encrypt(plain, plainlen, aad, aadlen, {m_packet_counter, m_rekey_counter}, cipher);
+    NextPacket();
+}
+
+bool FSChaCha20Poly1305::Decrypt(const unsigned char* cipher, size_t cipherlen, const unsigned char* aad, size_t aadlen,
+                                 unsigned char* plain)
+{
+    bool ok = m_aead.Decrypt(cipher, cipherlen, aad, aadlen, {m_packet_counter, m_rekey_counter}, plain);
+    NextPacket();
+    return ok;
+}
@@ -0,0 +1,98 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_CRYPTO_CHACHA20POLY1305_H
+#define BITCOIN_CRYPTO_CHACHA20POLY1305_H
+
+#include <crypto/chacha20.h>
+#include <crypto/poly1305.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/** The AEAD_CHACHA20_POLY1305 authenticated encryption algorithm from RFC 8439 section 2.8. */
+class AEADChaCha20Poly1305
+{
+private:
+    ChaCha20 m_chacha20;
+
+public:
+    static const size_t KEYLEN = 32;
+    static const size_t EXPANSION = Poly1305::TAGLEN;
+
+    /** 96-bit nonce: 32-bit prefix and 64-bit little-endian counter part. */
+    struct Nonce96
+    {
+        uint32_t first;
+        uint64_t second;
+    };
+
+    explicit AEADChaCha20Poly1305(const unsigned char key[KEYLEN]);
+    void SetKey(const unsigned char key[KEYLEN]);
+
+    /** Encrypt plain (may be the same buffer as cipher) into cipher, followed by EXPANSION bytes of tag. */
+    void Encrypt(const unsigned char* plain, size_t plainlen, const unsigned char* aad, size_t aadlen,
+                 Nonce96 nonce, unsigned char* cipher);
+
+    /** Check the tag of cipher (cipherlen includes it) and decrypt it into plain. False on mismatch. */
+    bool Decrypt(const unsigned char* cipher, size_t cipherlen, const unsigned char* aad, size_t aadlen,
+                 Nonce96 nonce, unsigned char* plain);
+
+    /** Keystream for a nonce, starting after the block that keys Poly1305. */
+    void Keystream(Nonce96 nonce, unsigned char* output, size_t bytes);
+};
+
+/** ChaCha20 with a continuous keystream across messages, rekeyed every rekey_interval messages.
+ *  Used to hide packet lengths (BIP324 style). */
+class FSChaCha20
+{
+private:
+    ChaCha20 m_chacha20;
+    const uint32_t m_rekey_interval;
+    uint32_t m_chunk_counter = 0;
+    uint64_t m_rekey_counter = 0;
+    unsigned char m_buffer[64];
+    size_t m_buffer_pos = sizeof(m_buffer);
+
+    void Start();
+
+public:
+    static const size_t KEYLEN = 32;
+
+    FSChaCha20(const unsigned char key[KEYLEN], uint32_t rekey_interval);
+    FSChaCha20(const FSChaCha20&) = delete;
+    FSChaCha20& operator=(const FSChaCha20&) = delete;
+    ~FSChaCha20();
+
+    /** Encrypt or decrypt one message (in-place allowed). */
+    void Crypt(const unsigned char* input, unsigned char* output, size_t bytes);
+};
+
+/** AEADChaCha20Poly1305 with an implicit packet counter nonce, rekeyed every rekey_interval packets
+ *  from its own keystream (BIP324 style forward secrecy). */
+class FSChaCha20Poly1305
+{
+private:
+    AEADChaCha20Poly1305 m_aead;
+    const uint32_t m_rekey_interval;
+    uint32_t m_packet_counter = 0;
+    uint64_t m_rekey_counter = 0;
+
+    void NextPacket();
+
+public:
+    static const size_t KEYLEN = AEADChaCha20Poly1305::KEYLEN;
+    static const size_t EXPANSION = AEADChaCha20Poly1305::EXPANSION;
+
+    FSChaCha20Poly1305(const unsigned char key[KEYLEN], uint32_t rekey_interval);
+
+    void Encrypt(const unsigned char* plain, size_t plainlen, const unsigned char* aad, size_t aadlen,
+                 unsigned char* cipher);
+
+    /** Returns false on tag mismatch; the packet is still counted, as the peer counted it too. */
+    bool Decrypt(const unsigned char* cipher, size_t cipherlen, const unsigned char* aad, size_t aadlen,
+                 unsigned char* plain);
+};
+
+#endif // BITCOIN_CRYPTO_CHACHA20POLY1305_H
@@ -0,0 +1,181 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// chacha20poly1305_test.cpp
+
+#include "chacha20poly1305.h"
+
+#include <gtest/gtest.h>
+#include <util/Hex.hpp>
+
+namespace
+{
+	const std::string sunscreen =
+		"Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it.";
+}
+
+TEST(ChaCha20, Implementations)
+{
+	std::vector<uint8_t> key(32);
+	for (size_t i = 0; i < key.size(); ++i)
+	{
+		key[i] = static_cast<uint8_t>(i);
+	}
+
+	// RFC 8439 2.4.2: key 00..1f, nonce 000000000000004a00000000, counter 1
+	std::vector<uint8_t> data(sunscreen.begin(), sunscreen.end());
+	ChaCha20 chacha20(key.data(), key.size());
+	chacha20.SetIV(0x4a000000);
+	chacha20.Seek(1);
+	chacha20.Crypt(data.data(), data.data(), data.size());
+	EXPECT_EQ(data, Hex::Parse(
+		"6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0bf91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d807ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab77937365af90bbf74a35be6b40b8eedf2785e42874d"
+	));
+
+	// Keystream made in SIMD lanes must match the one made block by block,
+	// from any counter, including crossing of 32-bit word
+	for (uint64_t start : {uint64_t(0), uint64_t(5), uint64_t(0xfffffffd)})
+	{
+		std::vector<uint8_t> bulk(64 * 37);
+		chacha20.SetIV(0x0102030405060708);
+		chacha20.Seek(start);
+		chacha20.Output(bulk.data(), bulk.size());
+
+		std::vector<uint8_t> blocks(bulk.size());
+		chacha20.Seek(start);
+		for (size_t i = 0; i < blocks.size(); i += 64)
+		{
+			chacha20.Output(&blocks[i], 64);
+		}
+		EXPECT_EQ(bulk, blocks) << "start " << start;
+
+		std::vector<uint8_t> message(bulk.size() - 11);
+		for (size_t i = 0; i < message.size(); ++i)
+		{
+			message[i] = static_cast<uint8_t>(i * 13);
+		}
+		std::vector<uint8_t> encrypted(message.size());
+		chacha20.Seek(start);
+		chacha20.Crypt(message.data(), encrypted.data(), message.size());
+		for (size_t i = 0; i < message.size(); ++i)
+		{
+			ASSERT_EQ(encrypted[i], message[i] ^ bulk[i]) << "start " << start << ", byte " << i;
+		}
+	}
+}
+
+TEST(Poly1305, works)
+{
+	// RFC 8439 2.5.2
+	auto key = Hex::Parse("85d6be7857556d337f4452fe42d506a80103808afb0db2fd4abff6af4149f51b");
+	std::string message = "Cryptographic Forum Research Group";
+	uint8_t tag[Poly1305::TAGLEN];
+
+	Poly1305(key.data()).Update(reinterpret_cast<const uint8_t*>(message.data()), message.size()).Finalize(tag);
+	EXPECT_EQ(std::vector<uint8_t>(tag, tag + sizeof(tag)), Hex::Parse("a8061dc1305136c6c22b8baf0c0127a9"));
+
+	// Same in uneven pieces
+	Poly1305 poly1305(key.data());
+	for (size_t i = 0; i < message.size(); i += 7)
+	{
+		poly1305.Update(reinterpret_cast<const uint8_t*>(message.data()) + i, std::min<size_t>(7, message.size() - i));
+	}
+	poly1305.Finalize(tag);
+	EXPECT_EQ(std::vector<uint8_t>(tag, tag + sizeof(tag)), Hex::Parse("a8061dc1305136c6c22b8baf0c0127a9"));
+}
+
+TEST(ChaCha20Poly1305, works)
+{
+	// RFC 8439 2.8.2
+	auto key = Hex::Parse("808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f");
+	auto aad = Hex::Parse("50515253c0c1c2c3c4c5c6c7");
+	AEADChaCha20Poly1305::Nonce96 nonce{7, 0x4746454443424140};
+
+	std::vector<uint8_t> data(sunscreen.begin(), sunscreen.end());
+	data.resize(data.size() + AEADChaCha20Poly1305::EXPANSION);
+
+	AEADChaCha20Poly1305 aead(key.data());
+	aead.Encrypt(data.data(), sunscreen.size(), aad.data(), aad.size(), nonce, data.data());
+	EXPECT_EQ(data, Hex::Parse(
+		"d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d63dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b3692ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc3ff4def08e4b7a9de576d26586cec64b6116"
+		"1ae10b594f09e26a7e902ecbd0600691"
+	));
+
+	std::vector<uint8_t> plain(sunscreen.size());
+	ASSERT_TRUE(aead.Decrypt(data.data(), data.size(), aad.data(), aad.size(), nonce, plain.data()));
+	EXPECT_EQ(std::string(plain.begin(), plain.end()), sunscreen);
+
+	// Any change of ciphertext, tag, aad or nonce is detected
+	data[3] ^= 1;
+	EXPECT_FALSE(aead.Decrypt(data.data(), data.size(), aad.data(), aad.size(), nonce, plain.data()));
+	data[3] ^= 1;
+	data.back() ^= 0x80;
+	EXPECT_FALSE(aead.Decrypt(data.data(), data.size(), aad.data(), aad.size(), nonce, plain.data()));
+	data.back() ^= 0x80;
+	EXPECT_FALSE(aead.Decrypt(data.data(), data.size(), aad.data(), aad.size() - 1, nonce, plain.data()));
+	EXPECT_FALSE(aead.Decrypt(data.data(), data.size(), aad.data(), aad.size(), {8, nonce.second}, plain.data()));
+	EXPECT_FALSE(aead.Decrypt(data.data(), AEADChaCha20Poly1305::EXPANSION - 1, nullptr, 0, nonce, plain.data()));
+	EXPECT_TRUE(aead.Decrypt(data.data(), data.size(), aad.data(), aad.size(), nonce, plain.data()));
+}
+
+TEST(ChaCha20Poly1305, Rekey)
+{
+	const uint8_t key[32] = {};
+	FSChaCha20Poly1305 sender(key, 224);
+	FSChaCha20Poly1305 receiver(key, 224);
+	FSChaCha20 senderLength(key, 224);
+	FSChaCha20 receiverLength(key, 224);
+
+	// Reference values computed independently over several rekeyings
+	std::vector<uint8_t> cipher;
+	std::vector<uint8_t> length(3);
+	for (size_t i = 0; i < 1000; ++i)
+	{
+		std::vector<uint8_t> message(i % 50, static_cast<uint8_t>(i));
+		uint8_t aad[2] = {static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)};
+
+		cipher.resize(message.size() + FSChaCha20Poly1305::EXPANSION);
+		sender.Encrypt(message.data(), message.size(), aad, sizeof(aad), cipher.data());
+
+		std::vector<uint8_t> plain(message.size());
+		ASSERT_TRUE(receiver.Decrypt(cipher.data(), cipher.size(), aad, sizeof(aad), plain.data())) << "packet " << i;
+		ASSERT_EQ(plain, message) << "packet " << i;
+
+		length = {static_cast<uint8_t>(i), 1, 2};
+		senderLength.Crypt(length.data(), length.data(), length.size());
+		std::vector<uint8_t> decrypted(3);
+		receiverLength.Crypt(length.data(), decrypted.data(), decrypted.size());
+		ASSERT_EQ(decrypted, std::vector<uint8_t>({static_cast<uint8_t>(i), 1, 2})) << "packet " << i;
+	}
+	EXPECT_EQ(cipher, Hex::Parse(
+		"c5e252ae0869ea21ecf1d3c8e499a6bb1b3431f6f2d51f1e00b2d9a5c6ce3e38ea7fb1a8360d1ab9e9e2cb5e3c490ee534b92cc3dafa858f614d97e62a1b123824"
+	));
+	EXPECT_EQ(length, Hex::Parse("bad0ed"));
+
+	// Packets swapped in order are both rejected
+	cipher.assign(FSChaCha20Poly1305::EXPANSION, 0);
+	sender.Encrypt(nullptr, 0, nullptr, 0, cipher.data());
+	auto skipped = cipher;
+	sender.Encrypt(nullptr, 0, nullptr, 0, cipher.data());
+	EXPECT_FALSE(receiver.Decrypt(cipher.data(), cipher.size(), nullptr, 0, nullptr));
+	EXPECT_FALSE(receiver.Decrypt(skipped.data(), skipped.size(), nullptr, 0, nullptr));
+}
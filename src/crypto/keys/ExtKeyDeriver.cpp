@@ -0,0 +1,242 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// ExtKeyDeriver.cpp
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include "ExtKeyDeriver.hpp"
+#include "EclipticCurveContext.hpp"
+
+namespace
+{
+	// CPubKey is movable only
+	CExtPubKey copy(const CExtPubKey& key)
+	{
+		CExtPubKey ret;
+		ret.nDepth = key.nDepth;
+		memcpy(&ret.vchFingerprint[0], &key.vchFingerprint[0], 4);
+		ret.nChild = key.nChild;
+		ret.chaincode = key.chaincode;
+		ret.pubkey.Set(key.pubkey.begin(), key.pubkey.end());
+		return ret;
+	}
+}
+
+ExtKeyDeriver::Node::Node(CExtPubKey&& pub_, std::optional<CExtKey> priv_)
+: pub(std::move(pub_))
+, priv(std::move(priv_))
+, point()
+, hmac(pub.chaincode.begin(), pub.chaincode.size())
+{
+	if (pub.pubkey.size() != CPubKey::COMPRESSED_PUBLIC_KEY_SIZE)
+	{
+		throw std::runtime_error("Extended public key must be compressed");
+	}
+
+	auto context = ECCVerifyHandle::secp256k1_context_verify();
+	if (!secp256k1_ec_pubkey_parse(context.get(), &point, pub.pubkey.begin(), pub.pubkey.size()))
+	{
+		throw std::runtime_error("Invalid extended public key");
+	}
+
+	// Same data as BIP32Hash() writes before index: header byte and X coordinate
+	hmac.Write(pub.pubkey.begin(), CPubKey::COMPRESSED_PUBLIC_KEY_SIZE);
+}
+
+bool ExtKeyDeriver::Node::derivePubKey(const secp256k1_context* context, uint32_t index, CPubKey& pubkey, ChainCode& chaincode) const
+{
+	unsigned char num[4];
+	num[0] = (index >> 24u) & 0xFFu;
+	num[1] = (index >> 16u) & 0xFFu;
+	num[2] = (index >>  8u) & 0xFFu;
+	num[3] = (index >>  0u) & 0xFFu;
+
+	unsigned char out[64];
+	CHMAC_SHA512(hmac).Write(num, sizeof(num)).Finalize(out);
+	memcpy(chaincode.begin(), out + 32, 32);
+
+	auto child = point;
+	if (!secp256k1_ec_pubkey_tweak_add(context, &child, out))
+	{
+		return false;
+	}
+
+	unsigned char pub[CPubKey::COMPRESSED_PUBLIC_KEY_SIZE];
+	size_t publen = sizeof(pub);
+	secp256k1_ec_pubkey_serialize(context, pub, &publen, &child, SECP256K1_EC_COMPRESSED);
+	pubkey.Set(pub, pub + publen);
+	return true;
+}
+
+std::shared_ptr<const ExtKeyDeriver::Node> ExtKeyDeriver::Node::child(uint32_t index) const
+{
+	if (priv)
+	{
+		CExtKey out;
+		if (!priv->Derive(out, index))
+		{
+			throw std::runtime_error("Invalid child key " + std::to_string(index));
+		}
+		return std::make_shared<const Node>(out.Neuter(), out);
+	}
+
+	if (index & HARDENED)
+	{
+		throw std::runtime_error("Hardened derivation needs private key");
+	}
+
+	CExtPubKey out;
+	out.nDepth = pub.nDepth + 1;
+	CKeyID id = pub.pubkey.GetID();
+	memcpy(&out.vchFingerprint[0], id.data(), 4);
+	out.nChild = index;
+
+	auto context = ECCVerifyHandle::secp256k1_context_verify();
+	if (!derivePubKey(context.get(), index, out.pubkey, out.chaincode))
+	{
+		throw std::runtime_error("Invalid child key " + std::to_string(index));
+	}
+	return std::make_shared<const Node>(std::move(out), std::nullopt);
+}
+
+ExtKeyDeriver::ExtKeyDeriver(const CExtKey& root)
+: _root(std::make_shared<const Node>(root.Neuter(), root))
+{
+}
+
+ExtKeyDeriver::ExtKeyDeriver(const CExtPubKey& root)
+: _root(std::make_shared<const Node>(copy(root), std::nullopt))
+{
+}
+
+std::shared_ptr<const ExtKeyDeriver::Node> ExtKeyDeriver::node(const Path& path)
+{
+	std::lock_guard<NamedMutex> lockGuard(_mutex);
+
+	// Longest cached prefix of path
+	auto length = path.size();
+	std::shared_ptr<const Node> current;
+	for (; length > 0; --length)
+	{
+		auto i = _cache.find(Path(path.begin(), path.begin() + length));
+		if (i != _cache.end())
+		{
+			current = i->second;
+			break;
+		}
+	}
+	if (!current)
+	{
+		current = _root;
+	}
+
+	for (; length < path.size(); ++length)
+	{
+		current = current->child(path[length]);
+
+		if (_cache.size() >= CACHE_CAPACITY)
+		{
+			_cache.clear();
+		}
+		_cache.emplace(Path(path.begin(), path.begin() + length + 1), current);
+	}
+
+	return current;
+}
+
+CExtPubKey ExtKeyDeriver::derivePub(const Path& path)
+{
+	return copy(node(path)->pub);
+}
+
+CExtKey ExtKeyDeriver::derivePriv(const Path& path)
+{
+	auto key = node(path);
+	if (!key->priv)
+	{
+		throw std::runtime_error("No private key for derivation");
+	}
+	return *key->priv;
+}
+
+std::vector<CPubKey> ExtKeyDeriver::deriveRange(const Path& path, uint32_t first, size_t count, size_t threads)
+{
+	if (count > 0 && uint64_t(first) + count > HARDENED)
+	{
+		throw std::runtime_error("Range of keys reaches hardened indices");
+	}
+
+	auto parent = node(path);
+	auto context_sp = ECCVerifyHandle::secp256k1_context_verify();
+	auto context = context_sp.get();
+
+	std::vector<CPubKey> pubkeys(count);
+	std::atomic<bool> invalid{false};
+
+	auto worker = [&](size_t begin, size_t end)
+	{
+		ChainCode chaincode;
+		for (auto i = begin; i < end; ++i)
+		{
+			if (!parent->derivePubKey(context, first + static_cast<uint32_t>(i), pubkeys[i], chaincode))
+			{
+				invalid = true;
+			}
+		}
+	};
+
+	if (threads > 1 && count >= threads * KEYS_PER_THREAD)
+	{
+		const size_t chunk = (count + threads - 1) / threads;
+
+		std::vector<std::thread> pool;
+		pool.reserve(threads - 1);
+		for (size_t i = 1; i < threads; ++i)
+		{
+			pool.emplace_back(worker, i * chunk, std::min(count, (i + 1) * chunk));
+		}
+		worker(0, chunk);
+		for (auto& thread : pool)
+		{
+			thread.join();
+		}
+	}
+	else
+	{
+		worker(0, count);
+	}
+
+	if (invalid)
+	{
+		throw std::runtime_error("Invalid child key in range");
+	}
+
+	return pubkeys;
+}
+
+size_t ExtKeyDeriver::cacheSize() const
+{
+	std::lock_guard<NamedMutex> lockGuard(_mutex);
+	return _cache.size();
+}
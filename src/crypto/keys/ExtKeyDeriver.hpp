@@ -0,0 +1,97 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// ExtKeyDeriver.hpp
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <secp256k1.h>
+#include <crypto/hmac_sha512.h>
+#include <thread/NamedMutex.hpp>
+#include "CExtKey.hpp"
+
+// Derives BIP32 keys below one root. Extended keys of derived paths are cached with their parsed points
+// and HMAC-SHA512 keyed by chain code and fed with public key, so a key of account like m/44'/0'/0'/0
+// is derived once, and each receive key below it costs one HMAC-SHA512 block and one point addition.
+class ExtKeyDeriver final
+{
+public:
+	using Path = std::vector<uint32_t>;
+
+	static constexpr uint32_t HARDENED = 0x80000000;
+
+	// Ranges smaller than this many keys per thread are derived by the calling thread only
+	static constexpr size_t KEYS_PER_THREAD = 256;
+
+	// Count of cached extended keys; cache is cleared when it is full
+	static constexpr size_t CACHE_CAPACITY = 4096;
+
+	ExtKeyDeriver() = delete; // Default-constructor
+	ExtKeyDeriver(ExtKeyDeriver&&) noexcept = delete; // Move-constructor
+	ExtKeyDeriver(const ExtKeyDeriver&) = delete; // Copy-constructor
+	~ExtKeyDeriver() = default; // Destructor
+	ExtKeyDeriver& operator=(ExtKeyDeriver&&) noexcept = delete; // Move-assignment
+	ExtKeyDeriver& operator=(ExtKeyDeriver const&) = delete; // Copy-assignment
+
+	explicit ExtKeyDeriver(const CExtKey& root);
+
+	// Public derivation only: hardened steps are impossible
+	explicit ExtKeyDeriver(const CExtPubKey& root);
+
+	// Extended public key at path (relative to root)
+	CExtPubKey derivePub(const Path& path);
+
+	// Extended private key at path (relative to root)
+	CExtKey derivePriv(const Path& path);
+
+	// Public keys of non-hardened children [first, first + count) of key at path
+	std::vector<CPubKey> deriveRange(const Path& path, uint32_t first, size_t count, size_t threads = 1);
+
+	[[nodiscard]]
+	size_t cacheSize() const;
+
+private:
+	struct Node
+	{
+		CExtPubKey pub;
+		std::optional<CExtKey> priv;
+		secp256k1_pubkey point;
+		CHMAC_SHA512 hmac; // prefix of BIP32Hash of non-hardened children
+
+		Node(CExtPubKey&& pub, std::optional<CExtKey> priv);
+
+		// Public key of non-hardened child; false for invalid one (probability lower than 1 in 2^127)
+		bool derivePubKey(const secp256k1_context* context, uint32_t index, CPubKey& pubkey, ChainCode& chaincode) const;
+
+		std::shared_ptr<const Node> child(uint32_t index) const;
+	};
+
+	mutable NamedMutex _mutex{"ExtKeyDeriver"};
+	std::shared_ptr<const Node> _root;
+	std::map<Path, std::shared_ptr<const Node>> _cache;
+
+	std::shared_ptr<const Node> node(const Path& path);
+};
@@ -0,0 +1,107 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// ExtKeyDeriver_test.cpp
+
+#include "ExtKeyDeriver.hpp"
+
+#include <gtest/gtest.h>
+#include <util/Hex.hpp>
+
+namespace
+{
+	const uint32_t H = ExtKeyDeriver::HARDENED;
+
+	std::vector<uint8_t> bytes(const CPubKey& pubkey)
+	{
+		return std::vector<uint8_t>(pubkey.begin(), pubkey.end());
+	}
+
+	CExtKey root()
+	{
+		// BIP32 test vector 1
+		auto seed = Hex::Parse("000102030405060708090a0b0c0d0e0f");
+		CExtKey key;
+		key.SetSeed(seed.data(), seed.size());
+		return key;
+	}
+}
+
+TEST(ExtKeyDeriver, TestVector)
+{
+	ExtKeyDeriver deriver(root());
+
+	auto key = deriver.derivePub({0 | H, 1});
+	EXPECT_EQ(bytes(key.pubkey), Hex::Parse("03501e454bf00751f24b1b489aa925215d66af2234e3891c3b21a52bedb3cd711c"));
+	EXPECT_EQ(std::vector<uint8_t>(key.chaincode.begin(), key.chaincode.end()), Hex::Parse("2a7857631386ba23dacac34180dd1983734e444fdbf774041578e9b6adb37c19"));
+
+	key = deriver.derivePub({0 | H, 1, 2 | H, 2, 1000000000});
+	EXPECT_EQ(bytes(key.pubkey), Hex::Parse("022a471424da5e657499d1ff51cb43c47481a03b1e77f951fe64cec9f5a48f7011"));
+	EXPECT_EQ(key.nDepth, 5);
+	EXPECT_EQ(key.nChild, 1000000000u);
+
+	// Intermediate keys are cached
+	EXPECT_EQ(deriver.cacheSize(), 5u);
+
+	// Public derivation below last hardened step gives the same
+	ExtKeyDeriver neutered(deriver.derivePub({0 | H, 1, 2 | H}));
+	auto range = neutered.deriveRange({2}, 1000000000, 1);
+	ASSERT_EQ(range.size(), 1u);
+	EXPECT_EQ(bytes(range[0]), bytes(key.pubkey));
+
+	EXPECT_THROW(neutered.derivePub({0 | H}), std::runtime_error);
+	EXPECT_THROW(neutered.derivePriv({}), std::runtime_error);
+}
+
+TEST(ExtKeyDeriver, Range)
+{
+	auto master = root();
+	ExtKeyDeriver deriver(master);
+
+	// Same as step by step derivation
+	CExtKey account;
+	CExtKey change;
+	ASSERT_TRUE(master.Derive(account, 44 | H));
+	ASSERT_TRUE(account.Derive(change, 0));
+	auto parent = change.Neuter();
+
+	for (size_t threads : {size_t(1), size_t(4)})
+	{
+		auto keys = deriver.deriveRange({44 | H, 0}, 5, 1100, threads);
+		ASSERT_EQ(keys.size(), 1100u);
+		for (size_t i = 0; i < keys.size(); i += 97)
+		{
+			CExtPubKey child;
+			ASSERT_TRUE(parent.Derive(child, 5 + i));
+			EXPECT_EQ(bytes(keys[i]), bytes(child.pubkey)) << "child " << i << ", threads " << threads;
+		}
+		CExtPubKey last;
+		ASSERT_TRUE(parent.Derive(last, 5 + 1099));
+		EXPECT_EQ(bytes(keys.back()), bytes(last.pubkey)) << "threads " << threads;
+	}
+
+	auto priv = deriver.derivePriv({44 | H, 0});
+	EXPECT_TRUE(priv == change);
+
+	EXPECT_TRUE(deriver.deriveRange({}, 0, 0).empty());
+	EXPECT_THROW(deriver.deriveRange({}, H - 1, 2), std::runtime_error);
+}
@@ -0,0 +1,233 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// SignatureVerifier.cpp
+
+#include <algorithm>
+#include <tuple>
+#include <lax_der_parsing.h>
+#include "SignatureVerifier.hpp"
+#include "EclipticCurveContext.hpp"
+
+SignatureVerifier::~SignatureVerifier()
+{
+	{
+		std::lock_guard<NamedMutex> lockGuard(_mutex);
+		_stop = true;
+	}
+	_wakeup.notify_all();
+
+	for (auto& thread : _threads)
+	{
+		if (thread.joinable())
+		{
+			thread.join();
+		}
+	}
+}
+
+void SignatureVerifier::init(size_t threads)
+{
+	auto& self = getInstance();
+
+	std::lock_guard<NamedMutex> lockGuard(self._mutex);
+	self.start(threads);
+}
+
+void SignatureVerifier::start(size_t threads)
+{
+	if (_started)
+	{
+		return;
+	}
+	_started = true;
+
+	for (size_t i = 0; i < threads; ++i)
+	{
+		_threads.emplace_back([this]{ run(); });
+	}
+}
+
+size_t SignatureVerifier::threads()
+{
+	auto& self = getInstance();
+
+	std::lock_guard<NamedMutex> lockGuard(self._mutex);
+	return self._threads.size();
+}
+
+std::vector<bool> SignatureVerifier::verify(const std::vector<Item>& items)
+{
+	auto& self = getInstance();
+
+	auto batch = std::make_shared<Batch>(items);
+
+	// Pool is worth to wake only if there are chunks for it
+	if (items.size() > CHUNK)
+	{
+		{
+			std::lock_guard<NamedMutex> lockGuard(self._mutex);
+			self.start(std::max<size_t>(std::thread::hardware_concurrency(), 1) - 1);
+			self._batches.push_back(batch);
+		}
+		self._wakeup.notify_all();
+	}
+
+	self.process(*batch);
+
+	// Wait for chunks claimed by pool, and drop batch from queue if it's still there
+	{
+		std::unique_lock<NamedMutex> lock(self._mutex);
+		self._finished.wait(lock, [&]{ return batch->done.load() == batch->count; });
+
+		auto i = std::find(self._batches.begin(), self._batches.end(), batch);
+		if (i != self._batches.end())
+		{
+			self._batches.erase(i);
+		}
+	}
+
+	return std::vector<bool>(batch->results.begin(), batch->results.end());
+}
+
+void SignatureVerifier::run()
+{
+	std::unique_lock<NamedMutex> lock(_mutex);
+	for (;;)
+	{
+		_wakeup.wait(lock, [this]{ return _stop || !_batches.empty(); });
+		if (_stop)
+		{
+			return;
+		}
+
+		auto batch = _batches.front();
+
+		lock.unlock();
+		process(*batch);
+		lock.lock();
+
+		// All chunks of batch are claimed already
+		if (!_batches.empty() && _batches.front() == batch)
+		{
+			_batches.pop_front();
+		}
+	}
+}
+
+void SignatureVerifier::process(Batch& batch)
+{
+	auto context = ECCVerifyHandle::secp256k1_context_verify();
+
+	for (;;)
+	{
+		auto begin = batch.next.fetch_add(CHUNK);
+		if (begin >= batch.count)
+		{
+			return;
+		}
+		auto end = std::min(begin + CHUNK, batch.count);
+
+		for (auto i = begin; i < end; ++i)
+		{
+			batch.results[i] = verifyOne(context.get(), batch.items[i]);
+		}
+
+		if (batch.done.fetch_add(end - begin) + (end - begin) == batch.count)
+		{
+			// Under lock, so submitter can't miss notification between check and wait
+			std::lock_guard<NamedMutex> lockGuard(_mutex);
+			_finished.notify_all();
+		}
+	}
+}
+
+bool SignatureVerifier::verifyOne(const secp256k1_context* context, const Item& item)
+{
+	if (!item.pubkey.IsValid())
+	{
+		return false;
+	}
+
+	secp256k1_pubkey pubkey;
+	if (!parsePubKey(context, item.pubkey, pubkey))
+	{
+		return false;
+	}
+
+	secp256k1_ecdsa_signature sig;
+	if (!ecdsa_signature_parse_der_lax(context, &sig, item.signature.data(), item.signature.size()))
+	{
+		return false;
+	}
+	/* libsecp256k1's ECDSA verification requires lower-S signatures, which have
+	 * not historically been enforced in Bitcoin, so normalize them first. */
+	secp256k1_ecdsa_signature_normalize(context, &sig, &sig);
+	return secp256k1_ecdsa_verify(context, &sig, item.hash.data(), &pubkey);
+}
+
+bool SignatureVerifier::parsePubKey(const secp256k1_context* context, const CPubKey& key, secp256k1_pubkey& pubkey)
+{
+	// Shard by byte of X coordinate
+	auto& shard = _cache[key[1] % CACHE_SHARDS];
+
+	{
+		std::lock_guard<NamedMutex> lockGuard(shard.mutex);
+		auto i = shard.index.find(key);
+		if (i != shard.index.end())
+		{
+			shard.lru.splice(shard.lru.begin(), shard.lru, i->second);
+			pubkey = i->second->second;
+			_cacheHits.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+	_cacheMisses.fetch_add(1, std::memory_order_relaxed);
+
+	// Parsing of compressed key (square root) is done out of lock
+	if (!secp256k1_ec_pubkey_parse(context, &pubkey, key.data(), key.size()))
+	{
+		return false;
+	}
+
+	std::lock_guard<NamedMutex> lockGuard(shard.mutex);
+	if (shard.index.find(key) == shard.index.end())
+	{
+		// CPubKey isn't copyable, so cache keeps own instances made of same bytes
+		shard.lru.emplace_front(
+			std::piecewise_construct,
+			std::forward_as_tuple(key.data(), key.data() + key.size()),
+			std::forward_as_tuple(pubkey)
+		);
+		shard.index.emplace(
+			std::piecewise_construct,
+			std::forward_as_tuple(key.data(), key.data() + key.size()),
+			std::forward_as_tuple(shard.lru.begin())
+		);
+		if (shard.lru.size() > CACHE_CAPACITY / CACHE_SHARDS)
+		{
+			shard.index.erase(shard.lru.back().first);
+			shard.lru.pop_back();
+		}
+	}
+	return true;
+}
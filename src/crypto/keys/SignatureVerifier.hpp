@@ -0,0 +1,135 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// SignatureVerifier.hpp
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <secp256k1.h>
+#include <thread/NamedMutex.hpp>
+#include <types/Blobs.hpp>
+#include "CPubKey.hpp"
+
+// Verifies batches of ECDSA signatures on dedicated pool of threads.
+// Thread submitting batch verifies it too, so small batches don't wait for pool
+// and pool of zero threads is valid. Parsed public keys are kept in LRU cache.
+class SignatureVerifier final
+{
+public:
+	struct Item
+	{
+		CPubKey pubkey;
+		std::vector<uint8_t> signature; // DER (lax), without sighash type
+		uint256 hash;
+	};
+
+	SignatureVerifier(SignatureVerifier&&) noexcept = delete; // Move-constructor
+	SignatureVerifier(const SignatureVerifier&) = delete; // Copy-constructor
+	SignatureVerifier& operator=(SignatureVerifier&&) noexcept = delete; // Move-assignment
+	SignatureVerifier& operator=(SignatureVerifier const&) = delete; // Copy-assignment
+
+private:
+	SignatureVerifier() = default; // Default-constructor
+	~SignatureVerifier(); // Destructor
+
+	static SignatureVerifier& getInstance()
+	{
+		static SignatureVerifier instance;
+		return instance;
+	}
+
+	static constexpr size_t CHUNK = 8; // items claimed by thread at once
+	static constexpr size_t CACHE_SHARDS = 16;
+	static constexpr size_t CACHE_CAPACITY = 4096; // public keys, in all shards
+
+	struct Batch
+	{
+		const Item* items;
+		size_t count;
+		std::vector<uint8_t> results;
+		std::atomic<size_t> next{0};
+		std::atomic<size_t> done{0};
+
+		explicit Batch(const std::vector<Item>& items)
+		: items(items.data())
+		, count(items.size())
+		, results(items.size(), 0)
+		{
+		}
+	};
+
+	struct CacheShard
+	{
+		NamedMutex mutex{"SignatureVerifier::cache"};
+		std::list<std::pair<CPubKey, secp256k1_pubkey>> lru; // most recently used first
+		std::map<CPubKey, decltype(lru)::iterator> index;
+	};
+
+	NamedMutex _mutex{"SignatureVerifier::batches"};
+	std::condition_variable_any _wakeup;
+	std::condition_variable_any _finished;
+	std::deque<std::shared_ptr<Batch>> _batches;
+	std::vector<std::thread> _threads;
+	bool _started = false;
+	bool _stop = false;
+
+	CacheShard _cache[CACHE_SHARDS];
+	std::atomic<uint64_t> _cacheHits{0};
+	std::atomic<uint64_t> _cacheMisses{0};
+
+	void start(size_t threads);
+	void run();
+	void process(Batch& batch);
+	bool verifyOne(const secp256k1_context* context, const Item& item);
+	bool parsePubKey(const secp256k1_context* context, const CPubKey& key, secp256k1_pubkey& pubkey);
+
+public:
+	// Starts pool of given number of threads; otherwise it's started by first batch
+	// with one thread less than hardware concurrency
+	static void init(size_t threads);
+
+	// Verifies all items (like CPubKey::Verify) and returns result of each one
+	static std::vector<bool> verify(const std::vector<Item>& items);
+
+	[[nodiscard]]
+	static size_t threads();
+
+	[[nodiscard]]
+	static uint64_t cacheHits()
+	{
+		return getInstance()._cacheHits.load(std::memory_order_relaxed);
+	}
+
+	[[nodiscard]]
+	static uint64_t cacheMisses()
+	{
+		return getInstance()._cacheMisses.load(std::memory_order_relaxed);
+	}
+};
@@ -0,0 +1,84 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// SignatureVerifier_test.cpp
+
+#include "SignatureVerifier.hpp"
+#include "CKey.hpp"
+
+#include <gtest/gtest.h>
+
+TEST(SignatureVerifier, Batch)
+{
+	// Pool is used even on single-core machine
+	SignatureVerifier::init(3);
+
+	std::vector<CKey> keys(3);
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		keys[i].MakeNewKey(i != 0);
+	}
+
+	std::vector<SignatureVerifier::Item> items;
+	std::vector<bool> expected;
+	for (size_t i = 0; i < 100; ++i)
+	{
+		auto& key = keys[i % keys.size()];
+
+		SignatureVerifier::Item item;
+		item.pubkey = key.GetPubKey();
+		item.hash[0] = static_cast<uint8_t>(i);
+		item.hash[1] = 1;
+		EXPECT_TRUE(key.Sign(item.hash, item.signature));
+
+		bool valid = true;
+		switch (i % 5)
+		{
+			case 1: // Wrong message
+				item.hash[1] = 2;
+				valid = false;
+				break;
+			case 2: // Broken signature
+				item.signature.back() ^= 1;
+				valid = false;
+				break;
+			case 3: // Key of another signer
+				item.pubkey = keys[(i + 1) % keys.size()].GetPubKey();
+				valid = false;
+				break;
+		}
+		EXPECT_EQ(item.pubkey.Verify(item.hash, item.signature), valid);
+
+		items.emplace_back(std::move(item));
+		expected.push_back(valid);
+	}
+
+	auto misses = SignatureVerifier::cacheMisses();
+
+	EXPECT_EQ(SignatureVerifier::verify(items), expected);
+	EXPECT_EQ(SignatureVerifier::verify({}), std::vector<bool>());
+
+	// Three keys are parsed only once
+	EXPECT_LE(SignatureVerifier::cacheMisses() - misses, keys.size() * 2);
+	EXPECT_EQ(SignatureVerifier::verify(items), expected);
+	EXPECT_LE(SignatureVerifier::cacheMisses() - misses, keys.size() * 2);
+}
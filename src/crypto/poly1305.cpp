@@ -0,0 +1,150 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+// Based on the public domain implementation 'poly1305-donna-64' by Andrew Moon:
+// accumulator and key in three 44/44/42-bit limbs, products in 128-bit integers.
+
+#include <crypto/common.h>
+#include <crypto/poly1305.h>
+
+#include <string.h>
+
+namespace {
+
+typedef unsigned __int128 uint128_t;
+
+const uint64_t MASK44 = 0xfffffffffff;
+const uint64_t MASK42 = 0x3ffffffffff;
+
+} // namespace
+
+Poly1305::Poly1305(const unsigned char key[KEYLEN])
+{
+    // r &= 0xffffffc0ffffffc0ffffffc0fffffff
+    uint64_t t0 = ReadLE64(key + 0);
+    uint64_t t1 = ReadLE64(key + 8);
+    r[0] = t0 & 0xffc0fffffff;
+    r[1] = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffff;
+    r[2] = (t1 >> 24) & 0x00ffffffc0f;
+
+    h[0] = h[1] = h[2] = 0;
+
+    pad[0] = ReadLE64(key + 16);
+    pad[1] = ReadLE64(key + 24);
+
+    leftover = 0;
+}
+
+void Poly1305::Blocks(const unsigned char* m, size_t bytes, bool final)
+{
+    const uint64_t hibit = final ? 0 : (uint64_t(1) << 40); // 1 << 128
+    const uint64_t r0 = r[0], r1 = r[1], r2 = r[2];
+    const uint64_t s1 = r1 * (5 << 2), s2 = r2 * (5 << 2);
+    uint64_t h0 = h[0], h1 = h[1], h2 = h[2];
+
+    while (bytes >= 16) {
+        // h += m[i]
+        uint64_t t0 = ReadLE64(m + 0);
+        uint64_t t1 = ReadLE64(m + 8);
+        h0 += t0 & MASK44;
+        h1 += ((t0 >> 44) | (t1 << 20)) & MASK44;
+        h2 += ((t1 >> 24) & MASK42) | hibit;
+
+        // h *= r
+        uint128_t d0 = (uint128_t)h0 * r0 + (uint128_t)h1 * s2 + (uint128_t)h2 * s1;
+        uint128_t d1 = (uint128_t)h0 * r1 + (uint128_t)h1 * r0 + (uint128_t)h2 * s2;
+        uint128_t d2 = (uint128_t)h0 * r2 + (uint128_t)h1 * r1 + (uint128_t)h2 * r0;
+
+        // (partial) h %= p
+        uint64_t c = (uint64_t)(d0 >> 44); h0 = (uint64_t)d0 & MASK44;
+        d1 += c; c = (uint64_t)(d1 >> 44); h1 = (uint64_t)d1 & MASK44;
+        d2 += c; c = (uint64_t)(d2 >> 42); h2 = (uint64_t)d2 & MASK42;
+        h0 += c * 5; c = h0 >> 44; h0 &= MASK44;
+        h1 += c;
+
+        m += 16;
+        bytes -= 16;
+    }
+
+    h[0] = h0;
+    h[1] = h1;
+    h[2] = h2;
+}
+
+Poly1305& Poly1305::Update(const unsigned char* data, size_t len)
+{
+    if (leftover) {
+        size_t want = 16 - leftover;
+        if (want > len) want = len;
+        memcpy(buffer + leftover, data, want);
+        len -= want;
+        data += want;
+        leftover += want;
+        if (leftover < 16) return *this;
+        Blocks(buffer, 16, false);
+        leftover = 0;
+    }
+
+    if (len >= 16) {
+        size_t want = len & ~size_t(15);
+        Blocks(data, want, false);
+        data += want;
+        len -= want;
+    }
+
+    if (len) {
+        memcpy(buffer, data, len);
+        leftover = len;
+    }
+    return *this;
+}
+
+void Poly1305::Finalize(unsigned char tag[TAGLEN])
+{
+    // Last incomplete block, padded by 1 and zeros
+    if (leftover) {
+        buffer[leftover] = 1;
+        memset(buffer + leftover + 1, 0, 16 - leftover - 1);
+        Blocks(buffer, 16, true);
+    }
+
+    // Fully carry h
+    uint64_t h0 = h[0], h1 = h[1], h2 = h[2];
+    uint64_t c;
+    c = h1 >> 44; h1 &= MASK44;
+    h2 += c; c = h2 >> 42; h2 &= MASK42;
+    h0 += c * 5; c = h0 >> 44; h0 &= MASK44;
+    h1 += c; c = h1 >> 44; h1 &= MASK44;
+    h2 += c; c = h2 >> 42; h2 &= MASK42;
+    h0 += c * 5; c = h0 >> 44; h0 &= MASK44;
+    h1 += c;
+
+    // g = h + -p
+    uint64_t g0 = h0 + 5; c = g0 >> 44; g0 &= MASK44;
+    uint64_t g1 = h1 + c; c = g1 >> 44; g1 &= MASK44;
+    uint64_t g2 = h2 + c - (uint64_t(1) << 42);
+
+    // Select h if h < p, or h + -p if h >= p (in constant time)
+    c = (g2 >> 63) - 1;
+    g0 &= c;
+    g1 &= c;
+    g2 &= c;
+    c = ~c;
+    h0 = (h0 & c) | g0;
+    h1 = (h1 & c) | g1;
+    h2 = (h2 & c) | g2;
+
+    // h = (h + pad) % 2^128
+    uint64_t t0 = pad[0], t1 = pad[1];
+    h0 += t0 & MASK44; c = h0 >> 44; h0 &= MASK44;
+    h1 += (((t0 >> 44) | (t1 << 20)) & MASK44) + c; c = h1 >> 44; h1 &= MASK44;
+    h2 += ((t1 >> 24) & MASK42) + c; h2 &= MASK42;
+
+    WriteLE64(tag + 0, h0 | (h1 << 44));
+    WriteLE64(tag + 8, (h1 >> 20) | (h2 << 24));
+
+    // Key is for one time use only
+    memset(r, 0, sizeof(r));
+    memset(pad, 0, sizeof(pad));
+}
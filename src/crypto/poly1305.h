@@ -0,0 +1,32 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_CRYPTO_POLY1305_H
+#define BITCOIN_CRYPTO_POLY1305_H
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/** Poly1305 one-time authenticator (RFC 8439). */
+class Poly1305
+{
+private:
+    uint64_t r[3];
+    uint64_t h[3];
+    uint64_t pad[2];
+    unsigned char buffer[16];
+    size_t leftover;
+
+    void Blocks(const unsigned char* m, size_t bytes, bool final);
+
+public:
+    static const size_t KEYLEN = 32;
+    static const size_t TAGLEN = 16;
+
+    explicit Poly1305(const unsigned char key[KEYLEN]);
+    Poly1305& Update(const unsigned char* data, size_t len);
+    void Finalize(unsigned char tag[TAGLEN]);
+};
+
+#endif // BITCOIN_CRYPTO_POLY1305_H
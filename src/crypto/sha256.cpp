@@ -9,6 +9,8 @@
 #include <assert.h>
 #include <string.h>
 #include <atomic>
+#include <stdexcept>
+#include <vector>
 
 #if defined(__x86_64__) || defined(__amd64__) || defined(__i386__)
 #if defined(USE_ASM)
@@ -25,11 +27,21 @@ namespace sha256d64_sse41
 void Transform_4way(unsigned char* out, const unsigned char* in);
 }
 
+namespace sha256_sse41
+{
+void Transform_4way(uint32_t* const* s, const unsigned char* const* chunk);
+}
+
 namespace sha256d64_avx2
 {
 void Transform_8way(unsigned char* out, const unsigned char* in);
 }
 
+namespace sha256_avx2
+{
+void Transform_8way(uint32_t* const* s, const unsigned char* const* chunk);
+}
+
 namespace sha256d64_shani
 {
 void Transform_2way(unsigned char* out, const unsigned char* in);
@@ -417,6 +429,7 @@ void TransformD64(unsigned char* out, const unsigned char* in)
 
 typedef void (*TransformType)(uint32_t*, const unsigned char*, size_t);
 typedef void (*TransformD64Type)(unsigned char*, const unsigned char*);
+typedef void (*TransformMultiType)(uint32_t* const*, const unsigned char* const*);
 
 template<TransformType tr>
 void TransformD64Wrapper(unsigned char* out, const unsigned char* in)
@@ -462,6 +475,8 @@ TransformD64Type TransformD64 = sha256::TransformD64;
 TransformD64Type TransformD64_2way = nullptr;
 TransformD64Type TransformD64_4way = nullptr;
 TransformD64Type TransformD64_8way = nullptr;
+TransformMultiType TransformMulti_4way = nullptr;
+TransformMultiType TransformMulti_8way = nullptr;
 
 bool SelfTest() {
     // Input state (equal to the initial SHA256 state)
@@ -547,6 +562,28 @@ bool SelfTest() {
         if (!std::equal(out, out + 256, result_d64)) return false;
     }
 
+    // Test TransformMulti_4way and TransformMulti_8way, if available: lane i transforms i blocks
+    for (auto multi : {TransformMulti_4way, TransformMulti_8way}) {
+        if (!multi) continue;
+        size_t lanes = multi == TransformMulti_8way ? 8 : 4;
+        uint32_t states[8][8];
+        uint32_t* s[8];
+        const unsigned char* chunks[8];
+        for (size_t i = 0; i < lanes; ++i) {
+            std::copy(init, init + 8, states[i]);
+            s[i] = states[i];
+        }
+        for (size_t block = 0; block < 8; ++block) {
+            for (size_t i = 0; i < lanes; ++i) {
+                chunks[i] = data + 1 + 64 * std::min(block, i);
+            }
+            multi(s, chunks);
+            for (size_t i = 0; i < lanes; ++i) {
+                if (block + 1 == i && !std::equal(states[i], states[i] + 8, result[i])) return false;
+            }
+        }
+    }
+
     return true;
 }
 
@@ -570,12 +607,34 @@ bool AVXEnabled()
     return (a & 6) == 6;
 }
 #endif
+
+/** Name of the implementation chosen by the last SHA256AutoDetect() call. */
+std::string implementation = "standard";
+
+void UseStandard()
+{
+    Transform = sha256::Transform;
+    TransformD64 = sha256::TransformD64;
+    TransformD64_2way = nullptr;
+    TransformD64_4way = nullptr;
+    TransformD64_8way = nullptr;
+    TransformMulti_4way = nullptr;
+    TransformMulti_8way = nullptr;
+}
 } // namespace
 
 
-std::string SHA256AutoDetect()
+std::string SHA256AutoDetect(const std::string& forced)
 {
+    if (!forced.empty() && forced != "standard" && forced != "sse4" && forced != "sse41" && forced != "avx2" && forced != "shani") {
+        throw std::runtime_error("Unknown SHA256 implementation '" + forced + "'");
+    }
+
+    UseStandard();
+
+    const bool any = forced.empty();
     std::string ret = "standard";
+    std::string top = "standard";
 #if defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
     bool have_sse4 = false;
     bool have_xsave = false;
@@ -606,12 +665,21 @@ std::string SHA256AutoDetect()
         have_shani = (ebx >> 29) & 1;
     }
 
+    // A forced implementation limits which of the detected extensions are used
+    if (!any) {
+        have_shani = have_shani && forced == "shani";
+        have_sse4 = have_sse4 && forced != "shani" && forced != "standard";
+        have_avx2 = have_avx2 && forced == "avx2";
+    }
+    const bool want_sse41 = any || forced == "sse41" || forced == "avx2";
+
 #if defined(ENABLE_SHANI) && !defined(BUILD_BITCOIN_INTERNAL)
     if (have_shani) {
         Transform = sha256_shani::Transform;
         TransformD64 = TransformD64Wrapper<sha256_shani::Transform>;
         TransformD64_2way = sha256d64_shani::Transform_2way;
         ret = "shani(1way,2way)";
+        top = "shani";
         have_sse4 = false; // Disable SSE4/AVX2;
         have_avx2 = false;
     }
@@ -622,25 +690,50 @@ std::string SHA256AutoDetect()
         Transform = sha256_sse4::Transform;
         TransformD64 = TransformD64Wrapper<sha256_sse4::Transform>;
         ret = "sse4(1way)";
+        top = "sse4";
 #endif
 #if defined(ENABLE_SSE41) && !defined(BUILD_BITCOIN_INTERNAL)
-        TransformD64_4way = sha256d64_sse41::Transform_4way;
-        ret += ",sse41(4way)";
+        if (want_sse41) {
+            TransformD64_4way = sha256d64_sse41::Transform_4way;
+            TransformMulti_4way = sha256_sse41::Transform_4way;
+            ret += ",sse41(4way)";
+            top = "sse41";
+        }
 #endif
     }
 
 #if defined(ENABLE_AVX2) && !defined(BUILD_BITCOIN_INTERNAL)
     if (have_avx2 && have_avx && enabled_avx) {
         TransformD64_8way = sha256d64_avx2::Transform_8way;
+        TransformMulti_8way = sha256_avx2::Transform_8way;
         ret += ",avx2(8way)";
+        top = "avx2";
     }
 #endif
 #endif
 
-    assert(SelfTest());
+    if (!any && forced != top) {
+        UseStandard();
+        throw std::runtime_error("SHA256 implementation '" + forced + "' is not supported by this CPU or build");
+    }
+
+    if (!SelfTest()) {
+        UseStandard();
+        if (!any || !SelfTest()) {
+            throw std::runtime_error("Self-test of SHA256 implementation '" + ret + "' failed");
+        }
+        ret = "standard(" + ret + " failed self-test)";
+    }
+
+    implementation = ret;
     return ret;
 }
 
+std::string SHA256Implementation()
+{
+    return implementation;
+}
+
 ////// SHA-256
 
 CSHA256::CSHA256() : bytes(0)
@@ -731,3 +824,143 @@ void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
         --blocks;
     }
 }
+
+////// Multi-buffer SHA-256
+
+namespace
+{
+/** Message being hashed in a lane: full blocks are read in place, the padded tail from a copy. */
+struct MultiJob
+{
+    const unsigned char* data;
+    size_t dataBlocks;
+    size_t totalBlocks;
+    size_t next;
+    unsigned char* out;
+    uint32_t state[8];
+    unsigned char tail[128];
+
+    void Init(const unsigned char* input, size_t length, unsigned char* output)
+    {
+        data = input;
+        dataBlocks = length / 64;
+        out = output;
+        next = 0;
+        sha256::Initialize(state);
+
+        size_t rest = length % 64;
+        size_t tailBlocks = rest + 9 > 64 ? 2 : 1;
+        totalBlocks = dataBlocks + tailBlocks;
+        memset(tail, 0, sizeof(tail));
+        memcpy(tail, input + dataBlocks * 64, rest);
+        tail[rest] = 0x80;
+        WriteBE64(tail + tailBlocks * 64 - 8, static_cast<uint64_t>(length) << 3);
+    }
+
+    const unsigned char* Chunk() const
+    {
+        return next < dataBlocks ? data + next * 64 : tail + (next - dataBlocks) * 64;
+    }
+
+    void Finish()
+    {
+        for (int i = 0; i < 8; ++i) {
+            WriteBE32(out + 4 * i, state[i]);
+        }
+    }
+};
+} // namespace
+
+void SHA256Multi(unsigned char* output, const unsigned char* const* inputs, const size_t* lengths, size_t count)
+{
+    const size_t lanes = TransformMulti_8way ? 8 : TransformMulti_4way ? 4 : 0;
+    if (lanes == 0 || count < 2) {
+        for (size_t i = 0; i < count; ++i) {
+            CSHA256().Write(inputs[i], lengths[i]).Finalize(output + 32 * i);
+        }
+        return;
+    }
+
+    static const unsigned char idleChunk[64] = {};
+    uint32_t idleState[8] = {};
+
+    std::vector<MultiJob> jobs(count);
+    MultiJob* slots[8] = {};
+    size_t pending = 0;
+    size_t active = 0;
+
+    auto refill = [&](size_t slot) {
+        if (pending < count) {
+            jobs[pending].Init(inputs[pending], lengths[pending], output + 32 * pending);
+            slots[slot] = &jobs[pending++];
+            ++active;
+        }
+    };
+    for (size_t slot = 0; slot < lanes; ++slot) {
+        refill(slot);
+    }
+
+    while (active > 0) {
+        if (active == 1) {
+            // Last message: the rest of it goes through the single-lane transform at once
+            for (size_t slot = 0; slot < lanes; ++slot) {
+                if (auto job = slots[slot]) {
+                    if (job->next < job->dataBlocks) {
+                        Transform(job->state, job->Chunk(), job->dataBlocks - job->next);
+                        job->next = job->dataBlocks;
+                    }
+                    Transform(job->state, job->Chunk(), job->totalBlocks - job->next);
+                    job->Finish();
+                    slots[slot] = nullptr;
+                    --active;
+                }
+            }
+            break;
+        }
+
+        // Narrower kernel when few messages are left, so that idle lanes aren't hashed for nothing
+        const bool wide = lanes == 8 && (active > 4 || !TransformMulti_4way);
+        const size_t width = wide ? 8 : 4;
+
+        uint32_t* states[8];
+        const unsigned char* chunks[8];
+        size_t used[8];
+        size_t n = 0;
+        for (size_t slot = 0; slot < lanes && n < width; ++slot) {
+            if (slots[slot]) {
+                states[n] = slots[slot]->state;
+                chunks[n] = slots[slot]->Chunk();
+                used[n++] = slot;
+            }
+        }
+        for (size_t i = n; i < width; ++i) {
+            states[i] = idleState;
+            chunks[i] = idleChunk;
+        }
+
+        (wide ? TransformMulti_8way : TransformMulti_4way)(states, chunks);
+
+        for (size_t i = 0; i < n; ++i) {
+            auto job = slots[used[i]];
+            if (++job->next == job->totalBlocks) {
+                job->Finish();
+                slots[used[i]] = nullptr;
+                --active;
+                refill(used[i]);
+            }
+        }
+    }
+}
+
+void SHA256DMulti(unsigned char* output, const unsigned char* const* inputs, const size_t* lengths, size_t count)
+{
+    std::vector<unsigned char> first(32 * count);
+    SHA256Multi(first.data(), inputs, lengths, count);
+
+    std::vector<const unsigned char*> hashes(count);
+    std::vector<size_t> sizes(count, 32);
+    for (size_t i = 0; i < count; ++i) {
+        hashes[i] = first.data() + 32 * i;
+    }
+    SHA256Multi(output, hashes.data(), sizes.data(), count);
+}
@@ -27,10 +27,17 @@ public:
     CSHA256& Reset();
 };
 
-/** Autodetect the best available SHA256 implementation.
+/** Autodetect the best available SHA256 implementation and self-test it.
+ *  forced:  empty to pick the fastest one, or one of "standard", "sse4",
+ *           "sse41", "avx2", "shani" to use only that one (throws if it is
+ *           not supported by the CPU or the build).
+ *  Not thread-safe: call at startup, before hashing from other threads.
  *  Returns the name of the implementation.
  */
-std::string SHA256AutoDetect();
+std::string SHA256AutoDetect(const std::string& forced = "");
+
+/** Name of the implementation selected by SHA256AutoDetect() ("standard" before it is called). */
+std::string SHA256Implementation();
 
 /** Compute multiple double-SHA256's of 64-byte blobs.
  *  output:  pointer to a blocks*32 byte output buffer
@@ -39,4 +46,16 @@ std::string SHA256AutoDetect();
  */
 void SHA256D64(unsigned char* output, const unsigned char* input, size_t blocks);
 
+/** Compute SHA256 of several independent messages of arbitrary lengths.
+ *  Messages are advanced block by block in parallel SIMD lanes (4-way SSE4.1,
+ *  8-way AVX2) when available; otherwise they are hashed one after another.
+ *  output:  pointer to a count*32 byte output buffer (must not overlap inputs)
+ *  inputs:  pointers to the messages
+ *  lengths: sizes of the messages
+ */
+void SHA256Multi(unsigned char* output, const unsigned char* const* inputs, const size_t* lengths, size_t count);
+
+/** Same as SHA256Multi(), but computes double-SHA256 of each message. */
+void SHA256DMulti(unsigned char* output, const unsigned char* const* inputs, const size_t* lengths, size_t count);
+
 #endif // BITCOIN_CRYPTO_SHA256_H
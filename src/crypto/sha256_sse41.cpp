@@ -314,4 +314,77 @@ void Transform_4way(unsigned char* out, const unsigned char* in)
 
 }
 
+/** Compress one block of each of 4 independent messages: s[i] is the state of lane i, chunk[i] its 64-byte block. */
+namespace sha256_sse41 {
+namespace {
+
+using namespace sha256d64_sse41;
+
+const uint32_t k256[64] = {
+    0x428a2f98ul, 0x71374491ul, 0xb5c0fbcful, 0xe9b5dba5ul, 0x3956c25bul, 0x59f111f1ul, 0x923f82a4ul, 0xab1c5ed5ul,
+    0xd807aa98ul, 0x12835b01ul, 0x243185beul, 0x550c7dc3ul, 0x72be5d74ul, 0x80deb1feul, 0x9bdc06a7ul, 0xc19bf174ul,
+    0xe49b69c1ul, 0xefbe4786ul, 0x0fc19dc6ul, 0x240ca1ccul, 0x2de92c6ful, 0x4a7484aaul, 0x5cb0a9dcul, 0x76f988daul,
+    0x983e5152ul, 0xa831c66dul, 0xb00327c8ul, 0xbf597fc7ul, 0xc6e00bf3ul, 0xd5a79147ul, 0x06ca6351ul, 0x14292967ul,
+    0x27b70a85ul, 0x2e1b2138ul, 0x4d2c6dfcul, 0x53380d13ul, 0x650a7354ul, 0x766a0abbul, 0x81c2c92eul, 0x92722c85ul,
+    0xa2bfe8a1ul, 0xa81a664bul, 0xc24b8b70ul, 0xc76c51a3ul, 0xd192e819ul, 0xd6990624ul, 0xf40e3585ul, 0x106aa070ul,
+    0x19a4c116ul, 0x1e376c08ul, 0x2748774cul, 0x34b0bcb5ul, 0x391c0cb3ul, 0x4ed8aa4aul, 0x5b9cca4ful, 0x682e6ff3ul,
+    0x748f82eeul, 0x78a5636ful, 0x84c87814ul, 0x8cc70208ul, 0x90befffaul, 0xa4506cebul, 0xbef9a3f7ul, 0xc67178f2ul
+};
+
+__m128i inline __attribute__((always_inline)) Schedule(__m128i* w, int i)
+{
+    if (i < 16) return Add(K(k256[i]), w[i]);
+    return Add(K(k256[i]), Inc(w[i & 15], sigma1(w[(i - 2) & 15]), w[(i - 7) & 15], sigma0(w[(i - 15) & 15])));
+}
+
+}
+
+void Transform_4way(uint32_t* const* s, const unsigned char* const* chunk)
+{
+    __m128i a = _mm_set_epi32(s[3][0], s[2][0], s[1][0], s[0][0]);
+    __m128i b = _mm_set_epi32(s[3][1], s[2][1], s[1][1], s[0][1]);
+    __m128i c = _mm_set_epi32(s[3][2], s[2][2], s[1][2], s[0][2]);
+    __m128i d = _mm_set_epi32(s[3][3], s[2][3], s[1][3], s[0][3]);
+    __m128i e = _mm_set_epi32(s[3][4], s[2][4], s[1][4], s[0][4]);
+    __m128i f = _mm_set_epi32(s[3][5], s[2][5], s[1][5], s[0][5]);
+    __m128i g = _mm_set_epi32(s[3][6], s[2][6], s[1][6], s[0][6]);
+    __m128i h = _mm_set_epi32(s[3][7], s[2][7], s[1][7], s[0][7]);
+
+    __m128i w[16];
+    for (int i = 0; i < 16; ++i) {
+        w[i] = _mm_set_epi32(ReadBE32(chunk[3] + 4 * i), ReadBE32(chunk[2] + 4 * i), ReadBE32(chunk[1] + 4 * i), ReadBE32(chunk[0] + 4 * i));
+    }
+
+    for (int i = 0; i < 64; i += 8) {
+        Round(a, b, c, d, e, f, g, h, Schedule(w, i + 0));
+        Round(h, a, b, c, d, e, f, g, Schedule(w, i + 1));
+        Round(g, h, a, b, c, d, e, f, Schedule(w, i + 2));
+        Round(f, g, h, a, b, c, d, e, Schedule(w, i + 3));
+        Round(e, f, g, h, a, b, c, d, Schedule(w, i + 4));
+        Round(d, e, f, g, h, a, b, c, Schedule(w, i + 5));
+        Round(c, d, e, f, g, h, a, b, Schedule(w, i + 6));
+        Round(b, c, d, e, f, g, h, a, Schedule(w, i + 7));
+    }
+
+    alignas(16) uint32_t out[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(out), a);
+    for (int i = 0; i < 4; ++i) s[i][0] += out[i];
+    _mm_store_si128(reinterpret_cast<__m128i*>(out), b);
+    for (int i = 0; i < 4; ++i) s[i][1] += out[i];
+    _mm_store_si128(reinterpret_cast<__m128i*>(out), c);
+    for (int i = 0; i < 4; ++i) s[i][2] += out[i];
+    _mm_store_si128(reinterpret_cast<__m128i*>(out), d);
+    for (int i = 0; i < 4; ++i) s[i][3] += out[i];
+    _mm_store_si128(reinterpret_cast<__m128i*>(out), e);
+    for (int i = 0; i < 4; ++i) s[i][4] += out[i];
+    _mm_store_si128(reinterpret_cast<__m128i*>(out), f);
+    for (int i = 0; i < 4; ++i) s[i][5] += out[i];
+    _mm_store_si128(reinterpret_cast<__m128i*>(out), g);
+    for (int i = 0; i < 4; ++i) s[i][6] += out[i];
+    _mm_store_si128(reinterpret_cast<__m128i*>(out), h);
+    for (int i = 0; i < 4; ++i) s[i][7] += out[i];
+}
+
+}
+
 #endif
@@ -0,0 +1,138 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// sha256_test.cpp
+
+#include "sha256.h"
+
+#include <gtest/gtest.h>
+#include <util/Hex.hpp>
+
+namespace
+{
+	std::vector<uint8_t> sha256(const std::string& data)
+	{
+		std::vector<uint8_t> hash(CSHA256::OUTPUT_SIZE);
+		CSHA256().Write(reinterpret_cast<const uint8_t*>(data.data()), data.size()).Finalize(hash.data());
+		return hash;
+	}
+}
+
+TEST(SHA256, Implementations)
+{
+	std::vector<uint8_t> blocks(64 * 19);
+	for (size_t i = 0; i < blocks.size(); ++i)
+	{
+		blocks[i] = static_cast<uint8_t>(i * 31 + 7);
+	}
+
+	SHA256AutoDetect("standard");
+	std::vector<uint8_t> expectedD64(32 * 19);
+	SHA256D64(expectedD64.data(), blocks.data(), 19);
+
+	for (auto name : {"standard", "sse4", "sse41", "avx2", "shani"})
+	{
+		try
+		{
+			SHA256AutoDetect(name);
+		}
+		catch (const std::runtime_error&)
+		{
+			continue; // Not supported by CPU or build
+		}
+
+		EXPECT_EQ(sha256(""), Hex::Parse("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855")) << name;
+		EXPECT_EQ(sha256("abc"), Hex::Parse("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad")) << name;
+		EXPECT_EQ(
+			sha256(std::string(1000, 'a')),
+			Hex::Parse("41edece42d63e8d9bf515a9ba6932e1c20cbc9f5a5d134645adb5db1b9737ea3")
+		) << name;
+
+		std::vector<uint8_t> d64(32 * 19);
+		SHA256D64(d64.data(), blocks.data(), 19);
+		EXPECT_EQ(d64, expectedD64) << name;
+	}
+
+	EXPECT_THROW(SHA256AutoDetect("unknown"), std::runtime_error);
+
+	EXPECT_NO_THROW(SHA256AutoDetect());
+}
+
+TEST(SHA256, Multi)
+{
+	// Messages of all lengths around block and padding boundaries, in uneven order
+	std::vector<std::vector<uint8_t>> messages;
+	for (size_t length = 0; length < 200; ++length)
+	{
+		auto size = (length * 37) % 200;
+		std::vector<uint8_t> message(size);
+		for (size_t i = 0; i < size; ++i)
+		{
+			message[i] = static_cast<uint8_t>(i * 7 + size);
+		}
+		messages.emplace_back(std::move(message));
+	}
+	messages.emplace_back(5000, 0x5a);
+
+	std::vector<const uint8_t*> inputs;
+	std::vector<size_t> lengths;
+	for (auto& message : messages)
+	{
+		inputs.push_back(message.data());
+		lengths.push_back(message.size());
+	}
+
+	for (auto name : {"standard", "sse41", "avx2"})
+	{
+		try
+		{
+			SHA256AutoDetect(name);
+		}
+		catch (const std::runtime_error&)
+		{
+			continue; // Not supported by CPU or build
+		}
+
+		for (size_t count : {size_t(1), size_t(3), size_t(9), messages.size()})
+		{
+			std::vector<uint8_t> single(32 * count);
+			std::vector<uint8_t> doubled(32 * count);
+			SHA256Multi(single.data(), inputs.data(), lengths.data(), count);
+			SHA256DMulti(doubled.data(), inputs.data(), lengths.data(), count);
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				std::vector<uint8_t> expected(32);
+				CSHA256().Write(inputs[i], lengths[i]).Finalize(expected.data());
+				EXPECT_EQ(std::vector<uint8_t>(single.begin() + 32 * i, single.begin() + 32 * (i + 1)), expected)
+					<< name << ", message " << i << " of " << count;
+
+				CSHA256().Write(expected.data(), 32).Finalize(expected.data());
+				EXPECT_EQ(std::vector<uint8_t>(doubled.begin() + 32 * i, doubled.begin() + 32 * (i + 1)), expected)
+					<< name << ", message " << i << " of " << count;
+			}
+		}
+	}
+
+	SHA256AutoDetect();
+}
@@ -0,0 +1,189 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// BinaryLogEncoder_test.cpp
+
+#include <log/AsyncSinkWriter.hpp>
+#include <log/BinaryLogEncoder.hpp>
+
+#include <gtest/gtest.h>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <tuple>
+
+namespace
+{
+	void encode(BinaryLogEncoder& encoder, std::string& out, const char* format, ...)
+	{
+		va_list ap;
+		va_start(ap, format);
+		encoder.encode(out, Log::Detail::INFO, "Test", "main", format, ap);
+		va_end(ap);
+	}
+
+	/// Ids of entries that reference undefined format or string; the log itself must be well-formed
+	std::vector<uint32_t> undefinedReferences(const std::string& log)
+	{
+		std::set<uint32_t> formats;
+		std::set<uint32_t> strings;
+		std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> entries;
+
+		auto get = [&](size_t& pos, void* value, size_t size)
+		{
+			if (log.size() - pos < size)
+			{
+				throw std::runtime_error("Truncated record");
+			}
+			memcpy(value, log.data() + pos, size);
+			pos += size;
+		};
+
+		size_t pos = 0;
+		while (pos < log.size())
+		{
+			BinaryLogFormat::Record type;
+			uint32_t id;
+			get(pos, &type, sizeof(type));
+			get(pos, &id, sizeof(id));
+
+			if (type == BinaryLogFormat::Record::FORMAT || type == BinaryLogFormat::Record::STRING)
+			{
+				uint32_t size;
+				get(pos, &size, sizeof(size));
+				pos += size;
+				(type == BinaryLogFormat::Record::FORMAT ? formats : strings).insert(id);
+				continue;
+			}
+			if (type != BinaryLogFormat::Record::ENTRY)
+			{
+				throw std::runtime_error("Unknown record type");
+			}
+
+			uint64_t timestamp;
+			uint32_t nameId;
+			uint32_t threadId;
+			uint8_t level;
+			uint32_t size;
+			get(pos, &timestamp, sizeof(timestamp));
+			get(pos, &nameId, sizeof(nameId));
+			get(pos, &threadId, sizeof(threadId));
+			get(pos, &level, sizeof(level));
+			get(pos, &size, sizeof(size));
+			pos += size;
+			entries.emplace_back(id, nameId, threadId);
+		}
+		if (pos != log.size())
+		{
+			throw std::runtime_error("Truncated record");
+		}
+
+		std::vector<uint32_t> undefined;
+		for (const auto& [formatId, nameId, threadId] : entries)
+		{
+			if (formats.count(formatId) == 0) undefined.push_back(formatId);
+			if (strings.count(nameId) == 0) undefined.push_back(nameId);
+			if (strings.count(threadId) == 0) undefined.push_back(threadId);
+		}
+		return undefined;
+	}
+}
+
+TEST(BinaryLogEncoder, DefinitionsSurviveDroppedRecords)
+{
+	BinaryLogEncoder encoder;
+
+	std::mutex mutex;
+	std::condition_variable released;
+	bool blocked = true;
+	std::string log;
+
+	// Output is stuck until released, so the ring of this thread overflows
+	AsyncSinkWriter writer(
+		[&](const char* data, size_t size)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			released.wait(lock, [&]{ return !blocked; });
+			log.append(data, size);
+		},
+		[&](uint64_t dropped)
+		{
+			std::string record;
+			encoder.encode(record, Log::Detail::WARN, "Logger", "", std::to_string(dropped) + " dropped");
+			return record;
+		},
+		std::chrono::milliseconds(1),
+		AsyncSinkWriter::Overflow::DROP,
+		1u<<12
+	);
+
+	// Same sequence as Sink::pushBinary()
+	auto push = [&](const std::string& record)
+	{
+		if (!writer.pushRaw(record))
+		{
+			encoder.discard(record);
+			return false;
+		}
+		return true;
+	};
+
+	size_t pushed = 0;
+	for (int i = 0; i < 100000; ++i)
+	{
+		std::string record;
+		encode(encoder, record, "Filling record #%d", i);
+		if (!push(record))
+		{
+			break;
+		}
+		++pushed;
+	}
+	EXPECT_LT(pushed, 100000u) << "Ring never overflowed";
+
+	// First record of new format carries its definition, and is dropped
+	std::string record;
+	encode(encoder, record, "Record of new format #%d", 1);
+	EXPECT_FALSE(push(record));
+
+	{
+		std::lock_guard<std::mutex> lockGuard(mutex);
+		blocked = false;
+	}
+	released.notify_all();
+	writer.sync();
+
+	// Next record of the same format must define it again
+	record.clear();
+	encode(encoder, record, "Record of new format #%d", 2);
+	EXPECT_TRUE(push(record));
+	writer.sync();
+
+	std::lock_guard<std::mutex> lockGuard(mutex);
+	std::vector<uint32_t> undefined;
+	ASSERT_NO_THROW(undefined = undefinedReferences(log));
+	EXPECT_TRUE(undefined.empty());
+	EXPECT_NE(log.find("Record of new format #%d"), std::string::npos);
+}
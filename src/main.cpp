@@ -1,6 +1,8 @@
 #include <iostream>
 
 #include "types/Blobs.hpp"
+#include "crypto/sha256.h"
+#include "crypto/keys/SignatureVerifier.hpp"
 #include "node/Node.hpp"
 #include <utils/Daemon.hpp>
 #include <configs/Options.hpp>
@@ -9,8 +11,13 @@
 #include <thread/ThreadPool.hpp>
 #include <transport/Transports.hpp>
 #include <telemetry/SysInfo.hpp>
+#include <telemetry/TelemetryManager.hpp>
+#include <telemetry/Tracer.hpp>
 #include <thread/TaskManager.hpp>
 #include <net/ConnectionManager.hpp>
+#include <net/EncryptedConnection.hpp>
+#include <serialization/SArr.hpp>
+#include <util/Hex.hpp>
 #include <node/AddressManager.hpp>
 
 int main(int argc, char *argv[])
@@ -101,6 +108,83 @@ int main(int argc, char *argv[])
 				throw std::runtime_error("Count of workers too few. Programm won't be work correctly");
 			}
 		}
+
+		// Threads verifying signatures besides thread submitting batch
+		{
+			size_t verifiers = std::max<size_t>(1, std::thread::hardware_concurrency()) - 1;
+			if (coreSettings.hasOf<SInt>("verifiers"))
+			{
+				verifiers = coreSettings.getAs<SInt>("verifiers");
+			}
+			SignatureVerifier::init(verifiers);
+			log.info("Using %zu threads for signature verification", verifiers);
+		}
+
+		// SHA-256 implementation: the fastest one supported by CPU, unless forced (e.g. for benchmarking)
+		{
+			std::string sha256;
+			coreSettings.trylookup("sha256", sha256);
+
+			auto implementation = SHA256AutoDetect(sha256 == "auto" ? "" : sha256);
+			log.info("Using SHA256 implementation: %s", implementation.c_str());
+
+			TelemetryManager::gauge(
+				TelemetryManager::labeled("crypto/sha256_implementation", {{"name", implementation}})
+			)->set(1);
+		}
+
+		// Task tracing (dump by SIGUSR2 or RPC 'dumptrace')
+		if (coreSettings.hasOf<SObj>("tracing"))
+		{
+			auto& tracingSettings = coreSettings.getAs<SObj>("tracing");
+
+			bool enable = false;
+			tracingSettings.trylookup("enable", enable);
+
+			size_t events = 8192;
+			if (tracingSettings.has("events"))
+			{
+				tracingSettings.lookup("events", events);
+			}
+
+			std::string path;
+			tracingSettings.trylookup("path", path);
+
+			if (enable)
+			{
+				Tracer::enable(events, std::move(path));
+			}
+		}
+
+		// Key shared by own nodes for encrypted P2P links (transport "layer": "encrypted")
+		{
+			std::string p2pKey;
+			coreSettings.trylookup("p2pKey", p2pKey);
+
+			if (!p2pKey.empty())
+			{
+				if (!Hex::isHexString(p2pKey))
+				{
+					throw std::runtime_error("Key for P2P encryption must be hex string");
+				}
+				EncryptedConnection::setKey(Hex::Parse(p2pKey));
+				log.info("Using encryption of P2P connections");
+			}
+
+			// Own nodes reached over encrypted layer; other peers are connected by plain TCP
+			if (coreSettings.hasOf<SArr>("p2pNodes"))
+			{
+				auto& p2pNodes = coreSettings.getAs<SArr>("p2pNodes");
+				if (!p2pNodes.empty() && p2pKey.empty())
+				{
+					throw std::runtime_error("Own P2P nodes are set without key for P2P encryption");
+				}
+				for (const auto& address : p2pNodes)
+				{
+					EncryptedConnection::addNode(address.as<SStr>().value());
+				}
+			}
+		}
 	}
 	catch (const std::exception& exception)
 	{
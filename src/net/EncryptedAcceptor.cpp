@@ -0,0 +1,59 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// EncryptedAcceptor.cpp
+
+#include "EncryptedAcceptor.hpp"
+#include "EncryptedConnection.hpp"
+#include <net/ConnectionManager.hpp>
+#include <transport/ServerTransport.hpp>
+#include <unistd.h>
+
+EncryptedAcceptor::EncryptedAcceptor(const std::shared_ptr<ServerTransport>& transport, const std::string& host, std::uint16_t port)
+: TcpAcceptor(transport, host, port)
+{
+	_name = "EncryptedAcceptor" + _name.substr(11);
+}
+
+void EncryptedAcceptor::createConnection(int sock, const sockaddr_in& cliaddr)
+{
+	auto transport = std::dynamic_pointer_cast<ServerTransport>(_transport.lock());
+	if (!transport)
+	{
+		return;
+	}
+
+	if (!EncryptedConnection::hasKey())
+	{
+		_log.warn("%s refuses connection: no key for encryption", name().c_str());
+		::close(sock);
+		return;
+	}
+
+	auto newConnection = std::make_shared<EncryptedConnection>(transport, sock, cliaddr, false);
+
+	newConnection->setTtl(std::chrono::seconds(5));
+
+	ConnectionManager::add(newConnection->ptr());
+
+	transport->metricConnectCount->add();
+}
@@ -0,0 +1,47 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// EncryptedAcceptor.hpp
+
+#pragma once
+
+#include <net/TcpAcceptor.hpp>
+
+class EncryptedAcceptor : public TcpAcceptor
+{
+public:
+	EncryptedAcceptor() = delete;
+	EncryptedAcceptor(const EncryptedAcceptor&) = delete;
+	EncryptedAcceptor& operator=(const EncryptedAcceptor&) = delete;
+	EncryptedAcceptor(EncryptedAcceptor&& tmp) noexcept = delete;
+	EncryptedAcceptor& operator=(EncryptedAcceptor&& tmp) noexcept = delete;
+
+	EncryptedAcceptor(const std::shared_ptr<ServerTransport>& transport, const std::string& host, std::uint16_t port);
+	~EncryptedAcceptor() override = default;
+
+	void createConnection(int sock, const sockaddr_in& cliaddr) override;
+
+	static std::shared_ptr<EncryptedAcceptor> create(const std::shared_ptr<ServerTransport>& transport, const std::string& host, std::uint16_t port)
+	{
+		return std::make_shared<EncryptedAcceptor>(transport, host, port);
+	}
+};
@@ -0,0 +1,402 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// EncryptedConnection.cpp
+
+#include "EncryptedConnection.hpp"
+#include "EncryptedAcceptor.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <crypto/hmac_sha256.h>
+#include <net/AcceptorFactory.hpp>
+#include <net/ConnectionManager.hpp>
+#include <support/Random.hpp>
+#include <transport/ServerTransport.hpp>
+
+namespace
+{
+	// HKDF-SHA256 (RFC 5869) expanding of one block, enough for 32-byte keys
+	void deriveKey(const uint8_t* prk, const std::string& info, uint8_t* output)
+	{
+		static const uint8_t one = 1;
+		CHMAC_SHA256(prk, CHMAC_SHA256::OUTPUT_SIZE)
+			.Write(reinterpret_cast<const uint8_t*>(info.data()), info.size())
+			.Write(&one, 1)
+			.Finalize(output);
+	}
+
+	[[maybe_unused]] const Dummy encryptedLayer = AcceptorFactory::reg(
+		"encrypted",
+		[](const std::shared_ptr<ServerTransport>& transport, const std::string& host, std::uint16_t port)
+		{
+			return EncryptedAcceptor::create(transport, host, port);
+		}
+	);
+}
+
+std::vector<uint8_t>& EncryptedConnection::key()
+{
+	static std::vector<uint8_t> key;
+	return key;
+}
+
+void EncryptedConnection::setKey(const std::vector<uint8_t>& key_)
+{
+	if (key_.size() != FSChaCha20Poly1305::KEYLEN)
+	{
+		throw std::runtime_error("Key for encrypted connections must be " + std::to_string(FSChaCha20Poly1305::KEYLEN) + " bytes");
+	}
+	key() = key_;
+}
+
+bool EncryptedConnection::hasKey()
+{
+	return !key().empty();
+}
+
+std::set<std::string>& EncryptedConnection::nodes()
+{
+	static std::set<std::string> nodes;
+	return nodes;
+}
+
+void EncryptedConnection::addNode(const std::string& address)
+{
+	if (address.empty())
+	{
+		throw std::runtime_error("Empty address of own node");
+	}
+	nodes().emplace(address);
+}
+
+bool EncryptedConnection::isOwnNode(const std::string& host, uint16_t port)
+{
+	if (!hasKey())
+	{
+		return false;
+	}
+	auto& list = nodes();
+	return list.count(host) != 0 || list.count(host + ":" + std::to_string(port)) != 0;
+}
+
+EncryptedConnection::EncryptedConnection(const std::shared_ptr<Transport>& transport, int sock, const sockaddr_in& sockaddr, bool outgoing)
+: TcpConnection(transport, sock, sockaddr, outgoing)
+, _established(false)
+, _framePos(0)
+, _framePlain(0)
+, _recvLengthKnown(false)
+, _recvHeader()
+, _recvSize(0)
+{
+	_name = "EncryptedConnection" + _name.substr(13);
+
+	if (!hasKey())
+	{
+		throw std::runtime_error("No key for encrypted connection");
+	}
+
+	GetRandBytes(_localNonce, sizeof(_localNonce));
+	_frame.assign(_localNonce, _localNonce + sizeof(_localNonce));
+}
+
+EncryptedConnection::~EncryptedConnection()
+{
+	// Base destructor flushes _outBuff as is, so only ciphertext may be left there
+	writeToSocket();
+	_outBuff.skip(_outBuff.dataLen());
+}
+
+void EncryptedConnection::watch(epoll_event& ev)
+{
+	TcpConnection::watch(ev);
+
+	if (!_closed && !_error && hasFrameForSend())
+	{
+		ev.events |= EPOLLOUT | EPOLLWRNORM;
+	}
+}
+
+bool EncryptedConnection::processing()
+{
+	// Nonce of handshake is pending even without data for send
+	if (isReadyForWrite() && hasFrameForSend())
+	{
+		writeToSocket();
+	}
+
+	return TcpConnection::processing();
+}
+
+void EncryptedConnection::establish(const uint8_t* remoteNonce)
+{
+	const uint8_t* initiatorNonce = _outgoing ? _localNonce : remoteNonce;
+	const uint8_t* responderNonce = _outgoing ? remoteNonce : _localNonce;
+
+	uint8_t salt[NONCE_SIZE * 2];
+	memcpy(salt, initiatorNonce, NONCE_SIZE);
+	memcpy(salt + NONCE_SIZE, responderNonce, NONCE_SIZE);
+
+	uint8_t prk[CHMAC_SHA256::OUTPUT_SIZE];
+	CHMAC_SHA256(salt, sizeof(salt)).Write(key().data(), key().size()).Finalize(prk);
+
+	uint8_t initiatorLength[32], initiatorContent[32], responderLength[32], responderContent[32];
+	deriveKey(prk, "initiator_L", initiatorLength);
+	deriveKey(prk, "initiator_P", initiatorContent);
+	deriveKey(prk, "responder_L", responderLength);
+	deriveKey(prk, "responder_P", responderContent);
+
+	_sendLength = std::make_unique<FSChaCha20>(_outgoing ? initiatorLength : responderLength, REKEY_INTERVAL);
+	_sendContent = std::make_unique<FSChaCha20Poly1305>(_outgoing ? initiatorContent : responderContent, REKEY_INTERVAL);
+	_recvLength = std::make_unique<FSChaCha20>(_outgoing ? responderLength : initiatorLength, REKEY_INTERVAL);
+	_recvContent = std::make_unique<FSChaCha20Poly1305>(_outgoing ? responderContent : initiatorContent, REKEY_INTERVAL);
+
+	memset(prk, 0, sizeof(prk));
+	memset(initiatorLength, 0, sizeof(initiatorLength));
+	memset(initiatorContent, 0, sizeof(initiatorContent));
+	memset(responderLength, 0, sizeof(responderLength));
+	memset(responderContent, 0, sizeof(responderContent));
+
+	_established = true;
+
+	_log.debug("Encryption established on %s", name().c_str());
+}
+
+void EncryptedConnection::seal()
+{
+	// Take plaintext of up to MAX_FRAME_SIZE from chain of segments
+	iovec iov[64];
+	auto count = _outBuff.gather(iov, sizeof(iov) / sizeof(iov[0]));
+
+	size_t size = 0;
+	for (size_t i = 0; i < count && size < MAX_FRAME_SIZE; ++i)
+	{
+		size += std::min(iov[i].iov_len, MAX_FRAME_SIZE - size);
+	}
+
+	_frame.resize(LENGTH_SIZE + size + FSChaCha20Poly1305::EXPANSION);
+
+	auto content = _frame.data() + LENGTH_SIZE;
+	for (size_t i = 0, offset = 0; offset < size; ++i)
+	{
+		auto len = std::min(iov[i].iov_len, size - offset);
+		memcpy(content + offset, iov[i].iov_base, len);
+		offset += len;
+	}
+
+	_frame[0] = static_cast<uint8_t>(size);
+	_frame[1] = static_cast<uint8_t>(size >> 8);
+	_frame[2] = static_cast<uint8_t>(size >> 16);
+	_sendLength->Crypt(_frame.data(), _frame.data(), LENGTH_SIZE);
+
+	// Encrypted length is authenticated as associated data
+	_sendContent->Encrypt(content, size, _frame.data(), LENGTH_SIZE, content);
+
+	_framePos = 0;
+	_framePlain = size;
+}
+
+bool EncryptedConnection::open()
+{
+	if (!_established)
+	{
+		if (_cipherIn.dataLen() < NONCE_SIZE)
+		{
+			return true;
+		}
+		establish(reinterpret_cast<const uint8_t*>(_cipherIn.dataPtr()));
+		_cipherIn.skip(NONCE_SIZE);
+	}
+
+	for (;;)
+	{
+		if (!_recvLengthKnown)
+		{
+			if (_cipherIn.dataLen() < LENGTH_SIZE)
+			{
+				break;
+			}
+			memcpy(_recvHeader, _cipherIn.dataPtr(), LENGTH_SIZE);
+
+			uint8_t length[LENGTH_SIZE];
+			_recvLength->Crypt(_recvHeader, length, LENGTH_SIZE);
+			_recvSize = length[0] | (length[1] << 8) | (length[2] << 16);
+			if (_recvSize > MAX_FRAME_SIZE)
+			{
+				_log.debug("Too large frame (%zu bytes) on %s", _recvSize, name().c_str());
+				return false;
+			}
+			_recvLengthKnown = true;
+		}
+
+		auto cipherSize = _recvSize + FSChaCha20Poly1305::EXPANSION;
+		if (_cipherIn.dataLen() < LENGTH_SIZE + cipherSize)
+		{
+			break;
+		}
+
+		std::lock_guard<NamedRecursiveMutex> guard(_inBuff.mutex());
+
+		_inBuff.prepare(_recvSize);
+
+		auto cipher = reinterpret_cast<const uint8_t*>(_cipherIn.dataPtr()) + LENGTH_SIZE;
+		if (!_recvContent->Decrypt(cipher, cipherSize, _recvHeader, LENGTH_SIZE, reinterpret_cast<uint8_t*>(_inBuff.spacePtr())))
+		{
+			_log.debug("Fail authentication of frame on %s", name().c_str());
+			return false;
+		}
+
+		_inBuff.forward(_recvSize);
+		_cipherIn.skip(LENGTH_SIZE + cipherSize);
+		_recvLengthKnown = false;
+	}
+
+	return true;
+}
+
+bool EncryptedConnection::writeToSocket()
+{
+	_log.trace("Write into socket on %s", name().c_str());
+
+	// Send data
+	for (;;)
+	{
+		std::lock_guard<NamedRecursiveMutex> guard(_outBuff.mutex());
+
+		if (!hasFrameForSend())
+		{
+			// Frame is sent completely, so its plaintext is not needed anymore
+			_outBuff.skip(_framePlain);
+			_framePlain = 0;
+
+			// Nothing to send
+			if (!_established || !hasDataForSend())
+			{
+				break;
+			}
+
+			seal();
+		}
+
+		ssize_t n = ::write(_sock, _frame.data() + _framePos, _frame.size() - _framePos);
+		if (n == -1)
+		{
+			// Repeat call interrupted by signal
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			// Can't send now
+			if (errno == EAGAIN)
+			{
+				return true;
+			}
+
+			// Write error
+			_log.debug("Fail writing data (error: '%s')", strerror(errno));
+
+			_error = true;
+			return false;
+		}
+
+		_framePos += static_cast<size_t>(n);
+	}
+
+	return true;
+}
+
+bool EncryptedConnection::readFromSocket()
+{
+	_log.trace("Read from socket on %s", name().c_str());
+
+	// Try to read everything available
+	for (;;)
+	{
+		size_t bytes_available = 0;
+		ioctl(_sock, FIONREAD, &bytes_available);
+
+		// No data on socket
+		if (bytes_available == 0)
+		{
+			// And there will be no more
+			if (isHalfHup() || isHup())
+			{
+				_noRead = true;
+			}
+			break;
+		}
+
+		_cipherIn.prepare(bytes_available);
+
+		ssize_t n = ::read(_sock, _cipherIn.spacePtr(), _cipherIn.spaceLen());
+		if (n == -1)
+		{
+			// Repeat call interrupted by signal
+			if (errno == EINTR)
+			{
+				continue;
+			}
+
+			// No data ready - keep waiting
+			if (errno == EAGAIN)
+			{
+				_log.debug("No more read on %s", name().c_str());
+				break;
+			}
+
+			// Read error
+			_log.debug("Error '%s' while read on %s", strerror(errno), name().c_str());
+
+			_error = true;
+			return false;
+		}
+		if (n == 0)
+		{
+			// Client disconnected
+			_log.debug("Client disconnected on %s", name().c_str());
+
+			_noRead = true;
+			break;
+		}
+
+		_cipherIn.forward(static_cast<size_t>(n));
+	}
+
+	if (!open())
+	{
+		_error = true;
+		return false;
+	}
+
+	if (_inBuff.dataLen() > 0)
+	{
+		auto transport = _transport.lock();
+		if (transport)
+		{
+			transport->processing(ptr());
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,102 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// EncryptedConnection.hpp
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include <net/TcpConnection.hpp>
+#include <crypto/chacha20poly1305.h>
+
+// TCP connection encrypted by ChaCha20-Poly1305 with a key pre-shared between own nodes (BIP324 style framing).
+// Each side sends a random nonce; session keys are derived from both nonces and the shared key.
+// Then every frame is a 3-byte length encrypted by FSChaCha20 and content sealed by FSChaCha20Poly1305.
+class EncryptedConnection : public TcpConnection
+{
+public:
+	static constexpr size_t NONCE_SIZE = 32;
+	static constexpr size_t LENGTH_SIZE = 3;
+	static constexpr size_t MAX_FRAME_SIZE = 1u << 16;
+	static constexpr uint32_t REKEY_INTERVAL = 224;
+
+private:
+	uint8_t _localNonce[NONCE_SIZE];
+	bool _established;
+
+	std::unique_ptr<FSChaCha20> _sendLength;
+	std::unique_ptr<FSChaCha20Poly1305> _sendContent;
+	std::unique_ptr<FSChaCha20> _recvLength;
+	std::unique_ptr<FSChaCha20Poly1305> _recvContent;
+
+	// Ciphertext queued for sending: the nonce or a sealed frame
+	std::vector<uint8_t> _frame;
+	size_t _framePos;
+	// Plaintext of _outBuff covered by the frame; it is skipped once the frame is sent completely
+	size_t _framePlain;
+
+	// Received ciphertext not yet decrypted into _inBuff
+	Buffer _cipherIn;
+	bool _recvLengthKnown;
+	uint8_t _recvHeader[LENGTH_SIZE];
+	size_t _recvSize;
+
+	static std::vector<uint8_t>& key();
+	static std::set<std::string>& nodes();
+
+	void establish(const uint8_t* remoteNonce);
+	void seal();
+	bool open();
+
+	bool hasFrameForSend() const
+	{
+		return _framePos < _frame.size();
+	}
+
+	bool readFromSocket() override;
+	bool writeToSocket() override;
+
+public:
+	EncryptedConnection() = delete;
+	EncryptedConnection(const EncryptedConnection&) = delete;
+	EncryptedConnection& operator=(const EncryptedConnection&) = delete;
+	EncryptedConnection(EncryptedConnection&& tmp) noexcept = delete;
+	EncryptedConnection& operator=(EncryptedConnection&& tmp) noexcept = delete;
+
+	EncryptedConnection(const std::shared_ptr<Transport>& transport, int fd, const sockaddr_in& cliaddr, bool outgoing);
+	~EncryptedConnection() override;
+
+	void watch(epoll_event& ev) override;
+
+	bool processing() override;
+
+	// Shared key of own nodes; encrypted transport is available when it is set
+	static void setKey(const std::vector<uint8_t>& key);
+	static bool hasKey();
+
+	// Own nodes ("host" or "host:port"); outgoing connections only to them are encrypted, others stay plain TCP
+	static void addNode(const std::string& address);
+	static bool isOwnNode(const std::string& host, uint16_t port);
+};
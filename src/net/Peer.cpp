@@ -26,6 +26,7 @@
 #include <transport/messages/OutputConnectionStream.hpp>
 #include <protocol/messages/Verack.hpp>
 #include <transport/messages/MsgContext.hpp>
+#include <transport/messages/WireCache.hpp>
 #include <cassert>
 #include <protocol/messages/SendHeaders.hpp>
 #include <protocol/messages/Ping.hpp>
@@ -46,6 +47,7 @@
 #include <node/AddressManager.hpp>
 #include <protocol/messages/Headers.hpp>
 #include <thread/TaskManager.hpp>
+#include <support/Random.hpp>
 #include "Peer.hpp"
 #include "PeerManager.hpp"
 
@@ -53,7 +55,7 @@ std::atomic_uint64_t Peer::_lastId(0);
 
 Peer::Peer()
 : _id(_lastId.fetch_add(1, std::memory_order_relaxed))
-, _pingNonce(GetRand())
+, _pingNonce(FastRandom().rand64())
 {
 }
 
@@ -92,7 +94,7 @@ void Peer::alive()
 					}
 					else
 					{
-						peer->_pingNonce = GetRand();
+						peer->_pingNonce = FastRandom().rand64();
 						peer->_context->transmit(protocol::message::Ping(peer->_pingNonce));
 					}
 					peer->_pingTimer->prolong(peer->pingInterval());
@@ -181,6 +183,9 @@ void Peer::ReceiveHeaders(
 	const std::vector<std::shared_ptr<BlockHeader>>& headers
 )
 {
+	// Whole batch is rejected before anything is inserted
+	Blockchain::checkHeaders(headers);
+
 	std::vector<protocol::InventoryVector> inventory;
 	for (auto& header : headers)
 	{
@@ -266,8 +271,13 @@ void Peer::SendBlocks(
 	auto blocks = Blockchain::getBlocks(locatorHashes, stopHash);
 	for (auto& block : blocks)
 	{
-		protocol::message::Block msgBlock(std::move(block));
-		_context->transmit(msgBlock);
+		_context->transmit(WireCache::get(
+			protocol::InventoryVector(protocol::InventoryVector::Type::MSG_BLOCK, block->hash()),
+			[&block]
+			{
+				return WireMessage::build(protocol::message::Block(block));
+			}
+		));
 	}
 }
 
@@ -329,10 +339,16 @@ void Peer::ReceiveInventory(
 		switch (item.type())
 		{
 			case protocol::InventoryVector::Type::MSG_TX:
-				if (auto tx = Blockchain::getTx(item.hash()))
+				if (auto wire = WireCache::get(
+					item,
+					[&item]() -> std::shared_ptr<const WireMessage>
+					{
+						auto tx = Blockchain::getTx(item.hash());
+						return tx ? WireMessage::build(protocol::message::Tx(tx)) : nullptr;
+					}
+				))
 				{
-					protocol::message::Tx msgTx(tx);
-					_context->transmit(msgTx);
+					_context->transmit(wire);
 				}
 				else
 				{
@@ -341,10 +357,16 @@ void Peer::ReceiveInventory(
 				break;
 
 			case protocol::InventoryVector::Type::MSG_BLOCK:
-				if (auto block = Blockchain::getBlock(item.hash()))
+				if (auto wire = WireCache::get(
+					item,
+					[&item]() -> std::shared_ptr<const WireMessage>
+					{
+						auto block = Blockchain::getBlock(item.hash());
+						return block ? WireMessage::build(protocol::message::Block(block)) : nullptr;
+					}
+				))
 				{
-					protocol::message::Block msgBlock(block);
-					_context->transmit(msgBlock);
+					_context->transmit(wire);
 				}
 				else
 				{
@@ -28,7 +28,7 @@ std::shared_ptr<Peer> PeerManager::newPeer()
 {
 	std::shared_ptr<Peer> peer(new Peer(), [](Peer*p){delete p;});
 
-	std::lock_guard <std::mutex> lockGuard(getInstance()._mutexPeers);
+	std::lock_guard<NamedMutex> lockGuard(getInstance()._mutexPeers);
 
 	getInstance()._peers.emplace(peer);
 	getInstance()._peersById.emplace(peer->id(), peer);
@@ -38,7 +38,7 @@ std::shared_ptr<Peer> PeerManager::newPeer()
 
 std::shared_ptr <Peer> PeerManager::peerById(Peer::Id id)
 {
-	std::lock_guard <std::mutex> lockGuard(getInstance()._mutexPeersById);
+	std::lock_guard<NamedMutex> lockGuard(getInstance()._mutexPeersById);
 	auto i = getInstance()._peersById.find(id);
 
 	if (i != getInstance()._peersById.end())
@@ -60,7 +60,7 @@ void PeerManager::closePeer(const std::shared_ptr<Peer>& peer)
 		return;
 	}
 
-	std::lock_guard <std::mutex> lockGuard(getInstance()._mutexPeers);
+	std::lock_guard<NamedMutex> lockGuard(getInstance()._mutexPeers);
 
 	auto i = getInstance()._peers.find(peer);
 	if (i == getInstance()._peers.end())
@@ -73,7 +73,7 @@ void PeerManager::closePeer(const std::shared_ptr<Peer>& peer)
 
 void PeerManager::forEach(const std::function<void(const std::shared_ptr <Peer>&)>& handler)
 {
-	std::lock_guard <std::mutex> lockGuard(getInstance()._mutexPeers);
+	std::lock_guard<NamedMutex> lockGuard(getInstance()._mutexPeers);
 
 	for (auto& peer : getInstance()._peers)
 	{
@@ -29,6 +29,7 @@
 #include <memory>
 #include <unordered_set>
 #include <net/Peer.hpp>
+#include <thread/NamedMutex.hpp>
 
 class PeerManager final
 {
@@ -58,11 +59,11 @@ private:
 
 	/// Peers pool
 	std::unordered_set<std::shared_ptr<Peer>, PeerHash> _peers;
-	std::mutex _mutexPeers;
+	NamedMutex _mutexPeers{"PeerManager::peers"};
 
 	/// id => peer
 	std::unordered_map<Peer::Id, const std::weak_ptr<Peer>> _peersById;
-	std::mutex _mutexPeersById;
+	NamedMutex _mutexPeersById{"PeerManager::peersById"};
 
 public:
 
@@ -22,6 +22,7 @@
 
 // Blockchain.cpp
 
+#include <algorithm>
 #include <fstream>
 #include <serialization/SerializationWrapper.hpp>
 #include <other/HashStreams.hpp>
@@ -58,6 +59,16 @@ void Blockchain::init(const Setting& setting)
 	am._path = setting.getAs<SStr>("mempool").value();
 	am._genesisBlockHash = setting.getAs<SStr>("genesis").value();
 
+	if (setting.has("powLimit"))
+	{
+		am._powLimit = std::stoul(setting.getAs<SStr>("powLimit").value(), nullptr, 16);
+	}
+
+	if (setting.has("retargetInterval"))
+	{
+		am._retargetInterval = setting.getAs<SInt>("retargetInterval").value();
+	}
+
 	am._initialized = true;
 
 	load();
@@ -235,6 +246,22 @@ bool Blockchain::hasBlockHeader(const uint256& hash)
 	return am._blockIds.find(hash) != am._blockIds.end();
 }
 
+void Blockchain::checkHeaders(const std::vector<std::shared_ptr<BlockHeader>>& headers)
+{
+	auto& am = getInstance();
+
+	if (headers.empty())
+	{
+		return;
+	}
+
+	// Height is known only if batch continues main chain (or starts from genesis)
+	auto prev = getBlockHeader(headers.front()->prev());
+	size_t height = headers.front()->prev().isNull() ? 0 : (prev && prev->inChain() ? prev->height() + 1 : -1);
+
+	BlockHeader::checkSequence(headers, prev, height, am._powLimit, am._retargetInterval);
+}
+
 bool Blockchain::addBlockHeader(const std::shared_ptr<BlockHeader>& header)
 {
 	auto& am = getInstance();
@@ -403,7 +430,13 @@ bool Blockchain::addBlock(const std::shared_ptr<Block>& block)
 
 	auto hash = block->hash();
 
-	auto merkle = MerkleRoot(block->txList()->begin(), block->txList()->end());
+	if (!block->checkProofOfWork() || BlockHeader::target(am._powLimit) < BlockHeader::target(block->bits()))
+	{
+		return false;
+	}
+
+	// Txids are computed here in one batch and cached, as they are the leaves of merkle tree
+	auto merkle = MerkleRoot(Transaction::computeHashes(*block->txList()));
 
 	if (block->merkle() != merkle)
 	{
@@ -442,7 +475,7 @@ bool Blockchain::connectToAncestor(size_t blockId)
 		if (block->hash() != getGenezisBlockHash() || !block->prev().isNull())
 		{
 			// New block is orphan
-			am._orphanBlocks.emplace(block->prev(), blockId);
+			am._orphanBlocks[block->prev()].push_back(blockId);
 			return false;
 		}
 
@@ -467,7 +500,7 @@ bool Blockchain::connectToAncestor(size_t blockId)
 		if (!prevBlock)
 		{
 			// New block is orphan
-			am._orphanBlocks.emplace(block->prev(), blockId);
+			am._orphanBlocks[block->prev()].push_back(blockId);
 			return false;
 		}
 
@@ -480,13 +513,14 @@ bool Blockchain::connectToAncestor(size_t blockId)
 
 		// Remove from orphans list
 		{
-			auto range = am._orphanBlocks.equal_range(block->prev());
-			for (auto i = range.first; i != range.second;)
+			auto i = am._orphanBlocks.find(block->prev());
+			if (i != am._orphanBlocks.end())
 			{
-				if (i->second == blockId)
+				auto& ids = i->second;
+				ids.erase(std::remove(ids.begin(), ids.end(), blockId), ids.end());
+				if (ids.empty())
 				{
-					am._orphanBlocks.erase(i);
-					break;
+					am._orphanBlocks.erase(block->prev());
 				}
 			}
 		}
@@ -532,14 +566,17 @@ bool Blockchain::connectToAncestor(size_t blockId)
 	// Find descendants
 	{
 		descendants:
-		auto range = am._orphanBlocks.equal_range(block->hash());
-		for (auto i = range.first; i != range.second;)
+		auto i = am._orphanBlocks.find(block->hash());
+		if (i != am._orphanBlocks.end())
 		{
-			TaskManager::enqueue(
-				[blockId = i->second] {
-					Blockchain::connectToAncestor(blockId);
-				}
-			);
+			for (auto blockId : i->second)
+			{
+				TaskManager::enqueue(
+					[blockId] {
+						Blockchain::connectToAncestor(blockId);
+					}
+				);
+			}
 		}
 	}
 
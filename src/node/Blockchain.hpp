@@ -32,6 +32,7 @@
 #include <utils/Timer.hpp>
 #include <protocol/types/InventoryVector.hpp>
 #include <protocol/types/BlockTransactions.hpp>
+#include <types/Uint256Map.hpp>
 
 class Blockchain final
 {
@@ -62,20 +63,22 @@ private:
 
 	std::string _path = "mempool.dat";
 	uint256 _genesisBlockHash;
+	uint32_t _powLimit = 0x1d00ffff; // easiest allowed target, compact
+	size_t _retargetInterval = 0; // difficulty may change only at heights multiple of it (0 - at any)
 
 	bool _initialized = false;
 
 	std::vector<std::shared_ptr<BlockHeader>> _blocks; // blocks
 
-	std::unordered_map<uint256, size_t> _blockIds; // block id by block hash
+	Uint256Map<size_t> _blockIds; // block id by block hash
 	std::unordered_map<size_t, const uint256&> _blockHashes; // block hash by block id
-	std::unordered_multimap<uint256, size_t> _orphanBlocks; // prev block hash to current block id
+	Uint256Map<std::vector<size_t>> _orphanBlocks; // prev block hash to ids of blocks waiting for it
 
-	std::unordered_map<uint256, size_t> _merkles; // block id by merkle
+	Uint256Map<size_t> _merkles; // block id by merkle
 	std::unordered_map<size_t, std::vector<size_t>> _merkleTree; // id of transactions of block
 
 	std::vector<std::shared_ptr<Transaction>> _transactions; // transactions
-	std::unordered_map<uint256, size_t> _txIds; // tx id by tx hash
+	Uint256Map<size_t> _txIds; // tx id by tx hash
 	std::unordered_map<size_t, const uint256&> _txHashes; // tx hash by tx id
 
 	std::vector<size_t> _mainChain;
@@ -107,6 +110,10 @@ public:
 
 	static void filterKnownInventory(std::vector<protocol::InventoryVector>& list);
 
+	// Validates whole batch of headers (continuity, proof of work, retarget heights if configured)
+	// before any of them is added; throws on first invalid header
+	static void checkHeaders(const std::vector<std::shared_ptr<BlockHeader>>& headers);
+
 	static bool hasBlockHeader(const uint256& hash);
 	static bool addBlockHeader(const std::shared_ptr<BlockHeader>& header);
 	static std::shared_ptr<BlockHeader> getBlockHeader(const uint256& hash);
@@ -27,6 +27,9 @@
 #include <thread/Thread.hpp>
 #include <net/PeerManager.hpp>
 #include <transport/messages/MsgContext.hpp>
+#include <transport/messages/WireCache.hpp>
+#include <transport/http/HttpContext.hpp>
+#include <telemetry/OpenMetrics.hpp>
 #include <cassert>
 #include <protocol/messages/Tx.hpp>
 #include <protocol/messages/Block.hpp>
@@ -118,6 +121,42 @@ void Node::up()
 		}
 	}
 
+	// Up metrics exposition (OpenMetrics text for monitoring scrapers)
+	if (auto transport = Transports::get("metrics"))
+	{
+		if (!transport->enable())
+		{
+			throw std::runtime_error("Can't enable transport 'metrics'");
+		}
+		try
+		{
+			transport->bindHandler(
+				"/metrics",
+				std::make_shared<ServerTransport::Handler>(
+					[](const std::shared_ptr<Context>& context)
+					{
+						auto httpContext = std::dynamic_pointer_cast<HttpContext>(context);
+						if (!httpContext)
+						{
+							throw std::runtime_error("Bad context-type");
+						}
+
+						OpenMetrics::render(
+							[&httpContext](const char* data, size_t size)
+							{
+								httpContext->transmit(data, size, OpenMetrics::CONTENT_TYPE, false);
+							}
+						);
+					}
+				)
+			);
+		}
+		catch (const std::exception& exception)
+		{
+			throw std::runtime_error(std::string() + "Can't bind uri '/metrics' on transport 'metrics': " + exception.what());
+		}
+	}
+
 	connectToPeers();
 }
 
@@ -136,6 +175,12 @@ void Node::down()
 		transport->disable();
 	}
 	_rpc.reset();
+
+	// Down metrics exposition
+	if (auto transport = Transports::get("metrics"))
+	{
+		transport->disable();
+	}
 }
 
 void Node::connectToPeers()
@@ -216,6 +261,9 @@ void Node::announceTx(const std::shared_ptr<Transaction>& tx) const
 	tx->Serialize(s);
 	protocol::InventoryVector item(protocol::InventoryVector::Type::MSG_TX, s.hash());
 
+	// Peers request announced object, all of them get the same image
+	WireCache::put(item, WireMessage::build(protocol::message::Tx(tx)));
+
 	PeerManager::forEach(
 		[&item]
 		(const std::shared_ptr<Peer>& peer)
@@ -231,6 +279,9 @@ void Node::announceBlock(const std::shared_ptr<Block>& block) const
 	block->Serialize(s);
 	protocol::InventoryVector item(protocol::InventoryVector::Type::MSG_BLOCK, s.hash());
 
+	// Peers request announced object, all of them get the same image
+	WireCache::put(item, WireMessage::build(protocol::message::Block(block)));
+
 	PeerManager::forEach(
 		[&item]
 		(const std::shared_ptr<Peer>& peer)
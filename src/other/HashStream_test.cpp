@@ -24,6 +24,7 @@
 
 #include "HashStream.hpp"
 #include "HashStreams.hpp"
+#include "HashWriter.hpp"
 
 #include <gtest/gtest.h>
 
@@ -42,3 +43,17 @@ TEST(CalcHelper, works)
 		EXPECT_EQ(expectedHash, hash);
 	}
 }
+
+TEST(HashWriter, works)
+{
+	uint32_t value = 5;
+	uint256 zero;
+
+	CHashWriter hw(SerializationActionType::SER_GETHASH, 0);
+	hw << value << zero;
+
+	CHashWriter empty(SerializationActionType::SER_GETHASH, 0);
+
+	EXPECT_EQ(hw.GetHash(), uint256(Hex::Parse("c362bda3 d0f40435 281b6a92 2a3ef49d 3cc623af 2b498d0f 41d33783 2eb4c408")));
+	EXPECT_NE(hw.GetHash(), empty.GetHash());
+}
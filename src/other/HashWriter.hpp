@@ -42,20 +42,21 @@
 
 #include <types/Blobs.hpp>
 #include <serialization/SerializationActionType.hpp>
-#include "Hash256.hpp"
+#include <crypto/sha256.h>
+#include "HashStreamBuffer.hpp"
 
-/** A writer stream (for serialization) that computes a 256-bit hash. */
-class CHashWriter : public std::ostream
+/** A writer stream (for serialization) that computes a 256-bit hash (double SHA-256).
+ *  Data reaches hasher through stream buffer, because ::Serialize writes via std::ostream */
+class CHashWriter : private HashStreamBuffer<CSHA256>, public std::ostream
 {
 private:
-	CHash256 ctx;
-
 	const SerializationActionType nType;
 	const int nVersion;
 public:
 
 	CHashWriter(SerializationActionType nTypeIn, int nVersionIn)
-	: nType(nTypeIn)
+	: std::ostream(static_cast<HashStreamBuffer<CSHA256>*>(this))
+	, nType(nTypeIn)
 	, nVersion(nVersionIn)
 	{
 	}
@@ -69,17 +70,10 @@ public:
 		return nVersion;
 	}
 
-	void write(const char *pch, size_t size)
-	{
-		ctx.Write((const unsigned char*)pch, size);
-	}
-
 	// invalidates the object
 	uint256 GetHash()
 	{
-		uint256 result;
-		ctx.Finalize((unsigned char*)result.data());
-		return result;
+		return hash();
 	}
 
 	template<typename T>
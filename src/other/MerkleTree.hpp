@@ -28,72 +28,178 @@
 #include <crypto/sha256.h>
 #include <types/Blobs.hpp>
 #include <other/HashStream.hpp>
+#include <algorithm>
 #include <cassert>
+#include <sstream>
+#include <thread>
+#include <type_traits>
 
 template<class Iterator, class Hasher = CSHA256>
 std::vector<uint8_t> MerkleLeaves(Iterator begin, Iterator end)
 {
 	std::vector<uint8_t> hashes;
-	hashes.reserve(end - begin);
 
-	for (auto i = begin; i != end; i++)
+	if constexpr (std::is_same_v<Hasher, CSHA256>)
 	{
-		HashStream<Hasher> hs{};
-		::Serialize(hs, *i);
+		// Serialize all items first, then hash them together in SIMD lanes
+		std::ostringstream oss;
+		std::vector<size_t> offsets{0};
+		for (auto i = begin; i != end; i++)
+		{
+			::Serialize(oss, *i);
+			offsets.push_back(static_cast<size_t>(oss.tellp()));
+		}
 
-		auto& data = hs.digest();
-		hashes.insert(hashes.end(), data.begin(), data.end());
+		auto data = oss.str();
+		auto count = offsets.size() - 1;
+
+		std::vector<const uint8_t*> inputs(count);
+		std::vector<size_t> lengths(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			inputs[i] = reinterpret_cast<const uint8_t*>(data.data()) + offsets[i];
+			lengths[i] = offsets[i + 1] - offsets[i];
+		}
+
+		hashes.resize(count * Hasher::OUTPUT_SIZE);
+		SHA256DMulti(hashes.data(), inputs.data(), lengths.data(), count);
+	}
+	else
+	{
+		hashes.reserve(end - begin);
+
+		for (auto i = begin; i != end; i++)
+		{
+			HashStream<Hasher> hs{};
+			::Serialize(hs, *i);
+
+			auto& data = hs.digest();
+			hashes.insert(hashes.end(), data.begin(), data.end());
+		}
 	}
 
 	return hashes;
 }
 
+// Hashes `pairs` adjacent pairs of hashes: out[i] = H(H(in[2i] || in[2i+1])); out may be equal to in
 template<class Hasher = CSHA256>
-uint256 MerkleRoot(std::vector<uint8_t> hashes)
+void MerkleHashPairs(uint8_t* out, const uint8_t* in, size_t pairs)
 {
-	if ((hashes.size() > Hasher::OUTPUT_SIZE) && (hashes.size() / Hasher::OUTPUT_SIZE) & 1u)
+	if constexpr (std::is_same_v<Hasher, CSHA256>)
 	{
-		hashes.reserve(hashes.size() + Hasher::OUTPUT_SIZE);
+		// Double SHA256 of 64-byte blocks, computed by multi-lane kernels when available
+		SHA256D64(out, in, pairs);
 	}
-
-	Hasher hasher;
-	while (hashes.size() > Hasher::OUTPUT_SIZE)
+	else
 	{
-		if ((hashes.size() / Hasher::OUTPUT_SIZE) & 1u)
-		{
-			std::copy(hashes.end() - Hasher::OUTPUT_SIZE, hashes.end(), std::back_inserter(hashes));
-		}
-
-		auto dst = hashes.data();
-		auto src = hashes.data();
-
-		auto end = hashes.data() + hashes.size();
-
-		for (;;)
+		Hasher hasher;
+		for (size_t i = 0; i < pairs; ++i)
 		{
 			hasher
 				.Reset()
-				.Write(src, Hasher::OUTPUT_SIZE * 2)
-				.Finalize(dst);
+				.Write(in, Hasher::OUTPUT_SIZE * 2)
+				.Finalize(out);
 			hasher
 				.Reset()
-				.Write(dst, Hasher::OUTPUT_SIZE)
-				.Finalize(dst);
-			src += Hasher::OUTPUT_SIZE * 2;
-			dst += Hasher::OUTPUT_SIZE;
-			if (src >= end) break;
+				.Write(out, Hasher::OUTPUT_SIZE)
+				.Finalize(out);
+			in += Hasher::OUTPUT_SIZE * 2;
+			out += Hasher::OUTPUT_SIZE;
 		}
-		hashes.resize(hashes.size() / 2);
 	}
+}
+
+// Replaces level of `count` hashes by the next level in place and returns its size.
+// Odd level is completed by duplicating the last hash, so the buffer must have room for one more
+template<class Hasher = CSHA256>
+size_t MerkleReduceLevel(uint8_t* hashes, size_t count)
+{
+	if (count & 1u)
+	{
+		std::copy(hashes + (count - 1) * Hasher::OUTPUT_SIZE, hashes + count * Hasher::OUTPUT_SIZE, hashes + count * Hasher::OUTPUT_SIZE);
+		++count;
+	}
+	MerkleHashPairs<Hasher>(hashes, hashes, count / 2);
+	return count / 2;
+}
+
+// Trees smaller than this many leaves per thread are computed by the calling thread only
+constexpr size_t MERKLE_LEAVES_PER_THREAD = 1024;
+
+// Merkle root of concatenated leaf hashes.
+// With threads > 1 a big tree is split into aligned subtrees of 2^k leaves, computed concurrently;
+// odd levels at the right edge are duplicated the same way, so the root does not depend on the split
+template<class Hasher = CSHA256>
+uint256 MerkleRoot(std::vector<uint8_t> hashes, size_t threads = 1)
+{
+	constexpr auto size = Hasher::OUTPUT_SIZE;
 
 	uint256 hash;
-	std::copy(hashes.begin(), hashes.end(), hash.begin());
+
+	auto count = hashes.size() / size;
+	if (count == 0)
+	{
+		return hash;
+	}
+
+	// Room for duplicate of the last hash of odd level
+	hashes.resize((count + 1) * size);
+
+	if (threads > 1 && count >= threads * MERKLE_LEAVES_PER_THREAD)
+	{
+		// Largest subtree such that every thread gets at least one
+		size_t height = 0;
+		while ((size_t(2) << height) * threads <= count)
+		{
+			++height;
+		}
+		const size_t leaves = size_t(1) << height;
+		const size_t subtrees = (count + leaves - 1) / leaves;
+
+		std::vector<uint8_t> roots((subtrees + 1) * size);
+
+		auto worker = [&](size_t first)
+		{
+			for (auto subtree = first; subtree < subtrees; subtree += threads)
+			{
+				auto data = hashes.data() + subtree * leaves * size;
+				auto n = std::min(leaves, count - subtree * leaves);
+				for (size_t level = 0; level < height; ++level)
+				{
+					n = MerkleReduceLevel<Hasher>(data, n);
+				}
+				std::copy(data, data + size, roots.data() + subtree * size);
+			}
+		};
+
+		std::vector<std::thread> pool;
+		pool.reserve(threads - 1);
+		for (size_t i = 1; i < threads; ++i)
+		{
+			pool.emplace_back(worker, i);
+		}
+		worker(0);
+		for (auto& thread : pool)
+		{
+			thread.join();
+		}
+
+		hashes.swap(roots);
+		count = subtrees;
+	}
+
+	while (count > 1)
+	{
+		count = MerkleReduceLevel<Hasher>(hashes.data(), count);
+	}
+
+	std::copy(hashes.begin(), hashes.begin() + size, hash.begin());
 
 	return hash;
 }
 
 template<class Iterator, class Hasher = CSHA256>
-uint256 MerkleRoot(Iterator dataBegin, Iterator dataEnd)
+uint256 MerkleRoot(Iterator dataBegin, Iterator dataEnd, size_t threads = 1)
 {
-	return MerkleRoot(MerkleLeaves(dataBegin, dataEnd));
+	return MerkleRoot<Hasher>(MerkleLeaves<Iterator, Hasher>(dataBegin, dataEnd), threads);
 }
@@ -199,3 +199,46 @@ TEST_F(Merkle, Tree)
 		EXPECT_EQ(expected.str(), actual.str());
 	}
 }
+
+TEST(MerkleRoot, LevelByLevel)
+{
+	// Straightforward computation: hash pairs one by one, duplicate last hash of odd level
+	auto reference = [](std::vector<uint256> level)
+	{
+		while (level.size() > 1)
+		{
+			if (level.size() & 1u)
+			{
+				level.push_back(level.back());
+			}
+			std::vector<uint256> next(level.size() / 2);
+			for (size_t i = 0; i < next.size(); ++i)
+			{
+				CSHA256().Write(level[2 * i].data(), 32).Write(level[2 * i + 1].data(), 32).Finalize(next[i].data());
+				CSHA256().Write(next[i].data(), 32).Finalize(next[i].data());
+			}
+			level.swap(next);
+		}
+		return level.front();
+	};
+
+	for (size_t count : {1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 100, 5000, 9001})
+	{
+		std::vector<uint256> leaves(count);
+		std::vector<uint8_t> data;
+		for (size_t i = 0; i < count; ++i)
+		{
+			for (size_t j = 0; j < 32; ++j)
+			{
+				leaves[i].data()[j] = static_cast<uint8_t>(i * 13 + j + (i >> 8));
+			}
+			std::copy(leaves[i].begin(), leaves[i].end(), std::back_inserter(data));
+		}
+
+		auto expected = reference(leaves);
+
+		EXPECT_EQ(MerkleRoot(data).str(), expected.str()) << count << " leaves";
+		EXPECT_EQ(MerkleRoot(data, 3).str(), expected.str()) << count << " leaves, 3 threads";
+		EXPECT_EQ(MerkleRoot(data, 4).str(), expected.str()) << count << " leaves, 4 threads";
+	}
+}
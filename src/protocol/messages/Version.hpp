@@ -60,7 +60,7 @@ public:
 	, _timestamp(std::time(nullptr))
 	, _addrRecv(std::move(addrRecv))
 	, _addrFrom(std::move(addrFrom))
-	, _nonce(GetRand(UINT64_MAX))
+	, _nonce(FastRandom().rand64())
 	, _userAgent(userAgent)
 	, _startHeight(startHeight)
 	, _relay(relay)
@@ -50,6 +50,9 @@ private:
 	Direct _direct = Direct::Undefined;
 
 public:
+	/// Upper limit of payload size accepted from network
+	static constexpr uint32_t MAX_PAYLOAD_SIZE = 0x02000000; // 32 MiB
+
 	Message() = default; // Default-constructor
 	Message(Message&&) noexcept = default; // Move-constructor
 	Message(const Message&) = delete; // Copy-constructor
@@ -22,9 +22,18 @@
 
 // Rpc.cpp
 
+#include <sstream>
+#include <crypto/sha256.h>
 #include <transport/http/HttpContext.hpp>
 #include <transport/LpsContext.hpp>
 #include <transport/Transports.hpp>
+#include <transport/messages/MsgContext.hpp>
+#include <net/PeerManager.hpp>
+#include <serialization/SArr.hpp>
+#include <serialization/SObj.hpp>
+#include <telemetry/Profiler.hpp>
+#include <telemetry/Tracer.hpp>
+#include <thread/Thread.hpp>
 #include "Rpc.hpp"
 
 RPC::RPC(const std::shared_ptr<Node>& node)
@@ -62,6 +71,37 @@ void RPC::handler(const std::shared_ptr<Context>& context)
 
 		auto& input = rawInput.as<SObj>();
 
+		std::string method;
+		input.trylookup("method", method);
+
+		if (method == "getpeerinfo")
+		{
+			lpsContext->out(getPeerInfo());
+			goto done;
+		}
+		if (method == "getnettotals")
+		{
+			lpsContext->out(getNetTotals());
+			goto done;
+		}
+		if (method == "getcryptoinfo")
+		{
+			lpsContext->out(getCryptoInfo());
+			goto done;
+		}
+		if (method == "dumptrace")
+		{
+			lpsContext->out(dumpTrace());
+			goto done;
+		}
+		if (method == "profile")
+		{
+			lpsContext->out(profile(input));
+			goto done;
+		}
+
+		throw std::runtime_error("Unknown method '" + method + "'");
+
 //		std::string sid;
 //		if (!input.hasOf<SNull>("sid"))
 //		{
@@ -267,3 +307,102 @@ void RPC::handler(const std::shared_ptr<Context>& context)
 
 	lpsContext->send();
 }
+
+SVal RPC::getPeerInfo()
+{
+	SArr peers;
+
+	PeerManager::forEach(
+		[&peers]
+		(const std::shared_ptr<Peer>& peer)
+		{
+			auto context = peer->getContext();
+			if (!context)
+			{
+				return;
+			}
+
+			auto info = context->stats().toSVal();
+			auto& obj = info.as<SObj>();
+			obj.emplace("id", peer->id());
+			obj.emplace("version", peer->version());
+			if (auto connection = context->connection())
+			{
+				obj.emplace("addr", connection->name());
+			}
+
+			peers.emplace_back(std::move(info));
+		}
+	);
+
+	return peers;
+}
+
+SVal RPC::getNetTotals()
+{
+	return MsgStats::totals();
+}
+
+SVal RPC::getCryptoInfo()
+{
+	SObj obj;
+	obj.emplace("sha256", SHA256Implementation());
+	return obj;
+}
+
+SVal RPC::dumpTrace()
+{
+	if (!Tracer::enabled())
+	{
+		throw std::runtime_error("Tracing is disabled");
+	}
+
+	auto path = Tracer::dumpToFile();
+	if (path.empty())
+	{
+		throw std::runtime_error("Can't write trace dump");
+	}
+
+	SObj obj;
+	obj.emplace("path", path);
+	return obj;
+}
+
+SVal RPC::profile(const SObj& input)
+{
+	uint32_t seconds = 10;
+	if (input.has("seconds"))
+	{
+		input.lookup("seconds", seconds);
+	}
+	if (seconds < 1 || seconds > 300)
+	{
+		throw std::runtime_error("Duration of profiling must be in range 1..300 seconds");
+	}
+
+	uint32_t frequency = 99;
+	if (input.has("frequency"))
+	{
+		input.lookup("frequency", frequency);
+	}
+
+	if (!Profiler::start(frequency))
+	{
+		throw std::runtime_error("Profiling is already in progress");
+	}
+
+	// Worker is released for the duration of sampling
+	Thread::self()->postpone(std::chrono::seconds(seconds));
+
+	Profiler::stop();
+
+	std::ostringstream oss;
+	Profiler::folded(oss);
+
+	SObj obj;
+	obj.emplace("seconds", seconds);
+	obj.emplace("samples", Profiler::samples());
+	obj.emplace("dropped", Profiler::dropped());
+	obj.emplace("folded", oss.str());
+	return obj;
+}
@@ -28,6 +28,8 @@
 #include <utils/Shareable.hpp>
 #include <log/LogHolder.hpp>
 #include <utils/Context.hpp>
+#include <serialization/SObj.hpp>
+#include <serialization/SVal.hpp>
 
 class Node;
 
@@ -36,6 +38,19 @@ class RPC final : public Shareable<RPC>, public LogHolder
 private:
 	std::weak_ptr<Node> _node;
 
+	// Network statistics methods (names and fields follow bitcoind's RPC)
+	static SVal getPeerInfo();
+	static SVal getNetTotals();
+
+	// Implementations of crypto primitives selected at startup
+	static SVal getCryptoInfo();
+
+	// Writes Chrome trace-event JSON of task tracing, returns path of file
+	static SVal dumpTrace();
+
+	// Samples CPU for requested duration, returns stacks in folded (flamegraph) format
+	static SVal profile(const SObj& input);
+
 public:
 	RPC() = delete; // Default-constructor
 	RPC(RPC&&) noexcept = delete; // Move-constructor
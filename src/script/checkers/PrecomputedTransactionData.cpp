@@ -26,7 +26,9 @@
 #include <other/hash.h>
 #include <other/HashWriter.hpp>
 #include "PrecomputedTransactionData.hpp"
+#include "TransactionSignatureSerializer.hpp"
 #include <serialization/SerializationActionType.hpp>
+#include <sstream>
 
 template<class T>
 uint256 GetPrevoutHash(const T& tx)
@@ -62,16 +64,72 @@ uint256 GetOutputsHash(const T& tx)
 }
 
 template<class T>
-PrecomputedTransactionData::PrecomputedTransactionData(const T& tx)
+void PrecomputeLegacy(const T& tx, PrecomputedTransactionData& data)
 {
-	// Cache is calculated only for transactions with witness
-	if (tx.HasWitness())
+	if (tx.txIns().empty())
+	{
+		return;
+	}
+
+	// Index of input out of range - scripts of all inputs are blanked out
+	CTransactionSignatureSerializer<T> txBlank(
+		tx, Script(), tx.txIns().size(), static_cast<Flags<SignatureHashType>::type>(SignatureHashType::SIGHASH_ALL)
+	);
+
+	std::ostringstream oss;
+	txBlank.Serialize(oss);
+	data.legacyBlank = oss.str();
+
+	// Layout of inputs in blank serialization
+	std::ostringstream prefix;
+	::Serialize(prefix, tx.version());
+	uintV len = tx.txIns().size();
+	len.Serialize(prefix);
+
+	data.legacyInputs.reserve(tx.txIns().size());
+	for (const auto& txIn : tx.txIns())
+	{
+		::Serialize(prefix, txIn.prevOut());
+		size_t script = prefix.tellp();
+		::Serialize(prefix, Script());
+		size_t sequence = prefix.tellp();
+		::Serialize(prefix, txIn.sequence());
+		data.legacyInputs.push_back({script, sequence});
+	}
+
+	// Layout must be the same as serializer makes it, else fall back to common way
+	const auto& inputs = prefix.str();
+	if (data.legacyBlank.compare(0, inputs.size(), inputs) != 0)
 	{
-		hashPrevouts = GetPrevoutHash(tx);
-		hashSequence = GetSequenceHash(tx);
-		hashOutputs = GetOutputsHash(tx);
-		ready = true;
+		data.legacyInputs.clear();
+		return;
 	}
+
+	const auto blank = reinterpret_cast<const uint8_t*>(data.legacyBlank.data());
+
+	CSHA256 hasher;
+	size_t hashed = 0;
+	for (size_t i = 0; i < data.legacyInputs.size(); i += PrecomputedTransactionData::LEGACY_MIDSTATE_INTERVAL)
+	{
+		auto offset = data.legacyInputs[i].script;
+		hasher.Write(blank + hashed, offset - hashed);
+		hashed = offset;
+		data.legacyMidstates.push_back(hasher);
+	}
+
+	data.legacyReady = true;
+}
+
+template<class T>
+PrecomputedTransactionData::PrecomputedTransactionData(const T& tx)
+{
+	// Cache is calculated once for whole transaction and shared by checks of all its inputs
+	hashPrevouts = GetPrevoutHash(tx);
+	hashSequence = GetSequenceHash(tx);
+	hashOutputs = GetOutputsHash(tx);
+	ready = true;
+
+	PrecomputeLegacy(tx, *this);
 }
 
 // explicit instantiation
@@ -41,14 +41,34 @@
 
 
 #include <types/Blobs.hpp>
+#include <crypto/sha256.h>
+#include <string>
+#include <vector>
 
 struct PrecomputedTransactionData
 {
+	// BIP143 signature hash components
     uint256 hashPrevouts;
 	uint256 hashSequence;
 	uint256 hashOutputs;
     bool ready = false;
 
+	// Legacy signature hash: transaction serialized with all scripts of inputs blanked out.
+	// Signature hash of input is this serialization with script code of input instead of
+	// its blank script, so hash of common prefix is saved each LEGACY_MIDSTATE_INTERVAL inputs
+	static constexpr size_t LEGACY_MIDSTATE_INTERVAL = 32;
+
+	struct LegacyInputOffsets
+	{
+		size_t script;   // Offset of blank script of input
+		size_t sequence; // Offset of sequence of input (end of blank script)
+	};
+
+	std::string legacyBlank;
+	std::vector<LegacyInputOffsets> legacyInputs;
+	std::vector<CSHA256> legacyMidstates; // State after hashing up to script of input (i * LEGACY_MIDSTATE_INTERVAL)
+	bool legacyReady = false;
+
     template <class T>
     explicit PrecomputedTransactionData(const T& tx);
 };
@@ -27,6 +27,8 @@
 #include "SignatureHash.hpp"
 #include "SignatureHashType.hpp"
 #include "TransactionSignatureSerializer.hpp"
+#include <crypto/sha256.h>
+#include <sstream>
 
 template<class T>
 uint256 SignatureHash(
@@ -124,6 +126,43 @@ uint256 SignatureHash(
 	// Wrapper to serialize only the necessary parts of the transaction being signed
 	CTransactionSignatureSerializer<T> txTmp(tx, scriptCode, nIn, nHashType);
 
+	// All inputs and outputs are signed: use precomputed serialization of transaction,
+	// so only script code of input and tail after it must be hashed
+	if (
+		cache && cache->legacyReady &&
+		!nHashType.isSet(SignatureHashType::SIGHASH_ANYONECANPAY) &&
+		!maskedHashType.isSet(SignatureHashType::SIGHASH_SINGLE) &&
+		!maskedHashType.isSet(SignatureHashType::SIGHASH_NONE)
+	)
+	{
+		const auto blank = reinterpret_cast<const uint8_t*>(cache->legacyBlank.data());
+		const auto& input = cache->legacyInputs[nIn];
+		const auto chunk = nIn / PrecomputedTransactionData::LEGACY_MIDSTATE_INTERVAL;
+		const auto hashed = cache->legacyInputs[chunk * PrecomputedTransactionData::LEGACY_MIDSTATE_INTERVAL].script;
+
+		CSHA256 hasher = cache->legacyMidstates[chunk];
+		hasher.Write(blank + hashed, input.script - hashed);
+
+		std::ostringstream oss;
+		txTmp.SerializeScriptCode(oss);
+		const auto& script = oss.str();
+		hasher.Write(reinterpret_cast<const uint8_t*>(script.data()), script.size());
+
+		hasher.Write(blank + input.sequence, cache->legacyBlank.size() - input.sequence);
+
+		oss.str("");
+		::Serialize(oss, (Flags<SignatureHashType>::type)nHashType);
+		const auto& type = oss.str();
+		hasher.Write(reinterpret_cast<const uint8_t*>(type.data()), type.size());
+
+		uint8_t digest[CSHA256::OUTPUT_SIZE];
+		hasher.Finalize(digest);
+
+		uint256 result;
+		CSHA256().Write(digest, sizeof(digest)).Finalize(result.data());
+		return result;
+	}
+
 	// Serialize and hash
 	CHashWriter ss(SerializationActionType::SER_GETHASH, 0);
 	ss << txTmp << (Flags<SignatureHashType>::type)nHashType;
@@ -0,0 +1,105 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// SignatureHash_test.cpp
+
+#include <blockchain/Transaction.hpp>
+#include "SignatureHash.hpp"
+
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace
+{
+const size_t inputs = 40;
+
+std::string varInt(size_t value)
+{
+	return std::string(1, static_cast<char>(value));
+}
+
+std::string uint32(uint32_t value)
+{
+	std::string result;
+	for (int i = 0; i < 4; ++i)
+	{
+		result.push_back(static_cast<char>(value >> (8 * i)));
+	}
+	return result;
+}
+
+// Legacy transaction with many inputs and two outputs
+std::string rawTransaction()
+{
+	std::string raw = uint32(1) + varInt(inputs);
+	for (size_t i = 0; i < inputs; ++i)
+	{
+		raw += std::string(32, static_cast<char>(i)) + uint32(i);
+		raw += varInt(3) + "\x51\x52" + static_cast<char>(i);
+		raw += uint32(0xffffffff - i);
+	}
+	raw += varInt(2);
+	for (size_t i = 0; i < 2; ++i)
+	{
+		raw += uint32(1000 * (i + 1)) + uint32(0);
+		raw += varInt(3) + "\x51\x52" + static_cast<char>(i);
+	}
+	raw += uint32(0xffffffff) + uint32(0xffffffff) + uint32(0);
+	return raw;
+}
+
+Script scriptCode()
+{
+	std::vector<uint8_t> data{0x76, 0xa9, 0x14};
+	for (uint8_t i = 1; i <= 20; ++i)
+	{
+		data.push_back(i);
+	}
+	data.push_back(0x88);
+	data.push_back(0xac);
+	return Script(data.data(), data.data() + data.size());
+}
+}
+
+TEST(SignatureHash, Precomputed)
+{
+	std::istringstream iss(rawTransaction());
+	Transaction tx;
+	tx.Unserialize(iss);
+
+	PrecomputedTransactionData txdata(tx);
+	EXPECT_TRUE(txdata.ready);
+	EXPECT_TRUE(txdata.legacyReady);
+
+	auto script = scriptCode();
+
+	for (uint32_t type : {0x01, 0x02, 0x03, 0x41, 0x81})
+	{
+		for (unsigned int nIn = 0; nIn < inputs; ++nIn)
+		{
+			EXPECT_EQ(
+				SignatureHash(script, tx, nIn, type, Amount(), SigVersion::BASE),
+				SignatureHash(script, tx, nIn, type, Amount(), SigVersion::BASE, &txdata)
+			) << "input " << nIn << ", type " << type;
+		}
+	}
+}
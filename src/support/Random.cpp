@@ -429,37 +429,61 @@ uint256 GetRandHash()
 	return hash;
 }
 
-//void FastRandomContext::RandomSeed()
-//{
-//	uint256 seed = GetRandHash();
-//	rng.SetKey(seed.begin(), 32);
-//	requires_seed = false;
-//}
-//
-//uint256 FastRandomContext::rand256()
-//{
-//	if (bytebuf_size < 32) {
-//		FillByteBuffer();
-//	}
-//	uint256 ret;
-//	memcpy(ret.begin(), bytebuf + 64 - bytebuf_size, 32);
-//	bytebuf_size -= 32;
-//	return ret;
-//}
-//
-//std::vector<unsigned char> FastRandomContext::randbytes(size_t len)
-//{
-//	std::vector<unsigned char> ret(len);
-//	if (len > 0) {
-//		rng.Output(&ret[0], len);
-//	}
-//	return ret;
-//}
-//
-//FastRandomContext::FastRandomContext(const uint256& seed) : requires_seed(false), bytebuf_size(0), bitbuf_size(0)
-//{
-//	rng.SetKey(seed.begin(), 32);
-//}
+void FastRandomContext::RandomSeed()
+{
+	uint256 seed = GetRandHash();
+	rng.SetKey(seed.begin(), 32);
+	memory_cleanse(seed.begin(), 32);
+	requires_seed = false;
+	output_bytes = 0;
+}
+
+uint256 FastRandomContext::rand256()
+{
+	uint256 ret;
+	randbytes(ret.begin(), 32);
+	return ret;
+}
+
+std::vector<unsigned char> FastRandomContext::randbytes(size_t len)
+{
+	std::vector<unsigned char> ret(len);
+	randbytes(ret.data(), len);
+	return ret;
+}
+
+void FastRandomContext::randbytes(unsigned char* buf, size_t len)
+{
+	// Small amounts from buffer, large ones straight from keystream
+	if (len > sizeof(bytebuf))
+	{
+		Output(buf, len);
+		return;
+	}
+	if (bytebuf_size < len)
+	{
+		FillByteBuffer();
+	}
+	memcpy(buf, bytebuf + sizeof(bytebuf) - bytebuf_size, len);
+	bytebuf_size -= len;
+}
+
+FastRandomContext::FastRandomContext(const uint256& seed)
+: requires_seed(false)
+, deterministic(true)
+, bytebuf_size(0)
+, bitbuf(0)
+, bitbuf_size(0)
+, output_bytes(0)
+{
+	rng.SetKey(seed.begin(), 32);
+}
+
+FastRandomContext& FastRandom()
+{
+	static thread_local FastRandomContext context;
+	return context;
+}
 
 bool Random_SanityCheck()
 {
@@ -510,15 +534,22 @@ bool Random_SanityCheck()
 
 	return true;
 }
-//
-//FastRandomContext::FastRandomContext(bool fDeterministic) : requires_seed(!fDeterministic), bytebuf_size(0), bitbuf_size(0)
-//{
-//	if (!fDeterministic) {
-//		return;
-//	}
-//	uint256 seed;
-//	rng.SetKey(seed.begin(), 32);
-//}
+
+FastRandomContext::FastRandomContext(bool fDeterministic)
+: requires_seed(!fDeterministic)
+, deterministic(fDeterministic)
+, bytebuf_size(0)
+, bitbuf(0)
+, bitbuf_size(0)
+, output_bytes(0)
+{
+	if (!fDeterministic)
+	{
+		return;
+	}
+	uint256 seed;
+	rng.SetKey(seed.begin(), 32);
+}
 
 void RandomInit()
 {
@@ -26,8 +26,13 @@
 
 
 #include <cstdint>
+#include <limits>
 #include <types/Blobs.hpp>
 #include <mutex>
+#include <vector>
+#include <cstring>
+#include <endian.h>
+#include <crypto/chacha20.h>
 
 
 /** Initialize the RNG. */
@@ -81,118 +86,146 @@ uint256 GetRandHash();
 void RandAddSeedSleep();
 
 
-///**
-// * Fast randomness source. This is seeded once with secure random data, but
-// * is completely deterministic and insecure after that.
-// * This class is not thread-safe.
-// */
-//class FastRandomContext
-//{
-//private:
-//	bool requires_seed;
-//	ChaCha20 rng;
-//
-//	unsigned char bytebuf[64];
-//	int bytebuf_size;
-//
-//	uint64_t bitbuf;
-//	int bitbuf_size;
-//
-//	void RandomSeed();
-//
-//	void FillByteBuffer()
-//	{
-//		if (requires_seed)
-//		{
-//			RandomSeed();
-//		}
-//		rng.Output(bytebuf, sizeof(bytebuf));
-//		bytebuf_size = sizeof(bytebuf);
-//	}
-//
-//	void FillBitBuffer()
-//	{
-//		bitbuf = rand64();
-//		bitbuf_size = 64;
-//	}
-//
-//public:
-//	explicit FastRandomContext(bool fDeterministic = false);
-//
-//	/** Initialize with explicit seed (only for testing) */
-//	explicit FastRandomContext(const uint256& seed);
-//
-//	/** Generate a random 64-bit integer. */
-//	uint64_t rand64()
-//	{
-//		if (bytebuf_size < 8)
-//		{ FillByteBuffer(); }
-//		uint64_t ret = ReadLE64(bytebuf + 64 - bytebuf_size);
-//		bytebuf_size -= 8;
-//		return ret;
-//	}
-//
-//	/** Generate a random (bits)-bit integer. */
-//	uint64_t randbits(int bits)
-//	{
-//		if (bits == 0)
-//		{
-//			return 0;
-//		}
-//		else if (bits > 32)
-//		{
-//			return rand64() >> (64 - bits);
-//		}
-//		else
-//		{
-//			if (bitbuf_size < bits)
-//			{ FillBitBuffer(); }
-//			uint64_t ret = bitbuf & (~(uint64_t) 0 >> (64 - bits));
-//			bitbuf >>= bits;
-//			bitbuf_size -= bits;
-//			return ret;
-//		}
-//	}
-//
-//	/** Generate a random integer in the range [0..range). */
-//	uint64_t randrange(uint64_t range)
-//	{
-//		--range;
-//		int bits = CountBits(range);
-//		while (true)
-//		{
-//			uint64_t ret = randbits(bits);
-//			if (ret <= range)
-//			{ return ret; }
-//		}
-//	}
-//
-//	/** Generate random bytes. */
-//	std::vector<unsigned char> randbytes(size_t len);
-//
-//	/** Generate a random 32-bit integer. */
-//	uint32_t rand32()
-//	{ return randbits(32); }
-//
-//	/** generate a random uint256. */
-//	uint256 rand256();
-//
-//	/** Generate a random boolean. */
-//	bool randbool()
-//	{ return randbits(1); }
-//
-//	// Compatibility with the C++11 UniformRandomBitGenerator concept
-//	typedef uint64_t result_type;
-//
-//	static constexpr uint64_t min()
-//	{ return 0; }
-//
-//	static constexpr uint64_t max()
-//	{ return std::numeric_limits<uint64_t>::max(); }
-//
-//	inline uint64_t operator()()
-//	{ return rand64(); }
-//};
+/**
+ * Fast randomness source. This is seeded with secure random data, and is
+ * deterministic between reseeds, which happen after every RESEED_INTERVAL
+ * bytes of output. No locks or syscalls besides of reseeding.
+ * This class is not thread-safe: use FastRandom() for context of current thread.
+ */
+class FastRandomContext
+{
+public:
+	/** Count of output bytes after which context is reseeded from strong RNG */
+	static constexpr uint64_t RESEED_INTERVAL = 1 << 20;
+
+private:
+	bool requires_seed;
+	bool deterministic;
+	ChaCha20 rng;
+
+	/** Several blocks at once for multi-block ChaCha20 kernels */
+	unsigned char bytebuf[512];
+	size_t bytebuf_size;
+
+	uint64_t bitbuf;
+	int bitbuf_size;
+
+	uint64_t output_bytes;
+
+	void RandomSeed();
+
+	void Output(unsigned char* output, size_t bytes)
+	{
+		if (!deterministic && output_bytes >= RESEED_INTERVAL)
+		{
+			requires_seed = true;
+		}
+		if (requires_seed)
+		{
+			RandomSeed();
+		}
+		rng.Output(output, bytes);
+		output_bytes += bytes;
+	}
+
+	void FillByteBuffer()
+	{
+		Output(bytebuf, sizeof(bytebuf));
+		bytebuf_size = sizeof(bytebuf);
+	}
+
+	void FillBitBuffer()
+	{
+		bitbuf = rand64();
+		bitbuf_size = 64;
+	}
+
+public:
+	explicit FastRandomContext(bool fDeterministic = false);
+
+	/** Initialize with explicit seed (only for testing) */
+	explicit FastRandomContext(const uint256& seed);
+
+	/** Generate a random 64-bit integer. */
+	uint64_t rand64()
+	{
+		if (bytebuf_size < 8)
+		{ FillByteBuffer(); }
+		uint64_t ret;
+		memcpy(&ret, bytebuf + sizeof(bytebuf) - bytebuf_size, 8);
+		bytebuf_size -= 8;
+		return le64toh(ret);
+	}
+
+	/** Generate a random (bits)-bit integer. */
+	uint64_t randbits(int bits)
+	{
+		if (bits == 0)
+		{
+			return 0;
+		}
+		else if (bits > 32)
+		{
+			return rand64() >> (64 - bits);
+		}
+		else
+		{
+			if (bitbuf_size < bits)
+			{ FillBitBuffer(); }
+			uint64_t ret = bitbuf & (~(uint64_t) 0 >> (64 - bits));
+			bitbuf >>= bits;
+			bitbuf_size -= bits;
+			return ret;
+		}
+	}
+
+	/** Generate a random integer in the range [0..range). */
+	uint64_t randrange(uint64_t range)
+	{
+		if (range == 0)
+		{ return 0; }
+		--range;
+		int bits = range ? 64 - __builtin_clzll(range) : 0;
+		while (true)
+		{
+			uint64_t ret = randbits(bits);
+			if (ret <= range)
+			{ return ret; }
+		}
+	}
+
+	/** Generate random bytes. */
+	std::vector<unsigned char> randbytes(size_t len);
+
+	/** Fill buffer by random bytes. */
+	void randbytes(unsigned char* buf, size_t len);
+
+	/** Generate a random 32-bit integer. */
+	uint32_t rand32()
+	{ return randbits(32); }
+
+	/** generate a random uint256. */
+	uint256 rand256();
+
+	/** Generate a random boolean. */
+	bool randbool()
+	{ return randbits(1); }
+
+	// Compatibility with the C++11 UniformRandomBitGenerator concept
+	typedef uint64_t result_type;
+
+	static constexpr uint64_t min()
+	{ return 0; }
+
+	static constexpr uint64_t max()
+	{ return std::numeric_limits<uint64_t>::max(); }
+
+	inline uint64_t operator()()
+	{ return rand64(); }
+};
+
+/** Fast random context of current thread, seeded on first use */
+FastRandomContext& FastRandom();
 
 /* Number of random bytes returned by GetOSRand.
  * When changing this constant make sure to change all call sites, and make
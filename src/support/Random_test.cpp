@@ -0,0 +1,91 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// Random_test.cpp
+
+#include "Random.hpp"
+
+#include <gtest/gtest.h>
+#include <set>
+#include <thread>
+
+TEST(FastRandom, Deterministic)
+{
+	FastRandomContext ctx1(true);
+	FastRandomContext ctx2(true);
+
+	EXPECT_EQ(ctx1.rand64(), ctx2.rand64());
+	EXPECT_EQ(ctx1.rand32(), ctx2.rand32());
+	EXPECT_EQ(ctx1.randbits(3), ctx2.randbits(3));
+	EXPECT_EQ(ctx1.randbytes(17), ctx2.randbytes(17));
+	EXPECT_EQ(ctx1.randbytes(1000), ctx2.randbytes(1000));
+	EXPECT_EQ(ctx1.rand256(), ctx2.rand256());
+	EXPECT_EQ(ctx1.randrange(1000), ctx2.randrange(1000));
+
+	// Keystream of zero key, nonce and counter
+	FastRandomContext ctx3(true);
+	EXPECT_EQ(ctx3.rand64(), 0x903df1a0ade0b876ull);
+}
+
+TEST(FastRandom, Ranges)
+{
+	auto& ctx = FastRandom();
+
+	for (int bits = 0; bits < 64; ++bits)
+	{
+		for (int i = 0; i < 100; ++i)
+		{
+			ASSERT_LT(ctx.randbits(bits), uint64_t(1) << bits);
+		}
+	}
+
+	std::set<uint64_t> seen;
+	for (int i = 0; i < 1000; ++i)
+	{
+		auto value = ctx.randrange(10);
+		ASSERT_LT(value, 10u);
+		seen.insert(value);
+	}
+	EXPECT_EQ(seen.size(), 10u);
+	EXPECT_EQ(ctx.randrange(1), 0u);
+	EXPECT_EQ(ctx.randrange(0), 0u);
+}
+
+TEST(FastRandom, Seeding)
+{
+	// Contexts seeded from strong RNG and contexts of different threads differ
+	FastRandomContext ctx1;
+	FastRandomContext ctx2;
+	EXPECT_NE(ctx1.rand256(), ctx2.rand256());
+
+	uint256 other;
+	std::thread([&other] { other = FastRandom().rand256(); }).join();
+	EXPECT_NE(FastRandom().rand256(), other);
+
+	// Deterministic context is never reseeded
+	FastRandomContext det1(true);
+	FastRandomContext det2(true);
+	for (uint64_t i = 0; i < FastRandomContext::RESEED_INTERVAL / 4096 + 2; ++i)
+	{
+		ASSERT_EQ(det1.randbytes(4096), det2.randbytes(4096));
+	}
+}
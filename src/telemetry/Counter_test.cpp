@@ -0,0 +1,66 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// Counter_test.cpp
+
+#include <telemetry/Counter.hpp>
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(Counter, Add)
+{
+	Counter counter("test");
+	EXPECT_EQ(counter.value(), 0u);
+
+	counter.add();
+	counter.add(41);
+	EXPECT_EQ(counter.value(), 42u);
+}
+
+TEST(Counter, ConcurrentAdd)
+{
+	Counter counter("test");
+
+	// More threads than shards, so some of them share a shard
+	const size_t threadsCount = Counter::SHARDS + 4;
+	const size_t addsPerThread = 100000;
+
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < threadsCount; ++i)
+	{
+		threads.emplace_back([&counter]{
+			for (size_t j = 0; j < addsPerThread; ++j)
+			{
+				counter.add();
+			}
+		});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	EXPECT_EQ(counter.value(), threadsCount * addsPerThread);
+}
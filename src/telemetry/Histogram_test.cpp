@@ -0,0 +1,130 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// Histogram_test.cpp
+
+#include <telemetry/Histogram.hpp>
+
+#include <gtest/gtest.h>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	// Value reported for bucket of `value`: it is the lower half of two, so median falls into it
+	uint64_t reported(uint64_t value)
+	{
+		Histogram histogram("test");
+		histogram.record(value);
+		histogram.record(std::numeric_limits<uint64_t>::max());
+		return histogram.p50();
+	}
+}
+
+TEST(Histogram, Empty)
+{
+	Histogram histogram("test");
+	EXPECT_EQ(histogram.count(), 0u);
+	EXPECT_EQ(histogram.p50(), 0u);
+	EXPECT_EQ(histogram.mean(), 0);
+}
+
+TEST(Histogram, BucketBoundaries)
+{
+	// Small values are exact
+	for (uint64_t value = 0; value < Histogram::SUB_BUCKETS; ++value)
+	{
+		EXPECT_EQ(reported(value), value);
+	}
+
+	// Next range [32, 64) has buckets of width 2, reported by their middle
+	EXPECT_EQ(reported(32), 33u);
+	EXPECT_EQ(reported(33), 33u);
+	EXPECT_EQ(reported(34), 35u);
+	EXPECT_EQ(reported(63), 63u);
+
+	// [64, 128) has buckets of width 4
+	EXPECT_EQ(reported(64), 66u);
+	EXPECT_EQ(reported(67), 66u);
+	EXPECT_EQ(reported(68), 70u);
+
+	// Top bucket [31 * 2^59, 2^64) doesn't overflow
+	EXPECT_EQ(reported(std::numeric_limits<uint64_t>::max()), (uint64_t(31) << 59) + (uint64_t(1) << 58));
+	EXPECT_EQ(reported(uint64_t(31) << 59), (uint64_t(31) << 59) + (uint64_t(1) << 58));
+}
+
+TEST(Histogram, RelativeError)
+{
+	for (uint64_t value = 1; value < (uint64_t(1) << 62); value = value * 3 + 1)
+	{
+		auto error = std::abs(static_cast<double>(reported(value)) - static_cast<double>(value)) / static_cast<double>(value);
+		EXPECT_LE(error, 1.0 / Histogram::SUB_BUCKETS) << "value " << value;
+	}
+}
+
+TEST(Histogram, Percentiles)
+{
+	Histogram histogram("test");
+	for (uint64_t value = 1; value <= 1000; ++value)
+	{
+		histogram.record(value);
+	}
+
+	EXPECT_EQ(histogram.count(), 1000u);
+	EXPECT_EQ(histogram.sum(), 500500u);
+	EXPECT_EQ(histogram.max(), 1000u);
+	EXPECT_DOUBLE_EQ(histogram.mean(), 500.5);
+
+	EXPECT_NEAR(histogram.p50(), 500, 500 / Histogram::SUB_BUCKETS);
+	EXPECT_NEAR(histogram.p99(), 990, 990 / Histogram::SUB_BUCKETS);
+	EXPECT_LE(histogram.p999(), 1000u);
+}
+
+TEST(Histogram, ConcurrentRecord)
+{
+	Histogram histogram("test");
+
+	const size_t threadsCount = 8;
+	const size_t recordsPerThread = 100000;
+
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < threadsCount; ++i)
+	{
+		threads.emplace_back([&histogram, i]{
+			for (size_t j = 0; j < recordsPerThread; ++j)
+			{
+				histogram.record(i);
+			}
+		});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	EXPECT_EQ(histogram.count(), threadsCount * recordsPerThread);
+	EXPECT_EQ(histogram.sum(), (threadsCount - 1) * threadsCount / 2 * recordsPerThread);
+	EXPECT_EQ(histogram.max(), threadsCount - 1);
+	EXPECT_EQ(histogram.percentile(1), threadsCount - 1);
+}
@@ -0,0 +1,117 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// RateWindow_test.cpp
+
+#include <telemetry/RateWindow.hpp>
+
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	int64_t currentSecond()
+	{
+		return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// Sleeps until beginning of next second of steady clock (as RateWindow counts them)
+	void waitNextSecond()
+	{
+		auto second = currentSecond();
+		while (currentSecond() == second)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+	}
+}
+
+TEST(RateWindow, Rollover)
+{
+	// One-second window has two buckets, reused every other second
+	RateWindow rate("test", std::chrono::seconds(1));
+
+	waitNextSecond();
+	rate.add(10);
+	EXPECT_EQ(rate.perSec(), 0); // Current second is not complete yet
+
+	waitNextSecond();
+	EXPECT_EQ(rate.perSec(), 10);
+
+	// Bucket of first second is taken again: old count is replaced, not accumulated
+	waitNextSecond();
+	EXPECT_EQ(rate.perSec(), 0);
+	rate.add(3);
+
+	waitNextSecond();
+	EXPECT_EQ(rate.perSec(), 3);
+}
+
+TEST(RateWindow, Average)
+{
+	RateWindow rate("test", std::chrono::seconds(2));
+
+	waitNextSecond();
+	rate.add(4);
+	waitNextSecond();
+	rate.add(8);
+	waitNextSecond();
+
+	EXPECT_EQ(rate.perSec(std::chrono::seconds(1)), 8);
+	EXPECT_EQ(rate.perSec(), 6);
+
+	// Interval is limited by window
+	EXPECT_EQ(rate.perSec(std::chrono::seconds(10)), 6);
+}
+
+TEST(RateWindow, ConcurrentAdd)
+{
+	RateWindow rate("test", std::chrono::seconds(1));
+
+	const size_t threadsCount = 8;
+	const size_t addsPerThread = 10000;
+
+	// Window is too short to wait for all threads at arbitrary moment; start at beginning of second
+	waitNextSecond();
+	auto second = currentSecond();
+
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < threadsCount; ++i)
+	{
+		threads.emplace_back([&rate]{
+			for (size_t j = 0; j < addsPerThread; ++j)
+			{
+				rate.add();
+			}
+		});
+	}
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+	ASSERT_EQ(currentSecond(), second) << "Adds didn't fit into one second";
+
+	waitNextSecond();
+	EXPECT_EQ(rate.perSec(), threadsCount * addsPerThread);
+}
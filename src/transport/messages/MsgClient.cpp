@@ -28,9 +28,9 @@
 #include <transport/messages/MsgContext.hpp>
 #include <protocol/messages/Version.hpp>
 #include <other/hash.h>
-#include <serialization/JsonSerializer.hpp>
 #include "InputMemoryStream.hpp"
-#include "OutputConnectionStream.hpp"
+#include "WireMessage.hpp"
+#include "MsgTrace.hpp"
 
 bool MsgClient::processing(const std::shared_ptr<Connection>& connection_)
 {
@@ -139,9 +139,8 @@ bool MsgClient::processing(const std::shared_ptr<Connection>& connection_)
 			InputMemoryStream is(connection->dataPtr(), msgHeader.length());
 			msgVersion.Unserialize(is);
 
-			std::ostringstream oss;
-			SerializerFactory::create("json", JsonSerializer::PRETTY | JsonSerializer::INDENT)->encode(oss, msgVersion.toSVal());
-			_log.info("Recv message '" + msgHeader.command() + "'\n" + oss.str());
+			MsgTrace::recv(msgHeader.command(), msgVersion, msgHeader.length(), connection->name());
+			MsgStats::recv(msgHeader.command(), protocol::MessageHeader::HEADER_SIZE + msgHeader.length(), 0, &context->stats());
 		}
 
 		connection->skip(msgHeader.length());
@@ -164,18 +163,14 @@ bool MsgClient::processing(const std::shared_ptr<Connection>& connection_)
 
 		context->setRemoteVersion(std::make_shared<protocol::message::Version>(std::move(msgVersion)));
 
-		OutputConnectionStream os(*connection);
-
 		// Sending the Verack message
 		{
 			protocol::message::Verack msgVerack;
-			msgHeader = msgVerack.buildHeader();
-			msgHeader.Serialize(os);
-			msgVerack.Serialize(os);
+			auto wire = WireMessage::build(msgVerack);
+			wire->appendTo(*connection);
 
-			std::ostringstream oss;
-			SerializerFactory::create("json", JsonSerializer::PRETTY | JsonSerializer::INDENT)->encode(oss, msgVerack.toSVal());
-			_log.info("Send message '" + msgHeader.command() + "'\n" + oss.str());
+			MsgTrace::send(wire->command(), msgVerack, wire->size() - protocol::MessageHeader::HEADER_SIZE, connection->name());
+			MsgStats::sent(wire->command(), wire->size(), &context->stats());
 		}
 	}
 
@@ -253,9 +248,8 @@ bool MsgClient::processing(const std::shared_ptr<Connection>& connection_)
 		InputMemoryStream is(connection->dataPtr(), msgHeader.length());
 		msgVerack.Unserialize(is);
 
-		std::ostringstream oss;
-		SerializerFactory::create("json", JsonSerializer::PRETTY | JsonSerializer::INDENT)->encode(oss, msgVerack.toSVal());
-		_log.info("Recv message '" + msgHeader.command() + "'\n" + oss.str());
+		MsgTrace::recv(msgHeader.command(), msgVerack, msgHeader.length(), connection->name());
+		MsgStats::recv(msgHeader.command(), protocol::MessageHeader::HEADER_SIZE + msgHeader.length(), 0, &context->stats());
 	}
 
 	connection->skip(msgHeader.length());
@@ -27,6 +27,8 @@
 #include <transport/messages/MsgCommunicator.hpp>
 #include <utils/SslHelper.hpp>
 #include <net/SslConnector.hpp>
+#include <net/EncryptedConnector.hpp>
+#include <net/EncryptedConnection.hpp>
 #include <net/ConnectionManager.hpp>
 #include <thread/RollbackStackAndRestoreContext.hpp>
 #include <transport/messages/MsgContext.hpp>
@@ -36,9 +38,9 @@
 #include <protocol/messages/SendHeaders.hpp>
 #include <protocol/messages/SendCmpct.hpp>
 #include <transport/Transports.hpp>
-#include <serialization/JsonSerializer.hpp>
 #include <utility>
-#include "OutputConnectionStream.hpp"
+#include "WireMessage.hpp"
+#include "MsgTrace.hpp"
 
 
 MsgCommunicator::MsgCommunicator(
@@ -101,6 +103,11 @@ void MsgCommunicator::operator()()
 			auto context = SslHelper::getClientContext();
 			_connector = std::make_shared<SslConnector>(_clientTransport, _uri.host(), _uri.port(), context);
 		}
+		else if (EncryptedConnection::isOwnNode(_uri.host(), _uri.port()))
+		{
+			// Own nodes sharing the key talk over encrypted layer only; the rest of network - over plain TCP
+			_connector = std::make_shared<EncryptedConnector>(_clientTransport, _uri.host(), _uri.port());
+		}
 		else
 		{
 			_connector = std::make_shared<TcpConnector>(_clientTransport, _uri.host(), _uri.port());
@@ -302,16 +309,13 @@ void MsgCommunicator::submit()
 
 		context->setLocalVersion(std::dynamic_pointer_cast<protocol::message::Version>(msg));
 
-		auto header = msg->buildHeader();
+		auto wire = WireMessage::build(*msg);
 
-		std::ostringstream oss;
-		SerializerFactory::create("json", JsonSerializer::PRETTY | JsonSerializer::INDENT)->encode(oss, msg->toSVal());
-		_log.info("Send message '" + header.command() + "'\n" + oss.str());
+		MsgTrace::send(wire->command(), *msg, wire->size() - protocol::MessageHeader::HEADER_SIZE, _connection->name());
 
-		OutputConnectionStream os(*_connection);
+		wire->appendTo(*_connection);
 
-		header.Serialize(os);
-		msg->Serialize(os);
+		MsgStats::sent(wire->command(), wire->size(), &context->stats());
 
 		_connection->setTtl(std::chrono::seconds(999));
 
@@ -29,8 +29,7 @@
 #include <transport/messages/MsgPipe.hpp>
 #include <net/ConnectionManager.hpp>
 #include <cassert>
-#include <serialization/JsonSerializer.hpp>
-#include "OutputConnectionStream.hpp"
+#include "MsgTrace.hpp"
 
 void MsgContext::setEstablished()
 {
@@ -52,7 +51,7 @@ void MsgContext::setEstablished()
 	{
 		transport->metricRequestCount = prevTransport->metricRequestCount;
 		transport->metricAvgRequestPerSec = prevTransport->metricAvgRequestPerSec;
-		transport->metricAvgExecutionTime = prevTransport->metricAvgExecutionTime;
+		transport->metricExecutionTime = prevTransport->metricExecutionTime;
 	}
 
 	connection->setTransport(transport);
@@ -80,6 +79,15 @@ void MsgContext::setEstablishedHandler(std::function<void(MsgContext&)> handler)
 }
 
 void MsgContext::transmit(const protocol::Message& msg, bool close)
+{
+	auto wire = WireMessage::build(msg);
+
+	MsgTrace::send(wire->command(), msg, wire->size() - protocol::MessageHeader::HEADER_SIZE);
+
+	transmit(wire, close);
+}
+
+void MsgContext::transmit(const std::shared_ptr<const WireMessage>& wire, bool close)
 {
 	auto connection = std::dynamic_pointer_cast<TcpConnection>(_connection.lock());
 	assert(connection);
@@ -92,16 +100,9 @@ void MsgContext::transmit(const protocol::Message& msg, bool close)
 		throw std::runtime_error("Incomplete messages communication");
 	}
 
-	auto header = msg.buildHeader();
-
-	std::ostringstream oss;
-	SerializerFactory::create("json", JsonSerializer::PRETTY | JsonSerializer::INDENT)->encode(oss, msg.toSVal());
-	Log("~").info("Send message '" + header.command() + "'\n" + oss.str());
-
-	OutputConnectionStream os(*connection);
+	wire->appendTo(*connection);
 
-	header.Serialize(os);
-	msg.Serialize(os);
+	MsgStats::sent(wire->command(), wire->size(), &_stats);
 
 	if (close)
 	{
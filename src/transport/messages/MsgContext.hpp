@@ -30,6 +30,8 @@
 #include <protocol/types/Message.hpp>
 #include <protocol/messages/Verack.hpp>
 #include <protocol/messages/Version.hpp>
+#include <transport/messages/WireMessage.hpp>
+#include <transport/messages/MsgStats.hpp>
 
 class MsgContext final : public TransportContext
 {
@@ -40,6 +42,7 @@ protected:
 	std::shared_ptr<protocol::Message> _currentMessage;
 	std::weak_ptr<Peer> _peer;
 	std::function<void(MsgContext&)> _establishHandler;
+	PeerStats _stats;
 
 public:
 	MsgContext(const std::shared_ptr<Connection>& connection)
@@ -117,6 +120,20 @@ public:
 	void setEstablishedHandler(std::function<void(MsgContext&)> handler);
 
 
+	std::shared_ptr<Connection> connection() const
+	{
+		return _connection.lock();
+	}
+
+	PeerStats& stats()
+	{
+		return _stats;
+	}
+
+
 	void transmit(protocol::Message&& msg, bool close = false);
 	void transmit(const protocol::Message& msg, bool close = false);
+
+	/// Send prebuilt wire image (shared between connections, not copied)
+	void transmit(const std::shared_ptr<const WireMessage>& wire, bool close = false);
 };
@@ -0,0 +1,199 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// MsgLane.cpp
+
+#include "MsgLane.hpp"
+#include <cassert>
+#include <thread/TaskManager.hpp>
+#include <thread/ThreadPool.hpp>
+#include <vector>
+
+MsgLane::MsgLane()
+: _log("MsgLane")
+, _mutex("MsgLane")
+, _pending(0)
+, _passes(0)
+{
+}
+
+bool MsgLane::enqueue(
+	const std::shared_ptr<MsgContext>& context,
+	const std::shared_ptr<TcpConnection>& connection,
+	size_t size,
+	Task::Func&& job
+)
+{
+	auto& lane = getInstance();
+
+	std::lock_guard<NamedMutex> lockGuard(lane._mutex);
+
+	auto& queue = lane._queues[context.get()];
+	queue.jobs.emplace_back(size, std::move(job));
+	queue.bytes += size;
+	++lane._pending;
+
+	if (!queue.ready)
+	{
+		queue.ready = true;
+		lane._round.push_back(context.get());
+	}
+
+	lane.schedule();
+
+	if (queue.jobs.size() < MAX_JOBS_PER_PEER && queue.bytes < MAX_BYTES_PER_PEER)
+	{
+		return true;
+	}
+
+	// Suspended under lock, so pass can't resume it before
+	queue.suspended = true;
+	queue.connection = connection;
+	connection->suspendReading();
+
+	lane._log.debug("Reading from %s is suspended by backlog of %zu messages (%zu bytes)",
+		connection->name().c_str(), queue.jobs.size(), queue.bytes);
+
+	return false;
+}
+
+size_t MsgLane::pending()
+{
+	auto& lane = getInstance();
+
+	std::lock_guard<NamedMutex> lockGuard(lane._mutex);
+	return lane._pending;
+}
+
+void MsgLane::schedule()
+{
+	// One worker is left for I/O
+	auto limit = std::max<size_t>(ThreadPool::getThreadNum(), 2) - 1;
+
+	while (_passes < limit && !_round.empty())
+	{
+		auto key = _round.front();
+		_round.pop_front();
+		++_passes;
+
+		TaskManager::enqueue(
+			[key]
+			{
+				getInstance().pass(key);
+			},
+			"Messages processing pass"
+		);
+	}
+}
+
+void MsgLane::pass(const MsgContext* key)
+{
+	std::vector<Task::Func> jobs;
+	jobs.reserve(BUDGET_PER_PASS);
+
+	{
+		std::lock_guard<NamedMutex> lockGuard(_mutex);
+
+		// Queue of scheduled key exists until this pass erases it (see Queue::ready)
+		auto i = _queues.find(key);
+		assert(i != _queues.end());
+		if (i == _queues.end())
+		{
+			_log.warn("Lost queue of scheduled pass");
+			--_passes;
+			schedule();
+			return;
+		}
+
+		auto& queue = i->second;
+		while (!queue.jobs.empty() && jobs.size() < BUDGET_PER_PASS)
+		{
+			queue.bytes -= queue.jobs.front().first;
+			jobs.emplace_back(std::move(queue.jobs.front().second));
+			queue.jobs.pop_front();
+		}
+		_pending -= jobs.size();
+	}
+
+	for (auto& job : jobs)
+	{
+		try
+		{
+			job();
+		}
+		catch (const std::exception& exception)
+		{
+			_log.warn("Uncatched exception at processing message: %s", exception.what());
+		}
+	}
+	// Done jobs are kept until queue is erased: they hold the context alive, so its address
+	// (the key) can't be reused by a new peer while the entry still exists
+
+	std::shared_ptr<TcpConnection> connection;
+	{
+		std::lock_guard<NamedMutex> lockGuard(_mutex);
+
+		--_passes;
+
+		auto i = _queues.find(key);
+		assert(i != _queues.end());
+		if (i == _queues.end())
+		{
+			_log.warn("Lost queue of running pass");
+			schedule();
+			return;
+		}
+
+		auto& queue = i->second;
+
+		if (
+			queue.suspended &&
+			queue.jobs.size() <= MAX_JOBS_PER_PEER / 2 &&
+			queue.bytes <= MAX_BYTES_PER_PEER / 2
+		)
+		{
+			queue.suspended = false;
+			connection = queue.connection.lock();
+			queue.connection.reset();
+		}
+
+		if (queue.jobs.empty())
+		{
+			_queues.erase(i);
+		}
+		else
+		{
+			// Remainder waits for the next round
+			_round.push_back(key);
+		}
+
+		schedule();
+	}
+
+	jobs.clear();
+
+	if (connection)
+	{
+		connection->resumeReading();
+	}
+}
@@ -0,0 +1,111 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// MsgLane.hpp
+
+#pragma once
+
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <log/Log.hpp>
+#include <net/TcpConnection.hpp>
+#include <thread/NamedMutex.hpp>
+#include <thread/Task.hpp>
+
+class MsgContext;
+
+/// Processing lane for parsed incoming messages.
+/// Every peer (context) has its own FIFO, so messages of one peer are handled
+/// strictly in order of arrival. Peers with pending messages are served
+/// round-robin, at most BUDGET_PER_PASS messages per peer per pass; each pass is
+/// a separate task, so I/O tasks are interleaved with processing and one busy
+/// peer can't hold a worker until its whole backlog is drained.
+/// Passes of different peers run concurrently on all workers but one; a peer is
+/// out of the round while its pass is running, so it never has two passes.
+/// Backlog of a peer is limited: reaching MAX_JOBS_PER_PEER or MAX_BYTES_PER_PEER
+/// suspends reading from its connection until half of the backlog is processed.
+class MsgLane final
+{
+public:
+	static constexpr size_t BUDGET_PER_PASS = 16;
+	static constexpr size_t MAX_JOBS_PER_PEER = 128;
+	static constexpr size_t MAX_BYTES_PER_PEER = 4 * 1024 * 1024;
+
+	MsgLane(const MsgLane&) = delete; // Copy-constructor
+	MsgLane& operator=(const MsgLane&) = delete; // Copy-assignment
+	MsgLane(MsgLane&&) noexcept = delete; // Move-constructor
+	MsgLane& operator=(MsgLane&&) noexcept = delete; // Move-assignment
+
+private:
+	MsgLane(); // Default-constructor
+	~MsgLane() = default; // Destructor
+
+	static MsgLane& getInstance()
+	{
+		static MsgLane instance;
+		return instance;
+	}
+
+	struct Queue
+	{
+		std::deque<std::pair<size_t, Task::Func>> jobs; // Jobs with size of their messages
+		size_t bytes = 0;
+		// Queue is in round or being processed now. Invariant: while it is set the entry is not
+		// erased - only the pass of this key erases it, and only when there is no job left.
+		// Every job holds its context alive, so the key can't be reused by another context
+		// while the entry exists
+		bool ready = false;
+		bool suspended = false; // Reading from connection is suspended by backlog
+		std::weak_ptr<TcpConnection> connection;
+	};
+
+	Log _log;
+
+	NamedMutex _mutex;
+	std::unordered_map<const MsgContext*, Queue> _queues;
+	std::deque<const MsgContext*> _round;
+	size_t _pending;
+	size_t _passes; // Scheduled or running passes
+
+	void schedule();
+	void pass(const MsgContext* key);
+
+public:
+	/// Put job (processing of message of given size) into FIFO of context.
+	/// Job must hold the context alive. Returns false if backlog of the peer has
+	/// reached its limit: reading from connection is suspended then, and caller
+	/// must stop parsing, leaving the rest of data in buffer
+	static bool enqueue(
+		const std::shared_ptr<MsgContext>& context,
+		const std::shared_ptr<TcpConnection>& connection,
+		size_t size,
+		Task::Func&& job
+	);
+
+	/// Count of jobs waiting for processing
+	static size_t pending();
+};
@@ -27,15 +27,21 @@
 #include <transport/messages/MsgPipe.hpp>
 #include <transport/messages/MsgContext.hpp>
 #include <net/ConnectionManager.hpp>
-#include <other/hash.h>
 #include <protocol/MessageFactory.hpp>
-#include <serialization/JsonSerializer.hpp>
 #include "InputMemoryStream.hpp"
+#include "MsgLane.hpp"
+#include "MsgTrace.hpp"
+#include <telemetry/TelemetryManager.hpp>
 
 static std::atomic_uint64_t id4noname = 0;
 
 MsgPipe::MsgPipe(const std::shared_ptr<Handler>& handler)
 : _handler(handler)
+, _parseState(ParseState::Header)
+, _hashedLength(0)
+, metricRequestCount(TelemetryManager::counter("p2p/messages"))
+, metricAvgRequestPerSec(TelemetryManager::rate("p2p/messages/per_sec"))
+, metricExecutionTime(TelemetryManager::histogram("p2p/messages/exec_time_us"))
 {
 	_name = "MsgPipe[" + std::to_string(id4noname.fetch_add(1, std::memory_order_relaxed)) + "]";
 	_log.setName("MsgPipe");
@@ -68,131 +74,191 @@ bool MsgPipe::processing(const std::shared_ptr<Connection>& connection_)
 
 	for (;;)
 	{
-		// Checking the amount of data needed for the message header
-		if (connection->dataLen() < protocol::MessageHeader::HEADER_SIZE)
+		if (_parseState == ParseState::Header)
 		{
-			if (connection->dataLen() > 0)
+			// Checking the amount of data needed for the message header
+			if (connection->dataLen() < protocol::MessageHeader::HEADER_SIZE)
 			{
-				_log.debug(
-					"Not anough data for read message header (%zu/%zu bytes)",
-					connection->dataLen(), protocol::MessageHeader::HEADER_SIZE
-				);
-				connection->setTtl(std::chrono::seconds(10));
+				if (connection->dataLen() > 0)
+				{
+					_log.debug(
+						"Not anough data for read message header (%zu/%zu bytes)",
+						connection->dataLen(), protocol::MessageHeader::HEADER_SIZE
+					);
+					connection->setTtl(std::chrono::seconds(10));
+					return true;
+				}
+
+				_log.debug("No more data");
+				connection->setTtl(std::chrono::seconds(900));
 				return true;
 			}
 
-			_log.debug("No more data");
-			connection->setTtl(std::chrono::seconds(900));
-			return true;
-		}
+			// Getting message header
+			{
+				InputMemoryStream is(connection->dataPtr(), protocol::MessageHeader::HEADER_SIZE);
+				_msgHeader.Unserialize(is);
+			}
 
-		// Getting message header
-		protocol::MessageHeader msgHeader;
-		{
-			InputMemoryStream is(connection->dataPtr(), protocol::MessageHeader::HEADER_SIZE);
-			msgHeader.Unserialize(is);
-		}
+			// Checking the magic number
+			if (
+				_msgHeader.magic() != static_cast<uint32_t>(protocol::Magic::main) &&
+				_msgHeader.magic() != static_cast<uint32_t>(protocol::Magic::testnet)
+			)
+			{
+				reject(connection);
+				_log.info("Bad message: wrong magic number");
+				return true;
+			}
 
-		// Checking the magic number
-		if (
-			msgHeader.magic() != static_cast<uint32_t>(protocol::Magic::main) &&
-			msgHeader.magic() != static_cast<uint32_t>(protocol::Magic::testnet)
-		)
-		{
-			connection->close();
-			connection->resetContext();
-			connection->setTtl(std::chrono::milliseconds(50));
+			// Checking the value of payload size (before any of payload is buffered)
+			if (_msgHeader.length() > protocol::Message::MAX_PAYLOAD_SIZE)
+			{
+				reject(connection);
+				_log.debug("Bad message: bad payload length (%u bytes)", _msgHeader.length());
+				return true;
+			}
 
-			_log.info("Bad message: wrong magic number");
-			return true;
+			// Crete message by type
+			_msg = protocol::MessageFactory::create(_msgHeader.command());
+			if (_msg == nullptr)
+			{
+				reject(connection);
+				_log.warn("Bad message: Unknown message '%s'", _msgHeader.command().c_str());
+				return true;
+			}
+
+			connection->skip(protocol::MessageHeader::HEADER_SIZE);
+
+			// Place for small payload at once; bigger one grows geometrically as data really arrives,
+			// so a bare header can't pin memory that peer never pays for by bandwidth
+			connection->reserve(std::min<size_t>(_msgHeader.length(), MAX_RESERVE_SIZE));
+
+			_payloadHasher.Reset();
+			_hashedLength = 0;
+			_parseState = ParseState::Payload;
 		}
 
-//		// Checking the value of payload size
-//		if (msgHeader.length() > protocol::Message::MAX_PAYLOAD_SIZE)
-//		{
-//			connection->close();
-//			connection->resetContext();
-//			connection->setTtl(std::chrono::milliseconds(50));
-//			_log.debug("Bad message: bad payload length");
-//			return true;
-//		}
+		// Feeding the checksum by newly arrived part of payload
+		{
+			auto available = std::min<size_t>(connection->dataLen(), _msgHeader.length());
+			if (available > _hashedLength)
+			{
+				_payloadHasher.Write(
+					reinterpret_cast<const uint8_t*>(connection->dataPtr()) + _hashedLength,
+					available - _hashedLength
+				);
+				_hashedLength = available;
+			}
+		}
 
 		// Checking the amount of data needed for the payload
-		if (connection->dataLen() < protocol::MessageHeader::HEADER_SIZE + msgHeader.length())
+		if (_hashedLength < _msgHeader.length())
 		{
 			connection->setTtl(std::chrono::seconds(900));
 			_log.debug(
-				"Not anough data for read message payload (%zu/%zu bytes)",
-				connection->dataLen() - protocol::MessageHeader::HEADER_SIZE, msgHeader.length()
+				"Not anough data for read message payload (%zu/%u bytes)",
+				_hashedLength, _msgHeader.length()
 			);
 			return true;
 		}
 
-		// Checking the checksum
-		auto hash = Hash(
-			connection->dataPtr() + protocol::MessageHeader::HEADER_SIZE,
-			connection->dataPtr() + protocol::MessageHeader::HEADER_SIZE + msgHeader.length()
-		);
+		_parseState = ParseState::Header;
 
-		uint32_t checksum;
-		memcpy(&checksum, connection->dataPtr() + protocol::MessageHeader::CHECKSUM_OFFSET, protocol::MessageHeader::CHECKSUM_SIZE);
+		auto msg = std::move(_msg);
 
-		if (msgHeader.checksum() != checksum)
+		// Checking the checksum (first 4 bytes of sha256(sha256(payload)))
 		{
-			connection->close();
-			connection->resetContext();
-			connection->setTtl(std::chrono::milliseconds(50));
-			_log.debug("Bad message: Wrong checksum");
-			return true;
-		}
+			uint8_t hash[CSHA256::OUTPUT_SIZE];
+			_payloadHasher.Finalize(hash);
+			_payloadHasher.Reset().Write(hash, sizeof(hash)).Finalize(hash);
 
-		connection->skip(protocol::MessageHeader::HEADER_SIZE);
+			uint32_t checksum;
+			memcpy(&checksum, hash, sizeof(checksum));
+			checksum = le32toh(checksum);
 
-		std::shared_ptr<protocol::Message> msg;
-		try
-		{
-			// Crete message by type
-			msg = protocol::MessageFactory::create(msgHeader.command());
-			if (msg == nullptr)
+			if (_msgHeader.checksum() != checksum)
 			{
-				throw std::runtime_error("Unknown message '" + msgHeader.command() + "'");
+				reject(connection);
+				_log.debug("Bad message: Wrong checksum");
+				return true;
 			}
+		}
 
-			InputMemoryStream is(connection->dataPtr(), msgHeader.length());
+		try
+		{
+			auto beginTime = std::chrono::steady_clock::now();
+
+			InputMemoryStream is(connection->dataPtr(), _msgHeader.length());
 			msg->Unserialize(is);
 
-			std::ostringstream oss;
-			SerializerFactory::create("json", JsonSerializer::PRETTY | JsonSerializer::INDENT)->encode(oss, msg->toSVal());
-			_log.info("Recv message '" + msgHeader.command() + "'\n" + oss.str());
+			MsgStats::recv(
+				_msgHeader.command(),
+				protocol::MessageHeader::HEADER_SIZE + _msgHeader.length(),
+				static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+					std::chrono::steady_clock::now() - beginTime
+				).count()),
+				&context->stats()
+			);
+
+			MsgTrace::recv(_msgHeader.command(), *msg, _msgHeader.length(), connection->name());
 		}
 		catch(const std::exception& exception)
 		{
-			connection->close();
-			connection->resetContext();
-			connection->setTtl(std::chrono::milliseconds(50));
+			reject(connection);
 			_log.warn("Bad message: Can't parse message: %s", exception.what());
 			return true;
 		}
 
-		context->setMessage(msg);
+		connection->skip(_msgHeader.length());
 
-		connection->skip(msgHeader.length());
+		metricRequestCount->add();
+		metricAvgRequestPerSec->add();
 
-		if (metricRequestCount) metricRequestCount->addValue();
-		if (metricAvgRequestPerSec) metricAvgRequestPerSec->addValue();
-		auto beginTime = std::chrono::steady_clock::now();
+		// Processing is done in lane, I/O task goes on with parsing while backlog of peer is not too big
+		auto accepted = MsgLane::enqueue(
+			context,
+			connection,
+			_msgHeader.length(),
+			[context, msg = std::move(msg), metricExecutionTime = metricExecutionTime, command = _msgHeader.command(), wp = std::weak_ptr<Connection>(connection)]
+			{
+				// Connection was closed while message waited in queue
+				if (wp.expired())
+				{
+					return;
+				}
+
+				context->setMessage(msg);
 
-		context->handle();
+				auto beginTime = std::chrono::steady_clock::now();
 
-		auto now = std::chrono::steady_clock::now();
-		auto timeSpent =
-			static_cast<double>(std::chrono::steady_clock::duration(now - beginTime).count()) /
-			static_cast<double>(std::chrono::steady_clock::duration(std::chrono::seconds(1)).count());
-		if (timeSpent > 0)
+				context->handle();
+
+				auto timeSpent = static_cast<uint64_t>(
+					std::chrono::duration_cast<std::chrono::microseconds>(
+						std::chrono::steady_clock::now() - beginTime
+					).count()
+				);
+				metricExecutionTime->record(timeSpent);
+				MsgStats::applied(command, timeSpent, &context->stats());
+
+				context->resetMessage();
+			}
+		);
+		if (!accepted)
 		{
-			if (metricAvgExecutionTime) metricAvgExecutionTime->addValue(timeSpent, now);
+			// Rest of data waits in input buffer until lane resumes reading
+			return true;
 		}
-
-		context->resetMessage();
 	}
 }
+
+void MsgPipe::reject(const std::shared_ptr<TcpConnection>& connection)
+{
+	_parseState = ParseState::Header;
+	_msg.reset();
+
+	connection->close();
+	connection->resetContext();
+	connection->setTtl(std::chrono::milliseconds(50));
+}
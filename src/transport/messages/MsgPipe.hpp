@@ -28,14 +28,38 @@
 
 #include <transport/Transport.hpp>
 #include <net/TcpConnection.hpp>
-#include <telemetry/Metric.hpp>
+#include <telemetry/Counter.hpp>
+#include <telemetry/Histogram.hpp>
+#include <telemetry/RateWindow.hpp>
 #include <protocol/types/Message.hpp>
+#include <protocol/types/MessageHeader.hpp>
+#include <crypto/sha256.h>
 
 class MsgPipe final : public Transport
 {
 private:
 	std::shared_ptr<Handler> _handler;
 
+	/// State of incremental parsing of incoming message
+	enum class ParseState
+	{
+		Header,     // Waiting for message header
+		Payload     // Header accepted, payload is arriving
+	};
+	ParseState _parseState;
+
+	protocol::MessageHeader _msgHeader;
+	std::shared_ptr<protocol::Message> _msg;
+
+	/// Limit of input buffer reserved ahead by message header
+	static constexpr size_t MAX_RESERVE_SIZE = 256 * 1024;
+
+	/// Checksum of payload, fed as bytes arrive
+	CSHA256 _payloadHasher;
+	size_t _hashedLength;
+
+	void reject(const std::shared_ptr<TcpConnection>& connection);
+
 public:
 	MsgPipe(const MsgPipe&) = delete; // Copy-constructor
 	MsgPipe& operator=(const MsgPipe&) = delete; // Copy-assignment
@@ -46,9 +70,10 @@ public:
 
 	~MsgPipe() override;
 
-	std::shared_ptr<Metric> metricRequestCount;
-	std::shared_ptr<Metric> metricAvgRequestPerSec;
-	std::shared_ptr<Metric> metricAvgExecutionTime;
+	/// Shared by all pipes (or taken from server transport of connection), recording is lock-free
+	std::shared_ptr<Counter> metricRequestCount;
+	std::shared_ptr<RateWindow> metricAvgRequestPerSec;
+	std::shared_ptr<Histogram> metricExecutionTime;
 
 	bool processing(const std::shared_ptr<Connection>& connection) override;
 };
@@ -0,0 +1,259 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// MsgStats.cpp
+
+#include "MsgStats.hpp"
+#include <unordered_map>
+#include <serialization/SObj.hpp>
+#include <telemetry/TelemetryManager.hpp>
+
+namespace
+{
+	int64_t unixTime(std::chrono::system_clock::time_point time)
+	{
+		if (time == std::chrono::system_clock::time_point())
+		{
+			return 0;
+		}
+		return std::chrono::duration_cast<std::chrono::seconds>(time.time_since_epoch()).count();
+	}
+
+	SObj totalsToSObj(const std::map<std::string, PeerStats::Totals>& totals, bool withTime, const char* timeField)
+	{
+		SObj obj;
+		for (const auto& i : totals)
+		{
+			SObj item;
+			item.emplace("count", i.second.messages);
+			item.emplace("bytes", i.second.bytes);
+			if (withTime)
+			{
+				item.emplace(timeField, i.second.micros);
+			}
+			obj.emplace(i.first, std::move(item));
+		}
+		return obj;
+	}
+}
+
+PeerStats::PeerStats()
+: _connectTime(std::chrono::system_clock::now())
+, _bytesRecv(0)
+, _bytesSent(0)
+{
+}
+
+void PeerStats::recv(const std::string& command, size_t bytes, uint64_t parseMicros)
+{
+	std::lock_guard<std::mutex> lockGuard(_mutex);
+
+	_lastRecv = std::chrono::system_clock::now();
+	_bytesRecv += bytes;
+
+	auto& totals = _recv[command];
+	totals.messages++;
+	totals.bytes += bytes;
+	totals.micros += parseMicros;
+}
+
+void PeerStats::sent(const std::string& command, size_t bytes)
+{
+	std::lock_guard<std::mutex> lockGuard(_mutex);
+
+	_lastSend = std::chrono::system_clock::now();
+	_bytesSent += bytes;
+
+	auto& totals = _sent[command];
+	totals.messages++;
+	totals.bytes += bytes;
+}
+
+void PeerStats::applied(const std::string& command, uint64_t micros)
+{
+	std::lock_guard<std::mutex> lockGuard(_mutex);
+
+	auto& totals = _applied[command];
+	totals.messages++;
+	totals.micros += micros;
+}
+
+uint64_t PeerStats::bytesRecv() const
+{
+	std::lock_guard<std::mutex> lockGuard(_mutex);
+	return _bytesRecv;
+}
+
+uint64_t PeerStats::bytesSent() const
+{
+	std::lock_guard<std::mutex> lockGuard(_mutex);
+	return _bytesSent;
+}
+
+SVal PeerStats::toSVal() const
+{
+	std::lock_guard<std::mutex> lockGuard(_mutex);
+
+	SObj obj;
+	obj.emplace("conntime", unixTime(_connectTime));
+	obj.emplace("lastrecv", unixTime(_lastRecv));
+	obj.emplace("lastsend", unixTime(_lastSend));
+	obj.emplace("bytesrecv", _bytesRecv);
+	obj.emplace("bytessent", _bytesSent);
+	obj.emplace("recv_per_msg", totalsToSObj(_recv, true, "parse_us"));
+	obj.emplace("sent_per_msg", totalsToSObj(_sent, false, nullptr));
+
+	SObj applied;
+	for (const auto& i : _applied)
+	{
+		applied.emplace(i.first, i.second.micros);
+	}
+	obj.emplace("apply_us_per_msg", std::move(applied));
+
+	return obj;
+}
+
+MsgStats::MsgStats()
+: _bytesIn(TelemetryManager::counter(TelemetryManager::labeled("p2p/bytes", {{"direction", "in"}})))
+, _bytesOut(TelemetryManager::counter(TelemetryManager::labeled("p2p/bytes", {{"direction", "out"}})))
+{
+}
+
+MsgStats::Command& MsgStats::command(const std::string& name)
+{
+	thread_local std::unordered_map<std::string, Command*> cache;
+
+	auto i = cache.find(name);
+	if (i != cache.end())
+	{
+		return *i->second;
+	}
+
+	std::lock_guard<std::mutex> lockGuard(_mutex);
+
+	auto& command = _commands[name];
+	if (!command)
+	{
+		command = std::make_unique<Command>();
+		command->messagesIn = TelemetryManager::counter(
+			TelemetryManager::labeled("p2p/command/messages", {{"command", name}, {"direction", "in"}}));
+		command->messagesOut = TelemetryManager::counter(
+			TelemetryManager::labeled("p2p/command/messages", {{"command", name}, {"direction", "out"}}));
+		command->bytesIn = TelemetryManager::counter(
+			TelemetryManager::labeled("p2p/command/bytes", {{"command", name}, {"direction", "in"}}));
+		command->bytesOut = TelemetryManager::counter(
+			TelemetryManager::labeled("p2p/command/bytes", {{"command", name}, {"direction", "out"}}));
+		command->parseTime = TelemetryManager::histogram(
+			TelemetryManager::labeled("p2p/command/parse_time_us", {{"command", name}}));
+		command->applyTime = TelemetryManager::histogram(
+			TelemetryManager::labeled("p2p/command/apply_time_us", {{"command", name}}));
+	}
+
+	cache.emplace(name, command.get());
+
+	return *command;
+}
+
+void MsgStats::recv(const std::string& command, size_t bytes, uint64_t parseMicros, PeerStats* peer)
+{
+	auto& instance = getInstance();
+	auto& metrics = instance.command(command);
+
+	metrics.messagesIn->add();
+	metrics.bytesIn->add(bytes);
+	metrics.parseTime->record(parseMicros);
+	instance._bytesIn->add(bytes);
+
+	if (peer)
+	{
+		peer->recv(command, bytes, parseMicros);
+	}
+}
+
+void MsgStats::sent(const std::string& command, size_t bytes, PeerStats* peer)
+{
+	auto& instance = getInstance();
+	auto& metrics = instance.command(command);
+
+	metrics.messagesOut->add();
+	metrics.bytesOut->add(bytes);
+	instance._bytesOut->add(bytes);
+
+	if (peer)
+	{
+		peer->sent(command, bytes);
+	}
+}
+
+void MsgStats::applied(const std::string& command, uint64_t micros, PeerStats* peer)
+{
+	auto& instance = getInstance();
+
+	instance.command(command).applyTime->record(micros);
+
+	if (peer)
+	{
+		peer->applied(command, micros);
+	}
+}
+
+SVal MsgStats::totals()
+{
+	auto& instance = getInstance();
+
+	SObj obj;
+	obj.emplace("totalbytesrecv", instance._bytesIn->value());
+	obj.emplace("totalbytessent", instance._bytesOut->value());
+	obj.emplace(
+		"timemillis",
+		static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::system_clock::now().time_since_epoch()
+		).count())
+	);
+
+	SObj commands;
+	{
+		std::lock_guard<std::mutex> lockGuard(instance._mutex);
+
+		for (const auto& i : instance._commands)
+		{
+			const auto& metrics = *i.second;
+
+			SObj item;
+			item.emplace("recv_count", metrics.messagesIn->value());
+			item.emplace("recv_bytes", metrics.bytesIn->value());
+			item.emplace("sent_count", metrics.messagesOut->value());
+			item.emplace("sent_bytes", metrics.bytesOut->value());
+			item.emplace("parse_us_p50", metrics.parseTime->p50());
+			item.emplace("parse_us_p99", metrics.parseTime->p99());
+			item.emplace("apply_us_p50", metrics.applyTime->p50());
+			item.emplace("apply_us_p99", metrics.applyTime->p99());
+			item.emplace("apply_us_sum", metrics.applyTime->sum());
+
+			commands.emplace(i.first, std::move(item));
+		}
+	}
+	obj.emplace("messages", std::move(commands));
+
+	return obj;
+}
@@ -0,0 +1,130 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// MsgStats.hpp
+
+#pragma once
+
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <serialization/SVal.hpp>
+#include <telemetry/Counter.hpp>
+#include <telemetry/Histogram.hpp>
+
+/// Network and processing statistics of one peer, broken down by command
+class PeerStats final
+{
+public:
+	struct Totals
+	{
+		uint64_t messages = 0;
+		uint64_t bytes = 0;
+		uint64_t micros = 0; // parse time for received, apply time is kept apart
+	};
+
+private:
+	mutable std::mutex _mutex;
+
+	std::chrono::system_clock::time_point _connectTime;
+	std::chrono::system_clock::time_point _lastRecv;
+	std::chrono::system_clock::time_point _lastSend;
+
+	uint64_t _bytesRecv;
+	uint64_t _bytesSent;
+
+	std::map<std::string, Totals> _recv;
+	std::map<std::string, Totals> _sent;
+	std::map<std::string, Totals> _applied;
+
+public:
+	PeerStats(const PeerStats&) = delete; // Copy-constructor
+	PeerStats& operator=(const PeerStats&) = delete; // Copy-assignment
+	PeerStats(PeerStats&&) noexcept = delete; // Move-constructor
+	PeerStats& operator=(PeerStats&&) noexcept = delete; // Move-assignment
+
+	PeerStats(); // Default-constructor
+	~PeerStats() = default; // Destructor
+
+	void recv(const std::string& command, size_t bytes, uint64_t parseMicros);
+	void sent(const std::string& command, size_t bytes);
+	void applied(const std::string& command, uint64_t micros);
+
+	uint64_t bytesRecv() const;
+	uint64_t bytesSent() const;
+
+	/// Fields of getpeerinfo-like report
+	SVal toSVal() const;
+};
+
+/// Process-wide statistics by command, published through TelemetryManager
+/// with 'command' and 'direction' labels, and mirrored into peer statistics
+class MsgStats final
+{
+public:
+	MsgStats(const MsgStats&) = delete; // Copy-constructor
+	MsgStats& operator=(const MsgStats&) = delete; // Copy-assignment
+	MsgStats(MsgStats&&) noexcept = delete; // Move-constructor
+	MsgStats& operator=(MsgStats&&) noexcept = delete; // Move-assignment
+
+private:
+	MsgStats(); // Default-constructor
+	~MsgStats() = default; // Destructor
+
+	static MsgStats& getInstance()
+	{
+		static MsgStats instance;
+		return instance;
+	}
+
+	struct Command
+	{
+		std::shared_ptr<Counter> messagesIn;
+		std::shared_ptr<Counter> messagesOut;
+		std::shared_ptr<Counter> bytesIn;
+		std::shared_ptr<Counter> bytesOut;
+		std::shared_ptr<Histogram> parseTime;
+		std::shared_ptr<Histogram> applyTime;
+	};
+
+	std::mutex _mutex;
+	std::map<std::string, std::unique_ptr<Command>> _commands;
+
+	std::shared_ptr<Counter> _bytesIn;
+	std::shared_ptr<Counter> _bytesOut;
+
+	/// Metrics of command; found in thread cache, so registry isn't locked per message
+	Command& command(const std::string& name);
+
+public:
+	static void recv(const std::string& command, size_t bytes, uint64_t parseMicros, PeerStats* peer);
+	static void sent(const std::string& command, size_t bytes, PeerStats* peer);
+	static void applied(const std::string& command, uint64_t micros, PeerStats* peer);
+
+	/// getnettotals-like report
+	static SVal totals();
+};
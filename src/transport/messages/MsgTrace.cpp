@@ -0,0 +1,89 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// MsgTrace.cpp
+
+#include "MsgTrace.hpp"
+#include <serialization/JsonSerializer.hpp>
+#include <sstream>
+
+MsgTrace::MsgTrace()
+: _summary("Messages")
+, _dump("MessagesDump")
+, _counter(0)
+, _sampleRate(10)
+{
+}
+
+void MsgTrace::recv(const std::string& command, const Serializable& msg, size_t length, const std::string& where)
+{
+	getInstance().write("Recv", command, msg, length, where);
+}
+
+void MsgTrace::send(const std::string& command, const Serializable& msg, size_t length, const std::string& where)
+{
+	getInstance().write("Send", command, msg, length, where);
+}
+
+void MsgTrace::setSampleRate(uint32_t everyNth)
+{
+	getInstance()._sampleRate.store(everyNth, std::memory_order_relaxed);
+}
+
+void MsgTrace::write(const char* direction, const std::string& command, const Serializable& msg, size_t length, const std::string& where)
+{
+	_summary.lazy(
+		Log::Detail::INFO,
+		[&]
+		{
+			std::string line(direction);
+			line += " message '" + command + "' (" + std::to_string(length) + " bytes)";
+			if (!where.empty())
+			{
+				line += (*direction == 'R' ? " from " : " to ") + where;
+			}
+			return line;
+		}
+	);
+
+	if (!_dump.isEnabled(Log::Detail::TRACE))
+	{
+		return;
+	}
+
+	auto rate = _sampleRate.load(std::memory_order_relaxed);
+	if (rate == 0 || _counter.fetch_add(1, std::memory_order_relaxed) % rate != 0)
+	{
+		return;
+	}
+
+	_dump.lazy(
+		Log::Detail::TRACE,
+		[&]
+		{
+			std::ostringstream oss;
+			SerializerFactory::create("json", JsonSerializer::PRETTY | JsonSerializer::INDENT)->encode(oss, msg.toSVal());
+			return std::string(direction) + " message '" + command + "'\n" + oss.str();
+		}
+	);
+}
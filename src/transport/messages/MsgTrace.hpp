@@ -0,0 +1,72 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// MsgTrace.hpp
+
+#pragma once
+
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <log/Log.hpp>
+#include <serialization/Serialization.hpp>
+
+/// Logging of protocol messages.
+/// At info level ('Messages' logger) only a compact summary line is written.
+/// The full JSON dump is written by the 'MessagesDump' logger, only when it
+/// is explicitly configured for trace level, and only for every Nth message.
+/// Nothing is formatted unless the record is going to be emitted.
+class MsgTrace final
+{
+public:
+	MsgTrace(const MsgTrace&) = delete; // Copy-constructor
+	MsgTrace& operator=(const MsgTrace&) = delete; // Copy-assignment
+	MsgTrace(MsgTrace&&) noexcept = delete; // Move-constructor
+	MsgTrace& operator=(MsgTrace&&) noexcept = delete; // Move-assignment
+
+private:
+	MsgTrace(); // Default-constructor
+	~MsgTrace() = default; // Destructor
+
+	static MsgTrace& getInstance()
+	{
+		static MsgTrace instance;
+		return instance;
+	}
+
+	Log _summary;
+	Log _dump;
+
+	std::atomic_uint64_t _counter;
+	std::atomic_uint32_t _sampleRate;
+
+	void write(const char* direction, const std::string& command, const Serializable& msg, size_t length, const std::string& where);
+
+public:
+	static void recv(const std::string& command, const Serializable& msg, size_t length, const std::string& where = "");
+	static void send(const std::string& command, const Serializable& msg, size_t length, const std::string& where = "");
+
+	/// Dump every Nth message (0 - disable dumps)
+	static void setSampleRate(uint32_t everyNth);
+};
@@ -0,0 +1,79 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// WireCache.cpp
+
+#include "WireCache.hpp"
+
+WireCache::WireCache()
+: _mutex("WireCache")
+, _bytes(0)
+{
+}
+
+std::shared_ptr<const WireMessage> WireCache::get(const protocol::InventoryVector& item, const Builder& builder)
+{
+	auto& cache = getInstance();
+
+	{
+		std::lock_guard<NamedMutex> lockGuard(cache._mutex);
+
+		auto i = cache._images.find(Key(item.type(), item.hash()));
+		if (i != cache._images.end())
+		{
+			return i->second;
+		}
+	}
+
+	// Built out of lock; concurrent misses of the same object just build it twice
+	auto wire = builder();
+	if (wire)
+	{
+		put(item, wire);
+	}
+	return wire;
+}
+
+void WireCache::put(const protocol::InventoryVector& item, const std::shared_ptr<const WireMessage>& wire)
+{
+	auto& cache = getInstance();
+
+	std::lock_guard<NamedMutex> lockGuard(cache._mutex);
+
+	Key key(item.type(), item.hash());
+
+	if (!cache._images.emplace(key, wire).second)
+	{
+		return;
+	}
+	cache._order.push_back(std::move(key));
+	cache._bytes += wire->size();
+
+	while (cache._order.size() > MAX_ENTRIES || (cache._bytes > MAX_BYTES && cache._order.size() > 1))
+	{
+		auto i = cache._images.find(cache._order.front());
+		cache._bytes -= i->second->size();
+		cache._images.erase(i);
+		cache._order.pop_front();
+	}
+}
@@ -0,0 +1,77 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// WireCache.hpp
+
+#pragma once
+
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <thread/NamedMutex.hpp>
+#include <protocol/types/InventoryVector.hpp>
+#include "WireMessage.hpp"
+
+/// Wire images of blocks and transactions served to peers.
+/// An object announced to all peers is then requested by many of them; it is
+/// serialized once and every reply queues the same image. Entries are evicted
+/// in order of insertion when count or total size exceeds the limit.
+class WireCache final
+{
+public:
+	static constexpr size_t MAX_ENTRIES = 256;
+	static constexpr size_t MAX_BYTES = 64 * 1024 * 1024;
+
+	WireCache(const WireCache&) = delete; // Copy-constructor
+	WireCache& operator=(const WireCache&) = delete; // Copy-assignment
+	WireCache(WireCache&&) noexcept = delete; // Move-constructor
+	WireCache& operator=(WireCache&&) noexcept = delete; // Move-assignment
+
+private:
+	WireCache(); // Default-constructor
+	~WireCache() = default; // Destructor
+
+	static WireCache& getInstance()
+	{
+		static WireCache instance;
+		return instance;
+	}
+
+	using Key = std::pair<protocol::InventoryVector::Type, uint256>;
+
+	NamedMutex _mutex;
+	std::map<Key, std::shared_ptr<const WireMessage>> _images;
+	std::deque<Key> _order;
+	size_t _bytes;
+
+public:
+	using Builder = std::function<std::shared_ptr<const WireMessage>()>;
+
+	/// Image of object; on miss it is made by builder, which returns nullptr for unknown object
+	static std::shared_ptr<const WireMessage> get(const protocol::InventoryVector& item, const Builder& builder);
+
+	/// Put prebuilt image
+	static void put(const protocol::InventoryVector& item, const std::shared_ptr<const WireMessage>& wire);
+};
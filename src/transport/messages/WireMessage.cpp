@@ -0,0 +1,191 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// WireMessage.cpp
+
+#include "WireMessage.hpp"
+#include <net/WriterConnection.hpp>
+#include <crypto/sha256.h>
+#include <sstream>
+
+namespace
+{
+
+/// Stream buffer writing directly into chain of pooled slabs
+class SlabStreamBuffer final : public std::streambuf
+{
+private:
+	std::vector<WireMessage::Segment>& _segments;
+
+	void flushSegment()
+	{
+		if (!_segments.empty())
+		{
+			auto& segment = _segments.back();
+			segment.length = static_cast<size_t>(pptr() - segment.data);
+		}
+	}
+
+	void nextSlab()
+	{
+		flushSegment();
+		auto slab = SlabPtr::make();
+		setp(slab->data(), slab->data() + Slab::capacity);
+		auto data = slab->data();
+		_segments.push_back({std::move(slab), nullptr, data, 0});
+	}
+
+public:
+	SlabStreamBuffer(std::vector<WireMessage::Segment>& segments, size_t headroom)
+	: _segments(segments)
+	{
+		nextSlab();
+		pbump(static_cast<int>(headroom));
+	}
+
+	void finish()
+	{
+		flushSegment();
+	}
+
+protected:
+	int overflow(int c) override
+	{
+		if (c == traits_type::eof())
+		{
+			return traits_type::eof();
+		}
+		nextSlab();
+		*pptr() = static_cast<char_type>(c);
+		pbump(1);
+		return c;
+	}
+
+	std::streamsize xsputn(const char_type* data, std::streamsize size) override
+	{
+		auto remain = static_cast<size_t>(size);
+		while (remain > 0)
+		{
+			if (pptr() == epptr())
+			{
+				nextSlab();
+			}
+			auto n = std::min(remain, static_cast<size_t>(epptr() - pptr()));
+			memcpy(pptr(), data, n);
+			pbump(static_cast<int>(n));
+			data += n;
+			remain -= n;
+		}
+		return size;
+	}
+};
+
+}
+
+std::shared_ptr<const WireMessage> WireMessage::build(const protocol::Message& msg)
+{
+	constexpr size_t headroom = protocol::MessageHeader::HEADER_SIZE;
+
+	std::vector<Segment> segments;
+	{
+		SlabStreamBuffer buffer(segments, headroom);
+		std::ostream os(&buffer);
+		msg.Serialize(os);
+		os.flush();
+		buffer.finish();
+	}
+
+	size_t length = 0;
+	for (const auto& segment : segments)
+	{
+		length += segment.length;
+	}
+	length -= headroom;
+
+	// Checksum by serialized payload (first 4 bytes of sha256(sha256(payload)))
+	uint32_t checksum;
+	{
+		CSHA256 hasher;
+		for (size_t i = 0; i < segments.size(); ++i)
+		{
+			auto offset = i == 0 ? headroom : 0;
+			hasher.Write(reinterpret_cast<const uint8_t*>(segments[i].data + offset), segments[i].length - offset);
+		}
+		uint8_t hash[CSHA256::OUTPUT_SIZE];
+		hasher.Finalize(hash);
+		hasher.Reset().Write(hash, sizeof(hash)).Finalize(hash);
+		memcpy(&checksum, hash, sizeof(checksum));
+		checksum = le32toh(checksum);
+	}
+
+	// Header into reserved headroom
+	protocol::MessageHeader header(static_cast<uint32_t>(protocol::Magic::main), msg.command(), length, checksum);
+	{
+		std::ostringstream oss;
+		header.Serialize(oss);
+		auto bytes = oss.str();
+		if (bytes.size() != headroom)
+		{
+			throw std::runtime_error("Unexpected size of message header");
+		}
+		memcpy(segments.front().slab->data(), bytes.data(), headroom);
+	}
+
+	// Small tail is moved out of slab into right-sized memory, slab goes back to pool
+	{
+		auto& tail = segments.back();
+		if (tail.length <= SMALL_SEGMENT)
+		{
+			auto holder = std::shared_ptr<char>(new char[tail.length], std::default_delete<char[]>());
+			memcpy(holder.get(), tail.data, tail.length);
+			tail.data = holder.get();
+			tail.holder = std::move(holder);
+			tail.slab.reset();
+		}
+	}
+
+	return std::shared_ptr<const WireMessage>(new WireMessage(msg.command(), std::move(segments), headroom + length));
+}
+
+void WireMessage::appendTo(WriterConnection& connection) const
+{
+	// Segments of one message must not interleave with other messages
+	std::lock_guard<NamedRecursiveMutex> guard(connection.outMutex());
+
+	for (const auto& segment : _segments)
+	{
+		if (segment.length <= SMALL_SEGMENT)
+		{
+			// Copying is cheaper than a segment of its own, and small frames share tail slab of connection
+			connection.write(segment.data, segment.length);
+		}
+		else if (segment.slab)
+		{
+			connection.append(segment.slab, segment.data, segment.length);
+		}
+		else
+		{
+			connection.append(segment.holder, segment.data, segment.length);
+		}
+	}
+}
@@ -0,0 +1,103 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+
+// WireMessage.hpp
+
+#pragma once
+
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <utils/Slab.hpp>
+#include <protocol/types/Message.hpp>
+
+class WriterConnection;
+
+/// Immutable wire image of a message (header and payload bytes).
+/// The payload is serialized once into pooled slabs, the first of which reserves
+/// headroom for the header; the checksum is computed over the serialized bytes
+/// and the header is written into the headroom afterwards.
+/// The image is then queued to any number of connections without copying:
+/// each connection output buffer only holds references to the slabs.
+/// Small tail of the image is kept in right-sized memory instead of a slab, and
+/// small segments are copied into the tail slab of connection output buffer, so
+/// frequent small messages don't pin a whole slab each.
+class WireMessage final
+{
+public:
+	/// Segments up to this size are not kept in slabs of their own
+	static constexpr size_t SMALL_SEGMENT = Slab::capacity / 4;
+
+	struct Segment
+	{
+		SlabPtr slab;                       // Pooled slab (if data is in it)
+		std::shared_ptr<const void> holder; // Right-sized owner of data (if data is not in slab)
+		const char* data;
+		size_t length;
+	};
+
+private:
+	std::string _command;
+	std::vector<Segment> _segments;
+	size_t _size;
+
+	WireMessage(std::string command, std::vector<Segment> segments, size_t size)
+	: _command(std::move(command))
+	, _segments(std::move(segments))
+	, _size(size)
+	{}
+
+public:
+	WireMessage() = delete; // Default-constructor
+	WireMessage(WireMessage&&) noexcept = delete; // Move-constructor
+	WireMessage(const WireMessage&) = delete; // Copy-constructor
+	~WireMessage() = default; // Destructor
+	WireMessage& operator=(WireMessage&&) noexcept = delete; // Move-assignment
+	WireMessage& operator=(WireMessage const&) = delete; // Copy-assignment
+
+	[[nodiscard]]
+	static std::shared_ptr<const WireMessage> build(const protocol::Message& msg);
+
+	[[nodiscard]]
+	const std::string& command() const
+	{
+		return _command;
+	}
+
+	/// Full size (header and payload)
+	[[nodiscard]]
+	size_t size() const
+	{
+		return _size;
+	}
+
+	[[nodiscard]]
+	const std::vector<Segment>& segments() const
+	{
+		return _segments;
+	}
+
+	/// Queue image into output buffer of connection (by reference, without copying)
+	void appendTo(WriterConnection& connection) const;
+};
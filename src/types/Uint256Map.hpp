@@ -0,0 +1,393 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// Uint256Map.hpp
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "Blobs.hpp"
+#include "../other/SipHash.hpp"
+
+// Per-process random key of SipHash for Uint256Map
+const std::pair<uint64_t, uint64_t>& Uint256MapSalt();
+
+// Flat open-addressing hash map with uint256 keys.
+//
+// Keys are hashed by SipHash salted per process, so remote peers can't grind colliding hashes.
+// All entries live in one array (no allocation per entry). One control byte per slot keeps
+// 7 bits of hash, so probing compares group of 16 slots at once and reads keys only on match.
+// Linear probing with backward-shift deletion needs no tombstones.
+template<class Value>
+class Uint256Map final
+{
+public:
+	using key_type = uint256;
+	using mapped_type = Value;
+	using value_type = std::pair<uint256, Value>;
+
+private:
+	static constexpr size_t GROUP = 16;
+	static constexpr uint8_t EMPTY = 0x80;
+	static constexpr size_t npos = -1;
+
+	std::unique_ptr<uint8_t[]> _ctrl; // capacity + GROUP - 1 bytes; tail mirrors head for wrap-around group loads
+	std::unique_ptr<value_type[]> _slots;
+	size_t _capacity = 0; // power of two, or zero until first insert
+	size_t _size = 0;
+	uint64_t _k0;
+	uint64_t _k1;
+
+	template<bool Const>
+	class Iterator final
+	{
+		using Map = std::conditional_t<Const, const Uint256Map, Uint256Map>;
+
+		Map* _map;
+		size_t _index;
+
+		friend class Uint256Map;
+
+		Iterator(Map* map, size_t index)
+		: _map(map)
+		, _index(index)
+		{
+		}
+
+		void skipEmpty()
+		{
+			while (_index < _map->_capacity && _map->_ctrl[_index] == EMPTY) ++_index;
+		}
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Uint256Map::value_type;
+		using difference_type = std::ptrdiff_t;
+		using reference = std::conditional_t<Const, const value_type&, value_type&>;
+		using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+		reference operator*() const
+		{
+			return _map->_slots[_index];
+		}
+
+		pointer operator->() const
+		{
+			return &_map->_slots[_index];
+		}
+
+		Iterator& operator++()
+		{
+			++_index;
+			skipEmpty();
+			return *this;
+		}
+
+		bool operator==(const Iterator& that) const
+		{
+			return _index == that._index;
+		}
+
+		bool operator!=(const Iterator& that) const
+		{
+			return _index != that._index;
+		}
+	};
+
+public:
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	Uint256Map() // Default-constructor
+	: _k0(Uint256MapSalt().first)
+	, _k1(Uint256MapSalt().second)
+	{
+	}
+	Uint256Map(Uint256Map&&) noexcept = default; // Move-constructor
+	Uint256Map(const Uint256Map&) = delete; // Copy-constructor
+	~Uint256Map() = default; // Destructor
+	Uint256Map& operator=(Uint256Map&&) noexcept = default; // Move-assignment
+	Uint256Map& operator=(Uint256Map const&) = delete; // Copy-assignment
+
+	[[nodiscard]]
+	size_t size() const
+	{
+		return _size;
+	}
+
+	[[nodiscard]]
+	bool empty() const
+	{
+		return _size == 0;
+	}
+
+	iterator begin()
+	{
+		iterator i(this, 0);
+		i.skipEmpty();
+		return i;
+	}
+
+	iterator end()
+	{
+		return iterator(this, _capacity);
+	}
+
+	const_iterator begin() const
+	{
+		const_iterator i(this, 0);
+		i.skipEmpty();
+		return i;
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(this, _capacity);
+	}
+
+	iterator find(const uint256& key)
+	{
+		auto index = lookup(key, hashOf(key));
+		return index == npos ? end() : iterator(this, index);
+	}
+
+	const_iterator find(const uint256& key) const
+	{
+		auto index = lookup(key, hashOf(key));
+		return index == npos ? end() : const_iterator(this, index);
+	}
+
+	[[nodiscard]]
+	size_t count(const uint256& key) const
+	{
+		return lookup(key, hashOf(key)) == npos ? 0 : 1;
+	}
+
+	// Inserts if key is absent; doesn't replace value of existing key
+	template<class... Args>
+	std::pair<iterator, bool> emplace(const uint256& key, Args&&... args)
+	{
+		auto hash = hashOf(key);
+		auto index = lookup(key, hash);
+		if (index != npos)
+		{
+			return {iterator(this, index), false};
+		}
+		index = insert(key, hash);
+		_slots[index].second = Value(std::forward<Args>(args)...);
+		return {iterator(this, index), true};
+	}
+
+	Value& operator[](const uint256& key)
+	{
+		auto hash = hashOf(key);
+		auto index = lookup(key, hash);
+		if (index == npos)
+		{
+			index = insert(key, hash);
+		}
+		return _slots[index].second;
+	}
+
+	size_t erase(const uint256& key)
+	{
+		auto index = lookup(key, hashOf(key));
+		if (index == npos)
+		{
+			return 0;
+		}
+		eraseAt(index);
+		return 1;
+	}
+
+	// Prepares place for count entries without rehashing
+	void reserve(size_t count)
+	{
+		size_t capacity = GROUP;
+		while (capacity * 7 < count * 8) capacity *= 2;
+		if (capacity > _capacity)
+		{
+			rehash(capacity);
+		}
+	}
+
+	void clear()
+	{
+		_ctrl.reset();
+		_slots.reset();
+		_capacity = 0;
+		_size = 0;
+	}
+
+private:
+	[[nodiscard]]
+	uint64_t hashOf(const uint256& key) const
+	{
+		return SipHashUint256(_k0, _k1, key);
+	}
+
+	[[nodiscard]]
+	size_t homeOf(uint64_t hash) const
+	{
+		return (hash >> 7) & (_capacity - 1);
+	}
+
+	static uint8_t tagOf(uint64_t hash)
+	{
+		return hash & 0x7f;
+	}
+
+	// Bitmask of slots of group at pos whose control byte equals value
+	[[nodiscard]]
+	uint32_t match(size_t pos, uint8_t value) const
+	{
+#ifdef __SSE2__
+		auto group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&_ctrl[pos]));
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(value))));
+#else
+		uint32_t mask = 0;
+		for (size_t i = 0; i < GROUP; ++i)
+		{
+			mask |= static_cast<uint32_t>(_ctrl[pos + i] == value) << i;
+		}
+		return mask;
+#endif
+	}
+
+	void setCtrl(size_t index, uint8_t value)
+	{
+		_ctrl[index] = value;
+		if (index < GROUP - 1)
+		{
+			_ctrl[_capacity + index] = value;
+		}
+	}
+
+	[[nodiscard]]
+	size_t lookup(const uint256& key, uint64_t hash) const
+	{
+		if (_size == 0)
+		{
+			return npos;
+		}
+		auto tag = tagOf(hash);
+		for (auto pos = homeOf(hash);; pos = (pos + GROUP) & (_capacity - 1))
+		{
+			auto found = match(pos, tag);
+			auto empty = match(pos, EMPTY);
+			if (empty)
+			{
+				// Chain of key is contiguous from its home, so it ends before first empty slot
+				found &= (empty & -empty) - 1;
+			}
+			while (found)
+			{
+				auto index = (pos + __builtin_ctz(found)) & (_capacity - 1);
+				if (_slots[index].first == key)
+				{
+					return index;
+				}
+				found &= found - 1;
+			}
+			if (empty)
+			{
+				return npos;
+			}
+		}
+	}
+
+	[[nodiscard]]
+	size_t findEmpty(uint64_t hash) const
+	{
+		for (auto pos = homeOf(hash);; pos = (pos + GROUP) & (_capacity - 1))
+		{
+			if (auto empty = match(pos, EMPTY))
+			{
+				return (pos + __builtin_ctz(empty)) & (_capacity - 1);
+			}
+		}
+	}
+
+	size_t insert(const uint256& key, uint64_t hash)
+	{
+		// Keep load factor at most 7/8, so probing always meets empty slot soon
+		if ((_size + 1) * 8 > _capacity * 7)
+		{
+			rehash(std::max(GROUP, _capacity * 2));
+		}
+		auto index = findEmpty(hash);
+		setCtrl(index, tagOf(hash));
+		_slots[index].first = key;
+		++_size;
+		return index;
+	}
+
+	void eraseAt(size_t hole)
+	{
+		// Shift back following entries of probe chain, instead of marking hole by tombstone
+		for (auto index = (hole + 1) & (_capacity - 1); _ctrl[index] != EMPTY; index = (index + 1) & (_capacity - 1))
+		{
+			auto home = homeOf(hashOf(_slots[index].first));
+			// Entry can fill hole only if its home isn't in (hole, index] cyclically
+			if (((index - home) & (_capacity - 1)) >= ((index - hole) & (_capacity - 1)))
+			{
+				_slots[hole] = std::move(_slots[index]);
+				setCtrl(hole, _ctrl[index]);
+				hole = index;
+			}
+		}
+		_slots[hole] = value_type();
+		setCtrl(hole, EMPTY);
+		--_size;
+	}
+
+	void rehash(size_t capacity)
+	{
+		auto ctrl = std::move(_ctrl);
+		auto slots = std::move(_slots);
+		auto oldCapacity = _capacity;
+
+		_capacity = capacity;
+		_ctrl = std::make_unique<uint8_t[]>(_capacity + GROUP - 1);
+		std::fill_n(_ctrl.get(), _capacity + GROUP - 1, EMPTY);
+		_slots = std::make_unique<value_type[]>(_capacity);
+
+		for (size_t i = 0; i < oldCapacity; ++i)
+		{
+			if (ctrl[i] != EMPTY)
+			{
+				auto hash = hashOf(slots[i].first);
+				auto index = findEmpty(hash);
+				setCtrl(index, tagOf(hash));
+				_slots[index] = std::move(slots[i]);
+			}
+		}
+	}
+};
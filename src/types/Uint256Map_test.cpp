@@ -0,0 +1,106 @@
+//  Copyright (c) 2017-2020 TKEY DMCC LLC & Tkeycoin Dao. All rights reserved.
+//  Website: www.tkeycoin.com
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+
+
+// Uint256Map_test.cpp
+
+#include "Uint256Map.hpp"
+
+#include <random>
+#include <unordered_map>
+#include <gtest/gtest.h>
+
+namespace
+{
+	uint256 key(uint64_t n)
+	{
+		uint256 key;
+		for (size_t i = 0; i < 8; ++i)
+		{
+			key[i] = static_cast<uint8_t>(n >> (8 * i));
+		}
+		return key;
+	}
+}
+
+TEST(Uint256Map, Basic)
+{
+	Uint256Map<size_t> map;
+	EXPECT_TRUE(map.empty());
+	EXPECT_EQ(map.find(key(1)), map.end());
+	EXPECT_EQ(map.erase(key(1)), 0);
+
+	EXPECT_TRUE(map.emplace(key(1), 10).second);
+	EXPECT_FALSE(map.emplace(key(1), 20).second);
+	EXPECT_EQ(map.find(key(1))->second, 10);
+	EXPECT_EQ(map.size(), 1);
+
+	map[key(2)] = 30;
+	EXPECT_EQ(map.count(key(2)), 1);
+	EXPECT_EQ(map.erase(key(1)), 1);
+	EXPECT_EQ(map.count(key(1)), 0);
+	EXPECT_EQ(map.size(), 1);
+
+	Uint256Map<std::vector<size_t>> multi;
+	multi[key(3)].push_back(1);
+	multi[key(3)].push_back(2);
+	EXPECT_EQ(multi.find(key(3))->second.size(), 2);
+}
+
+TEST(Uint256Map, AgainstUnorderedMap)
+{
+	Uint256Map<uint64_t> map;
+	std::unordered_map<uint256, uint64_t> reference;
+
+	std::mt19937_64 random(1);
+	for (size_t step = 0; step < 200000; ++step)
+	{
+		auto k = key(random() % 5000);
+		auto op = random() % 3;
+		if (op == 0)
+		{
+			EXPECT_EQ(map.emplace(k, step).second, reference.emplace(k, step).second);
+		}
+		else if (op == 1)
+		{
+			EXPECT_EQ(map.erase(k), reference.erase(k));
+		}
+		else
+		{
+			auto i = map.find(k);
+			auto j = reference.find(k);
+			ASSERT_EQ(i == map.end(), j == reference.end());
+			if (j != reference.end())
+			{
+				EXPECT_EQ(i->second, j->second);
+			}
+		}
+		ASSERT_EQ(map.size(), reference.size());
+	}
+
+	size_t count = 0;
+	for (auto& [k, v] : map)
+	{
+		EXPECT_EQ(reference.at(k), v);
+		++count;
+	}
+	EXPECT_EQ(count, reference.size());
+}